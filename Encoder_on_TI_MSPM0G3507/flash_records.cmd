@@ -0,0 +1,16 @@
+/*
+ * 项目自带的链接脚本片段，与SysConfig生成的Debug/device_linker.cmd一同传给链接器
+ * （device_linker.cmd每次构建都会重新生成，不要在其中修改）
+ *
+ * 主Flash末尾3KB在运行时擦写，不能放代码和常量：
+ *   0x0001F400~0x0001FBFF  用户波形槽位，每个槽位1KB（WAVE_FLASH_ADDRESS）
+ *   0x0001FC00~0x0001FFFF  校准数据（CAL_FLASH_ADDRESS）
+ * 以NOLOAD段占住这段地址：链接器不会再向其中分配其他段，烧录映像也不包含它，重新烧录不会冲掉已保存的数据
+ */
+SECTIONS
+{
+    .flash_records : > 0x0001F400, type = NOLOAD
+    {
+        . += 0x00000C00;
+    }
+}
@@ -3,7 +3,19 @@
 #include "user/user_uart.h"
 #include "user/firewater_protocol.h"
 #include "user/user_ADC.h"
+#include "user/user_adc_alarm.h"
+#include "user/user_filter.h"
+#include "user/user_scope.h"
+#include "user/user_spectrum.h"
 #include "user/user_DAC.h"
+#include "user/user_calibration.h"
+#include "user/user_waveform.h"
+#include "user/user_timestamp.h"
+#include "user/user_power.h"
+#include "user/user_drift.h"
+#include "user/user_ramp.h"
+#include "user/user_regulator.h"
+#include "user/user_command.h"
 #include "user/user_OLED.h"
 #include "user/user_Encoder.h"
 #include <stdio.h>
@@ -11,12 +23,33 @@
 // 全局时间计数器（毫秒）
 volatile uint32_t system_time_ms = 0;
 
+#define ADC_DISPLAY_AVERAGE     4       // 显示用ADC读数的平均次数
+#define ADC_UPDATE_INTERVAL_US  50000   // 显示用ADC读数的标称间隔
+#define ADC_JITTER_BIN_US       500     // 间隔直方图每格宽度（覆盖±4ms）
+
+// 50ms ADC读数的调度间隔直方图（串口命令"jitter"报告）
+static jitter_histogram_t g_adc_loop_jitter;
+
+/**
+ * @brief 异步ADC读数完成回调：保存毫伏值并发送到VOFA+
+ * @param context 指向主循环中的毫伏值变量
+ */
+static void adc_display_callback(int8_t handle, uint16_t raw_value, void *context)
+{
+    uint16_t *millivolts = (uint16_t *)context;
+
+    (void)handle;
+    *millivolts = user_adc_raw_to_millivolts(raw_value);
+    firewater_send_adc_millivolts(*millivolts);
+}
+
 int main(void)
 {
     char msg[100];
     
     // 系统初始化
     SYSCFG_DL_init();
+    user_timestamp_init();  // 微秒时间戳定时器，供采样打时间戳和抖动统计
     
     // 初始化各个模块
     user_uart_init();
@@ -37,11 +70,21 @@ int main(void)
     user_uart_send_string("OLED initialized\r\n");
     
     user_adc_init();
+    user_filter_init();  // 高速采样滤波级，默认直通
     user_uart_send_string("ADC initialized\r\n");
     
     DAC_init();
     user_uart_send_string("DAC initialized\r\n");
     
+    // 加载Flash中的ADC/DAC校准系数（无需重新扫描）
+    user_cal_init();
+    
+    // 加载Flash中的用户波形
+    user_waveform_init();
+    
+    // 设定值斜坡定时器（编码器调节电压时按压摆率过渡）
+    user_ramp_init();
+    
     // 初始化编码器
     user_encoder_init();
     user_uart_send_string("Encoder initialized\r\n");
@@ -61,7 +104,8 @@ int main(void)
     user_uart_send_string(init_msg);
     
     // 主循环：编码器控制DAC，ADC采样和VOFA+显示
-    float voltage;
+    // 采样结果保持为原始码值，仅在显示/发送时换算为毫伏（定点）
+    uint16_t millivolts = 0;
     
     // 非阻塞延时变量 - 独立的更新频率控制
     uint32_t last_encoder_check = 0;
@@ -75,6 +119,9 @@ int main(void)
     uint32_t init_time = get_system_time_ms();
     uint32_t sample_count = 0;
     
+    user_jitter_init(&g_adc_loop_jitter, "adc_loop", ADC_UPDATE_INTERVAL_US, ADC_JITTER_BIN_US);
+    user_jitter_register(&g_adc_loop_jitter);
+    
     while (1) {
         uint32_t current_time = get_system_time_ms();  // 使用时间获取函数
         
@@ -95,23 +142,38 @@ int main(void)
             last_encoder_check = current_time;
         }
         
-        // ADC采样（按时间间隔执行）
-        if (current_time - last_adc_update >= adc_update_interval) {
-            if (user_adc_read_voltage(ADC_CHANNEL_0, &voltage) == ADC_STATUS_OK) {
-                // 发送到VOFA+显示
-                firewater_send_adc_voltage_simple(voltage);
+        // 高速采样/示波器捕获（未启动时直接返回）
+        user_adc_high_speed_process();
+        user_scope_process();
+        user_spectrum_process();
+        user_power_process();
+        user_ramp_process();
+        
+        // ADC采样（按时间间隔提交异步请求，转换期间继续处理OLED等工作；高速采样或功率测量占用ADC时跳过）
+        if (current_time - last_adc_update >= adc_update_interval &&
+            !user_adc_is_sampling() && !user_power_is_running()) {
+            user_jitter_record(&g_adc_loop_jitter, user_timestamp_ticks());
+            if (user_adc_submit(ADC_CHANNEL_0, ADC_DISPLAY_AVERAGE,
+                                adc_display_callback, &millivolts) != ADC_REQUEST_INVALID) {
                 sample_count++;
             }
             last_adc_update = current_time;
         }
+        user_adc_async_process();
+        user_adc_alarm_process();
+        user_drift_process();
+        user_regulator_process();
+        
+        // 串口命令（抖动直方图按需报告等）
+        user_command_process();
         
         // OLED显示更新
         if (current_time - last_oled_update >= oled_update_interval) {
             static uint8_t oled_update_step = 0;  // 轮换更新步骤
             
             // 计算整数和小数部分用于显示
-            uint32_t int_part = (uint32_t)voltage;
-            uint32_t dec_part = (uint32_t)((voltage - int_part) * 1000);
+            uint32_t int_part = millivolts / 1000;
+            uint32_t dec_part = millivolts % 1000;
             
             // 轮换更新不同的数值，减少单次I2C阻塞时间
             switch(oled_update_step) {
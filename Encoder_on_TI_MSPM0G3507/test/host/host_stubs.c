@@ -0,0 +1,56 @@
+/*
+ * 主机测试公共桩函数：串口输出打印到标准输出，延时和计时为空操作
+ */
+#include "ti_msp_dl_config.h"
+#include "user_uart.h"
+#include "delay.h"
+#include "firewater_protocol.h"
+#include <stdio.h>
+
+SysTick_Type host_systick;
+DAC12_Regs host_dac0;
+volatile uint16_t host_dac_output = 0;
+volatile uint32_t host_gpio_pins = 0;
+volatile uint32_t system_time_ms = 0;
+volatile unsigned int delay_times = 0;
+
+uart_status_t user_uart_send_string(const char *str)
+{
+    fputs(str, stdout);
+    return UART_OK;
+}
+
+uint32_t get_elapsed_cycles(uint32_t start, uint32_t end)
+{
+    return start - end;
+}
+
+uint32_t get_system_time_ms(void)
+{
+    return system_time_ms;
+}
+
+void delay_ms(unsigned int ms)
+{
+    system_time_ms += ms;
+}
+
+void delay_us(unsigned int us)
+{
+    (void)us;
+}
+
+void delay_cycles(unsigned int cycles)
+{
+    (void)cycles;
+}
+
+// 包含user_DAC.c的测试中DAC_checkStatus引用的遥测帧，测试不使用
+void firewater_send_dac_health(uint32_t refills, uint32_t underruns, uint32_t late_refills,
+                               uint32_t max_latency_us)
+{
+    (void)refills;
+    (void)underruns;
+    (void)late_refills;
+    (void)max_latency_us;
+}
@@ -0,0 +1,98 @@
+/*
+ * DDS主机测试：正弦播放路径（四分之一周期表展开、相邻表项插值、调谐字）与解析正弦逐点比较
+ * 直接包含user_DAC.c以调用静态的填充函数；外设操作由本目录的ti_msp_dl_config.h替身吸收
+ *
+ * 构建（在test/host目录下）：
+ *   gcc -std=c99 -O2 -I. -I../../user -o test_dac_dds test_dac_dds.c ../../user/user_wave_tables.c host_stubs.c -lm
+ */
+#include "../../user/user_DAC.c"
+#include <math.h>
+#include <stdlib.h>
+
+#define DDS_TEST_SAMPLES        20000
+#define DDS_MAX_ERROR_CODES     2.5     // 播放表取整1 + 插值截断1 + 相位只用高16位0.2 + 插值曲率0.04
+#define DDS_MAX_PHASE_LSB       1.0     // 调谐字舍入引起的累计相位误差（以调谐字LSB x 点数计）
+#define DDS_TWO_PI              6.283185307179586
+
+typedef struct {
+    uint32_t rate_hz;
+    uint32_t frequency_mhz;
+} dds_case_t;
+
+static const dds_case_t g_cases[] = {
+    {8000,   31250},        // 默认：每点步进一格
+    {8000,   1234567},      // 非整除频率
+    {8000,   3999000},      // 接近奈奎斯特频率
+    {16000,  50},           // 极低频，插值起主要作用
+    {44100,  1000000},      // TIMG7触发的非档位速率（实际44077Hz）
+    {200000, 12345678},
+};
+
+/**
+ * @brief 理想码值：与dac_render_play_table相同的偏移/幅度换算，按满量程削顶
+ */
+static double dds_ideal_code(double phase_cycles)
+{
+    double amplitude = (double)(((int32_t)DAC_DEFAULT_AMPLITUDE_MV * DAC_MAX_VALUE + 1650) / 3300);
+    double offset = (double)(((int32_t)DAC_DEFAULT_OFFSET_MV * DAC_MAX_VALUE + 1650) / 3300);
+    double code = offset + amplitude * sin(DDS_TWO_PI * phase_cycles);
+
+    if (code < 0.0) code = 0.0;
+    if (code > DAC_MAX_VALUE) code = DAC_MAX_VALUE;
+    return code;
+}
+
+static int dds_run_case(const dds_case_t *c)
+{
+    static uint16_t block[DAC_DMA_BLOCK_SIZE_MAX];
+    double max_error = 0.0;
+    uint32_t n = 0;
+
+    if (!DAC_setSampleRate(c->rate_hz) || !DAC_setSineFrequency(c->frequency_mhz)) {
+        printf("FAIL rate %lu Hz, %lu mHz: rejected\n",
+               (unsigned long)c->rate_hz, (unsigned long)c->frequency_mhz);
+        return 1;
+    }
+    DAC_selectWaveform(DAC_WAVE_SINE, DAC_DEFAULT_AMPLITUDE_MV, DAC_DEFAULT_OFFSET_MV);
+    dds_phase = 0;
+
+    // TIMG7触发的速率按整数分频取整，以实际采样率为准
+    double cycles_per_sample = (double)c->frequency_mhz / ((double)DAC_getSampleRate() * 1000.0);
+    while (n < DDS_TEST_SAMPLES) {
+        dac_fill(block, dac_block_size);
+        for (uint32_t i = 0; i < dac_block_size; i++, n++) {
+            double ideal = dds_ideal_code(fmod(cycles_per_sample * n, 1.0));
+            double error = fabs((double)block[i] - ideal);
+            if (error > max_error) {
+                max_error = error;
+            }
+        }
+    }
+
+    // 累加器相位与解析相位之差：只来自调谐字舍入，每点不超过0.5LSB
+    double expected = fmod(cycles_per_sample * n, 1.0) * 4294967296.0;
+    double drift = fabs((double)dds_phase - expected);
+    if (drift > 2147483648.0) {
+        drift = 4294967296.0 - drift;
+    }
+    double drift_limit = DDS_MAX_PHASE_LSB * 0.5 * n + 1.0;
+
+    int fail = (max_error > DDS_MAX_ERROR_CODES) || (drift > drift_limit);
+    printf("%s rate %6lu Hz, f %9lu mHz: max error %.2f codes, phase drift %.0f LSB (limit %.0f)\n",
+           fail ? "FAIL" : "ok  ", (unsigned long)c->rate_hz, (unsigned long)c->frequency_mhz,
+           max_error, drift, drift_limit);
+    return fail;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    DAC_init();
+    for (size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++) {
+        failures += dds_run_case(&g_cases[i]);
+    }
+
+    printf("%s: %d failure(s)\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
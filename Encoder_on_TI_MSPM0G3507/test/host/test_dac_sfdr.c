@@ -0,0 +1,172 @@
+/*
+ * DDS无杂散动态范围(SFDR)主机测试：固件的取表/插值填充函数生成8192点，加窗FFT后
+ * 求载波与最大杂散之比；以4096点理想正弦表（同样量化为12位码值）作为对照
+ * 4096点直接取表受12位相位截断限制（约72dBc），插值用16位相位，应不低于该对照
+ *
+ * 构建（在test/host目录下）：
+ *   gcc -std=c99 -O2 -I. -I../../user -o test_dac_sfdr test_dac_sfdr.c ../../user/user_wave_tables.c host_stubs.c -lm
+ */
+#include "../../user/user_DAC.c"
+#include <math.h>
+#include <stdlib.h>
+
+#define SFDR_LOG2           13
+#define SFDR_POINTS         (1 << SFDR_LOG2)
+#define SFDR_RATE_HZ        8000
+#define SFDR_FREQ_MHZ       1234567
+#define SFDR_EXCLUDE_BINS   8       // 载波两侧不计入杂散的频点数（窗函数主瓣）
+#define SFDR_MIN_INTERP_DB  70.0    // 插值的最低SFDR
+#define SFDR_MIN_GAIN_DB    20.0    // 插值相对直接取表的最低改善
+#define SFDR_MAX_GAP_DB     0.0     // 插值低于4096点表的允许量
+#define SFDR_TWO_PI         6.283185307179586
+
+static double g_re[SFDR_POINTS];
+static double g_im[SFDR_POINTS];
+
+/**
+ * @brief 原地基2 FFT（双精度）
+ */
+static void sfdr_fft(double *re, double *im)
+{
+    for (uint32_t i = 1, j = 0; i < SFDR_POINTS; i++) {
+        uint32_t bit = SFDR_POINTS >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= SFDR_POINTS; len <<= 1) {
+        double angle = -SFDR_TWO_PI / len;
+        for (uint32_t start = 0; start < SFDR_POINTS; start += len) {
+            for (uint32_t k = 0; k < len / 2; k++) {
+                double wr = cos(angle * k);
+                double wi = sin(angle * k);
+                uint32_t a = start + k;
+                uint32_t b = a + len / 2;
+                double tr = re[b] * wr - im[b] * wi;
+                double ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 对码值序列加4项Blackman-Harris窗（旁瓣-92dB）做FFT，返回载波与最大杂散之比(dB)
+ */
+static double sfdr_measure(const uint16_t *codes)
+{
+    double mean = 0.0;
+    for (uint32_t i = 0; i < SFDR_POINTS; i++) {
+        mean += codes[i];
+    }
+    mean /= SFDR_POINTS;
+
+    for (uint32_t i = 0; i < SFDR_POINTS; i++) {
+        double x = SFDR_TWO_PI * i / SFDR_POINTS;
+        double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x);
+        g_re[i] = (codes[i] - mean) * w;
+        g_im[i] = 0.0;
+    }
+    sfdr_fft(g_re, g_im);
+
+    uint32_t carrier = 1;
+    double carrier_power = 0.0;
+    for (uint32_t k = 1; k < SFDR_POINTS / 2; k++) {
+        double p = g_re[k] * g_re[k] + g_im[k] * g_im[k];
+        if (p > carrier_power) {
+            carrier_power = p;
+            carrier = k;
+        }
+    }
+
+    double spur_power = 0.0;
+    for (uint32_t k = SFDR_EXCLUDE_BINS; k < SFDR_POINTS / 2; k++) {
+        if (k + SFDR_EXCLUDE_BINS >= carrier && k <= carrier + SFDR_EXCLUDE_BINS) {
+            continue;
+        }
+        double p = g_re[k] * g_re[k] + g_im[k] * g_im[k];
+        if (p > spur_power) {
+            spur_power = p;
+        }
+    }
+    return 10.0 * log10(carrier_power / spur_power);
+}
+
+/**
+ * @brief 用固件填充函数生成SFDR_POINTS个码值
+ */
+static void sfdr_render(dac_fill_t fill, uint16_t *codes)
+{
+    dds_phase = 0;
+    for (uint32_t n = 0; n < SFDR_POINTS; n += dac_block_size) {
+        fill(&codes[n], dac_block_size);
+    }
+}
+
+/**
+ * @brief 对照：4096点理想正弦表直接取表，幅度偏移换算与播放表相同
+ */
+static void sfdr_render_reference(uint16_t *codes)
+{
+    int32_t amplitude = ((int32_t)DAC_DEFAULT_AMPLITUDE_MV * DAC_MAX_VALUE + 1650) / 3300;
+    int32_t offset = ((int32_t)DAC_DEFAULT_OFFSET_MV * DAC_MAX_VALUE + 1650) / 3300;
+    uint32_t phase = 0;
+
+    for (uint32_t n = 0; n < SFDR_POINTS; n++) {
+        double s = sin(SFDR_TWO_PI * (phase >> 20) / 4096.0);
+        int32_t code = offset + (int32_t)lround(amplitude * s);
+        if (code < 0) code = 0;
+        if (code > DAC_MAX_VALUE) code = DAC_MAX_VALUE;
+        codes[n] = (uint16_t)code;
+        phase += dds_tuning_word;
+    }
+}
+
+int main(void)
+{
+    static uint16_t codes[SFDR_POINTS];
+    int failures = 0;
+
+    DAC_init();
+    if (!DAC_setSampleRate(SFDR_RATE_HZ) || !DAC_setSineFrequency(SFDR_FREQ_MHZ)) {
+        printf("FAIL: rate/frequency rejected\n");
+        return EXIT_FAILURE;
+    }
+    DAC_selectWaveform(DAC_WAVE_SINE, DAC_DEFAULT_AMPLITUDE_MV, DAC_DEFAULT_OFFSET_MV);
+
+    sfdr_render(dac_fill_nearest, codes);
+    double nearest = sfdr_measure(codes);
+    sfdr_render(dac_fill_interpolated, codes);
+    double interpolated = sfdr_measure(codes);
+    sfdr_render_reference(codes);
+    double reference = sfdr_measure(codes);
+
+    printf("%u Hz, %.3f Hz tone, %d-point FFT\n", SFDR_RATE_HZ, SFDR_FREQ_MHZ / 1000.0, SFDR_POINTS);
+    printf("  nearest, 256 entries:       SFDR %.1f dBc\n", nearest);
+    printf("  interpolated, 256 entries:  SFDR %.1f dBc\n", interpolated);
+    printf("  ideal 4096-entry table:     SFDR %.1f dBc\n", reference);
+
+    if (interpolated < SFDR_MIN_INTERP_DB) {
+        printf("FAIL interpolated SFDR below %.1f dBc\n", SFDR_MIN_INTERP_DB);
+        failures++;
+    }
+    if (interpolated - nearest < SFDR_MIN_GAIN_DB) {
+        printf("FAIL interpolation gains less than %.1f dB over nearest\n", SFDR_MIN_GAIN_DB);
+        failures++;
+    }
+    if (reference - interpolated > SFDR_MAX_GAP_DB) {
+        printf("FAIL interpolated more than %.1f dB below the 4096-entry table\n", SFDR_MAX_GAP_DB);
+        failures++;
+    }
+
+    printf("%s: %d failure(s)\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/*
+ * 编码器GPIO解码主机测试：按机械编码器常见的抖动形态构造两相电平序列（接触抖动、定位格处颤动、
+ * 中断延迟漏掉边沿），逐点送入user_encoder_gpio_irq()的16项状态转移表，检查各分辨率下的计数和非法转移数
+ * 以-DENCODER_USE_QEI=0编译GPIO解码路径；QEI模式的计数由TIMG8硬件完成，不在主机上测试
+ *
+ * 构建（在test/host目录下）：
+ *   gcc -std=c99 -O2 -DENCODER_USE_QEI=0 -I. -I../.. -I../../user -o test_encoder test_encoder.c host_stubs.c -lm
+ */
+#include "../../user/user_Encoder.c"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    const char *name;
+    uint8_t resolution;     // 每个定位格的计数值
+    int16_t start_count;
+    const char *trace;      // 中断中读到的两相电平"AB"，第一组为初始化时的电平
+    int16_t expected_count;
+    uint32_t expected_glitches;
+} enc_case_t;
+
+static const enc_case_t g_cases[] = {
+    {"clean CW, 3 detents",     1, 16, "11 01 00 10 11 01 00 10 11 01 00 10 11", 19, 0},
+    {"clean CCW, 2 detents",    1, 16, "11 10 00 01 11 10 00 01 11",             14, 0},
+    // A相接触抖动：每个边沿来回跳变数次，+1/-1相互抵消
+    {"bounce on A",             1, 16, "11 01 11 01 11 01 00 10 00 10 00 10 11", 17, 0},
+    // 停在定位格上的颤动：两相分别抖动但不转动
+    {"chatter at detent",       1, 16, "11 01 11 01 11 10 11 10 11",             16, 0},
+    // 中断延迟：01之后直接读到10（两相同时变化），记一次非法转移并丢弃这两个边沿
+    {"missed edge, 4x",         4, 16, "11 01 10 11 01 00 10 11",                22, 1},
+    {"missed edge, 1x",         1, 16, "11 01 10 11 01 00 10 11",                17, 1},
+    // 半个定位格：2x时计1，1x时不足一个计数
+    {"half detent, 2x",         2, 16, "11 01 00",                               17, 0},
+    {"half detent, 1x",         1, 16, "11 01 00",                               16, 0},
+    // B相接触抖动，逆时针一个定位格
+    {"bounce on B, CCW, 4x",    4, 10, "11 10 11 10 00 01 00 01 11",              6, 0},
+    // 计数范围限幅
+    {"clamp at max",            4, 32, "11 01 00 10 11",                         ENCODER_COUNT_MAX, 0},
+    {"clamp at min",            2,  0, "11 10 00 01 11",                         ENCODER_COUNT_MIN, 0},
+};
+
+// 被测文件引用的其他模块：本测试只关心计数，DAC和斜坡为空操作
+uint16_t DAC_correctCode(uint16_t ideal_code)
+{
+    return ideal_code;
+}
+
+void user_ramp_set_target_mv(uint16_t millivolts)
+{
+    (void)millivolts;
+}
+
+void firewater_send_encoder(int16_t count, uint8_t counts_per_detent, uint32_t glitches)
+{
+    printf("encoder:%d,%u,%lu\n", (int)count, (unsigned int)counts_per_detent, (unsigned long)glitches);
+}
+
+/**
+ * @brief 按"AB"两位电平设置PA17/PA24
+ */
+static void enc_set_pins(const char *ab)
+{
+    host_gpio_pins = ((ab[0] == '1') ? ENCODER_PIN_A : 0U) | ((ab[1] == '1') ? ENCODER_PIN_B : 0U);
+}
+
+static int enc_run_case(const enc_case_t *c)
+{
+    const char *p = c->trace;
+
+    // 初始化时记录第一组电平，之后每组电平对应一次边沿中断，每次中断后主循环读一次计数
+    enc_set_pins(p);
+    user_encoder_init();
+    user_encoder_set_resolution(c->resolution);
+    user_encoder_set_count(c->start_count);
+    uint32_t glitches_before = user_encoder_get_glitches();
+
+    for (p += 2; *p != '\0'; p += 2) {
+        while (*p == ' ') {
+            p++;
+        }
+        enc_set_pins(p);
+        user_encoder_gpio_irq();
+        user_encoder_get_count();
+    }
+
+    int16_t count = user_encoder_get_count();
+    uint32_t glitches = user_encoder_get_glitches() - glitches_before;
+    int fail = (count != c->expected_count) || (glitches != c->expected_glitches) ||
+               (user_encoder_get_resolution() != c->resolution);
+    printf("%s %-22s %ux: count %2d (expected %2d), glitches %lu (expected %lu)\n",
+           fail ? "FAIL" : "ok  ", c->name, c->resolution, count, c->expected_count,
+           (unsigned long)glitches, (unsigned long)c->expected_glitches);
+    return fail;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++) {
+        failures += enc_run_case(&g_cases[i]);
+    }
+    if (user_encoder_set_resolution(3)) {
+        printf("FAIL resolution 3 accepted\n");
+        failures++;
+    }
+
+    printf("%s: %d failure(s)\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
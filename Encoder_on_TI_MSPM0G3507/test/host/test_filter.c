@@ -0,0 +1,153 @@
+/*
+ * 滤波级主机测试：各预置FIR/IIR/CIC的定点输出与双精度参考实现逐点比较
+ * 参考实现使用同一组量化系数，差异只来自定点舍入，误差上限按码值给出
+ *
+ * 构建（在test/host目录下）：
+ *   gcc -std=c99 -O2 -I. -I../../user -o test_filter test_filter.c ../../user/user_filter.c host_stubs.c -lm
+ */
+#include "user_filter.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_SAMPLES    2048
+#define TEST_PI         3.14159265358979323846
+
+static uint16_t g_input[TEST_SAMPLES];
+static uint16_t g_output[TEST_SAMPLES];
+static double g_reference[TEST_SAMPLES];
+
+/**
+ * @brief 测试信号：两个正弦、一个阶跃和小幅伪随机噪声，覆盖通带、阻带和瞬态
+ */
+static void make_input(void)
+{
+    uint32_t lfsr = 0xACE1u;
+
+    for (int n = 0; n < TEST_SAMPLES; n++) {
+        lfsr = lfsr * 1103515245u + 12345u;
+        double v = 2048.0 + 900.0 * sin(2.0 * TEST_PI * 0.01 * n)
+                 + 500.0 * sin(2.0 * TEST_PI * 0.23 * n)
+                 + ((n >= TEST_SAMPLES / 2) ? 400.0 : -400.0)
+                 + (double)((lfsr >> 16) % 64) - 32.0;
+        g_input[n] = (uint16_t)lround(v);
+    }
+}
+
+/**
+ * @brief 码值转为滤波器内部格式（与firmware相同的偏移和放大，但为双精度）
+ */
+static double to_internal(uint16_t code)
+{
+    return ((double)code - FILTER_ADC_MIDSCALE) * (1 << FILTER_INTERNAL_SHIFT);
+}
+
+static double to_code(double internal)
+{
+    double code = internal / (1 << FILTER_INTERNAL_SHIFT) + FILTER_ADC_MIDSCALE;
+    if (code < 0.0) code = 0.0;
+    if (code > 4095.0) code = 4095.0;
+    return code;
+}
+
+static int reference_fir(const filter_preset_desc_t *desc)
+{
+    for (int n = 0; n < TEST_SAMPLES; n++) {
+        double acc = 0.0;
+        for (int k = 0; k < desc->length && k <= n; k++) {
+            acc += desc->coeffs[k] / 32768.0 * to_internal(g_input[n - k]);
+        }
+        // 延迟线初始为0（内部格式的中点）
+        g_reference[n] = to_code(acc);
+    }
+    return TEST_SAMPLES;
+}
+
+static int reference_iir(const filter_preset_desc_t *desc)
+{
+    double x1[FILTER_IIR_MAX_STAGES] = {0}, x2[FILTER_IIR_MAX_STAGES] = {0};
+    double y1[FILTER_IIR_MAX_STAGES] = {0}, y2[FILTER_IIR_MAX_STAGES] = {0};
+    const double q = 1 << FILTER_IIR_COEFF_SHIFT;
+
+    for (int n = 0; n < TEST_SAMPLES; n++) {
+        double x = to_internal(g_input[n]);
+        const int16_t *c = desc->coeffs;
+        for (int s = 0; s < desc->length; s++, c += 5) {
+            double y = (c[0] * x + c[1] * x1[s] + c[2] * x2[s] - c[3] * y1[s] - c[4] * y2[s]) / q;
+            x2[s] = x1[s];
+            x1[s] = x;
+            y2[s] = y1[s];
+            y1[s] = y;
+            x = y;
+        }
+        g_reference[n] = to_code(x);
+    }
+    return TEST_SAMPLES;
+}
+
+static int reference_cic(const filter_preset_desc_t *desc)
+{
+    // N阶CIC等价于N个长度为R的滑动和级联，再按R抽取、除以R^N
+    static double stage[FILTER_CIC_ORDER + 1][TEST_SAMPLES];
+    int r = desc->length;
+    int out = 0;
+
+    for (int n = 0; n < TEST_SAMPLES; n++) {
+        stage[0][n] = to_internal(g_input[n]);
+    }
+    for (int k = 1; k <= FILTER_CIC_ORDER; k++) {
+        for (int n = 0; n < TEST_SAMPLES; n++) {
+            double acc = 0.0;
+            for (int j = 0; j < r && j <= n; j++) {
+                acc += stage[k - 1][n - j];
+            }
+            stage[k][n] = acc;
+        }
+    }
+    for (int n = r - 1; n < TEST_SAMPLES; n += r) {
+        g_reference[out++] = to_code(stage[FILTER_CIC_ORDER][n] / pow(r, FILTER_CIC_ORDER));
+    }
+    return out;
+}
+
+int main(void)
+{
+    // 允许误差（码值）：FIR和CIC只在输出处舍入一次；IIR每级舍入的误差经极点放大
+    static const double tolerance[FILTER_PRESET_MAX] = {0.0, 1.0, 1.0, 2.0, 4.0, 1.0, 1.0};
+    int failures = 0;
+
+    make_input();
+
+    for (int p = 0; p < FILTER_PRESET_MAX; p++) {
+        const filter_preset_desc_t *desc = user_filter_get_desc((filter_preset_t)p);
+        int expected;
+
+        user_filter_select((filter_preset_t)p);
+        uint16_t produced = user_filter_process_block(g_input, g_output, TEST_SAMPLES);
+
+        switch (desc->type) {
+            case FILTER_TYPE_FIR: expected = reference_fir(desc); break;
+            case FILTER_TYPE_IIR: expected = reference_iir(desc); break;
+            case FILTER_TYPE_CIC: expected = reference_cic(desc); break;
+            default:
+                for (int n = 0; n < TEST_SAMPLES; n++) {
+                    g_reference[n] = g_input[n];
+                }
+                expected = TEST_SAMPLES;
+                break;
+        }
+
+        double max_error = 0.0;
+        for (int n = 0; n < expected && n < produced; n++) {
+            double e = fabs(g_output[n] - g_reference[n]);
+            if (e > max_error) max_error = e;
+        }
+        bool ok = (produced == expected) && (max_error <= tolerance[p]);
+        printf("%-9s outputs %4u/%4d  max error %.2f codes (limit %.1f)  %s\n",
+               desc->name, produced, expected, max_error, tolerance[p], ok ? "PASS" : "FAIL");
+        failures += ok ? 0 : 1;
+    }
+
+    user_filter_benchmark();  // 主机上周期数恒为0，只确认每个预置都能运行
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/*
+ * 多音合成频谱主机测试：固件的dac_fill_multitone生成8192点，加窗FFT后检查
+ * 各音的幅度（按主瓣能量换算，与限幅缩小后的振荡器幅度比较）和音以外的最大杂散
+ *
+ * 构建（在test/host目录下）：
+ *   gcc -std=c99 -O2 -I. -I../../user -o test_multitone test_multitone.c ../../user/user_wave_tables.c host_stubs.c -lm
+ */
+#include "../../user/user_DAC.c"
+#include <math.h>
+#include <stdlib.h>
+
+#define MT_LOG2             13
+#define MT_POINTS           (1 << MT_LOG2)
+#define MT_RATE_HZ          8000
+#define MT_LOBE_BINS        8       // 每个音两侧计入主瓣的频点数（窗函数主瓣±4格，留余量）
+#define MT_MAX_LEVEL_DB     0.05    // 各音幅度与振荡器幅度的允许偏差
+#define MT_TWO_PI           6.283185307179586
+
+typedef struct {
+    const char *name;
+    dac_tone_t tones[DAC_MULTITONE_MAX];
+    uint8_t count;
+    uint16_t offset_mv;
+    uint8_t scale_percent;  // 期望的限幅缩小比例
+    double max_spur_dbc;    // 最大杂散（相对最强的音），比实测值留约6dB余量
+} mt_case_t;
+
+static const mt_case_t g_cases[] = {
+    // DTMF "5"：两音之和超出摆幅，按比例缩小
+    {"DTMF 5", {{770000, 1000, 0}, {1336000, 1000, 0}}, 2, 1650, 82, -84.0},
+    // 四个不等幅的音：最弱的音比最强的低14dB，杂散受12位量化限制
+    {"4 tones", {{440000, 500, 0}, {1000000, 300, 90}, {1500000, 200, 180}, {2750000, 100, 45}},
+     4, 1650, 100, -74.0},
+    // 四个等幅的音，缩小到51%
+    {"4 tones, scaled", {{697000, 800, 0}, {1209000, 800, 0}, {1633000, 800, 0}, {3100000, 800, 0}},
+     4, 1650, 51, -79.0},
+};
+
+static double g_re[MT_POINTS];
+static double g_im[MT_POINTS];
+static double g_window_power;   // 窗函数平方和
+
+/**
+ * @brief 原地基2 FFT（双精度）
+ */
+static void mt_fft(double *re, double *im)
+{
+    for (uint32_t i = 1, j = 0; i < MT_POINTS; i++) {
+        uint32_t bit = MT_POINTS >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= MT_POINTS; len <<= 1) {
+        double angle = -MT_TWO_PI / len;
+        for (uint32_t start = 0; start < MT_POINTS; start += len) {
+            for (uint32_t k = 0; k < len / 2; k++) {
+                double wr = cos(angle * k);
+                double wi = sin(angle * k);
+                uint32_t a = start + k;
+                uint32_t b = a + len / 2;
+                double tr = re[b] * wr - im[b] * wi;
+                double ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 对码值序列减均值、加4项Blackman-Harris窗（旁瓣-92dB）后做FFT
+ */
+static void mt_spectrum(const uint16_t *codes)
+{
+    double mean = 0.0;
+    for (uint32_t i = 0; i < MT_POINTS; i++) {
+        mean += codes[i];
+    }
+    mean /= MT_POINTS;
+
+    g_window_power = 0.0;
+    for (uint32_t i = 0; i < MT_POINTS; i++) {
+        double x = MT_TWO_PI * i / MT_POINTS;
+        double w = 0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x);
+        g_re[i] = (codes[i] - mean) * w;
+        g_im[i] = 0.0;
+        g_window_power += w * w;
+    }
+    mt_fft(g_re, g_im);
+}
+
+static uint32_t mt_bin(uint32_t frequency_mhz)
+{
+    return (uint32_t)lround((double)frequency_mhz * MT_POINTS / (MT_RATE_HZ * 1000.0));
+}
+
+/**
+ * @brief 按主瓣内的能量求音的峰值幅度（码值），不受频点偏移（扇贝损失）影响
+ * 正频率一侧的能量为 A^2/4 x N x Σw^2
+ */
+static double mt_tone_amplitude(uint32_t center)
+{
+    double power = 0.0;
+    for (uint32_t k = center - MT_LOBE_BINS; k <= center + MT_LOBE_BINS; k++) {
+        power += g_re[k] * g_re[k] + g_im[k] * g_im[k];
+    }
+    return sqrt(4.0 * power / (MT_POINTS * g_window_power));
+}
+
+/**
+ * @brief 各音主瓣以外的最大频点幅度（码值，按与音相同的能量换算）
+ */
+static double mt_max_spur(const uint32_t *bins, uint8_t count)
+{
+    double spur_power = 0.0;
+
+    for (uint32_t k = MT_LOBE_BINS; k < MT_POINTS / 2; k++) {
+        bool in_lobe = false;
+        for (uint8_t t = 0; t < count; t++) {
+            if (k + MT_LOBE_BINS >= bins[t] && k <= bins[t] + MT_LOBE_BINS) {
+                in_lobe = true;
+            }
+        }
+        double p = g_re[k] * g_re[k] + g_im[k] * g_im[k];
+        if (!in_lobe && p > spur_power) {
+            spur_power = p;
+        }
+    }
+    // 单个频点只含主瓣能量的一部分，按窗函数峰值频点的能量占比换算为等效幅度
+    double window_sum = 0.35875 * MT_POINTS;
+    return sqrt(spur_power) * 2.0 / window_sum;
+}
+
+static int mt_run_case(const mt_case_t *c)
+{
+    static uint16_t codes[MT_POINTS];
+    uint32_t bins[DAC_MULTITONE_MAX];
+    int fail = 0;
+
+    if (!DAC_startMultitone(c->tones, c->count, c->offset_mv)) {
+        printf("FAIL %s: rejected\n", c->name);
+        return 1;
+    }
+    for (uint32_t n = 0; n < MT_POINTS; n += dac_block_size) {
+        dac_fill(&codes[n], dac_block_size);
+    }
+    mt_spectrum(codes);
+
+    if (DAC_getMultitoneScale() != c->scale_percent) {
+        printf("FAIL %s: scaled to %u%%, expected %u%%\n", c->name, DAC_getMultitoneScale(), c->scale_percent);
+        fail = 1;
+    }
+
+    double strongest = 0.0;
+    for (uint8_t t = 0; t < c->count; t++) {
+        bins[t] = mt_bin(c->tones[t].frequency_mhz);
+        double measured = mt_tone_amplitude(bins[t]);
+        double expected = multitone[t].amplitude * 32767.0 / 32768.0;
+        double error_db = 20.0 * log10(measured / expected);
+        int tone_fail = fabs(error_db) > MT_MAX_LEVEL_DB;
+
+        printf("%s %-16s %8.3f Hz: %7.1f codes (oscillator %4ld), %+.3f dB\n",
+               tone_fail ? "FAIL" : "ok  ", c->name, c->tones[t].frequency_mhz / 1000.0,
+               measured, (long)multitone[t].amplitude, error_db);
+        fail |= tone_fail;
+        if (measured > strongest) {
+            strongest = measured;
+        }
+    }
+
+    double spur_dbc = 20.0 * log10(mt_max_spur(bins, c->count) / strongest);
+    int spur_fail = spur_dbc > c->max_spur_dbc;
+    printf("%s %-16s worst spur %.1f dBc (limit %.1f)\n",
+           spur_fail ? "FAIL" : "ok  ", c->name, spur_dbc, c->max_spur_dbc);
+    return fail | spur_fail;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    DAC_init();
+    if (!DAC_setSampleRate(MT_RATE_HZ)) {
+        printf("FAIL: rate rejected\n");
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++) {
+        failures += mt_run_case(&g_cases[i]);
+    }
+    DAC_stopMultitone();
+
+    printf("%s: %d failure(s)\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
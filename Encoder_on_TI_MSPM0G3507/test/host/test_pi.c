@@ -0,0 +1,165 @@
+/*
+ * PI控制器主机测试：user_pi.c按闭环稳压的参数(REG_*)驱动仿真对象，检查稳态误差、超调、稳定时间和抗积分饱和
+ * 仿真对象：DAC码值 -> 毫伏（带增益误差和偏移）-> 一阶RC低通 -> 按1mV取整的测量值，每REG_PERIOD_MS一步
+ *
+ * 构建（在test/host目录下）：
+ *   gcc -std=c99 -O2 -I. -I../../user -o test_pi test_pi.c ../../user/user_pi.c -lm
+ */
+#include "user_pi.h"
+#include "user_regulator.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PI_TEST_CYCLES          300     // 每个用例的控制周期数
+#define PI_MAX_STEADY_MV        1       // 稳态误差上限（微调量1码值约0.8mV）
+#define PI_MAX_OVERSHOOT_MV     20      // 超调上限
+#define PI_MAX_SETTLE_CYCLES    40      // 进入±REG_SETTLE_BAND_MV稳定带的周期数上限
+#define PI_WINDUP_CYCLES        200     // 抗饱和用例中持续饱和的周期数
+
+typedef struct {
+    const char *name;
+    double gain;            // DAC增益误差（1.0为理想）
+    double offset_mv;       // 输出偏移
+    double tau_ms;          // 输出端RC时间常数
+    uint16_t target_mv;     // 设定值
+} pi_case_t;
+
+static const pi_case_t g_cases[] = {
+    {"gain -5%, offset +30mV",     0.95,  30.0,  5.0, 1650},
+    {"gain +5%, offset -50mV",     1.05, -50.0,  5.0, 1650},
+    {"slow RC (30ms)",             0.97,  20.0, 30.0, 2500},
+    {"low end, offset -60mV",      1.00, -60.0,  5.0,  100},
+};
+
+typedef struct {
+    double output_mv;       // RC输出
+    double gain;
+    double offset_mv;
+    double alpha;           // 每周期的RC更新系数
+} pi_plant_t;
+
+static void plant_init(pi_plant_t *plant, double gain, double offset_mv, double tau_ms)
+{
+    plant->output_mv = 0.0;
+    plant->gain = gain;
+    plant->offset_mv = offset_mv;
+    plant->alpha = 1.0 - exp(-(double)REG_PERIOD_MS / tau_ms);
+}
+
+/**
+ * @brief 按开环码值加微调量推进一个控制周期，返回周期末的测量值(mV)
+ */
+static int32_t plant_step(pi_plant_t *plant, uint16_t code, int32_t trim)
+{
+    int32_t total = (int32_t)code + trim;
+
+    if (total < 0) total = 0;
+    if (total > 4095) total = 4095;
+    double dac_mv = total * 3300.0 / 4095.0 * plant->gain + plant->offset_mv;
+    if (dac_mv < 0.0) dac_mv = 0.0;
+    plant->output_mv += plant->alpha * (dac_mv - plant->output_mv);
+    return (int32_t)lround(plant->output_mv);
+}
+
+/**
+ * @brief 闭环运行cycles个周期，统计超调和稳定时间（判据与user_regulator.c相同）
+ * @return 最后一个周期的误差(mV)
+ */
+static int32_t run_loop(pi_controller_t *pi, pi_plant_t *plant, uint16_t target_mv, uint32_t cycles,
+                        int32_t *overshoot, int32_t *settle_cycles)
+{
+    uint16_t code = (uint16_t)(((uint32_t)target_mv * 4095U) / 3300U);
+    int32_t measured = (int32_t)lround(plant->output_mv);
+    int32_t start = measured;
+    int32_t error = 0;
+    uint32_t band_count = 0;
+
+    *overshoot = 0;
+    *settle_cycles = -1;
+    for (uint32_t n = 0; n < cycles; n++) {
+        error = (int32_t)target_mv - measured;
+        int32_t trim = user_pi_step(pi, error);
+        measured = plant_step(plant, code, trim);
+
+        int32_t beyond = (target_mv >= start) ? measured - target_mv : target_mv - measured;
+        if (beyond > *overshoot) {
+            *overshoot = beyond;
+        }
+        if (abs(measured - (int32_t)target_mv) > REG_SETTLE_BAND_MV) {
+            band_count = 0;
+            *settle_cycles = -1;
+        } else if (++band_count == REG_SETTLE_SAMPLES) {
+            *settle_cycles = (int32_t)(n + 1 - REG_SETTLE_SAMPLES);
+        }
+    }
+    return (int32_t)target_mv - measured;
+}
+
+static int pi_run_case(const pi_case_t *c)
+{
+    pi_controller_t pi;
+    pi_plant_t plant;
+    int32_t overshoot;
+    int32_t settle;
+
+    user_pi_init(&pi, REG_KP_Q16, REG_KI_Q16, -REG_TRIM_MAX_CODES, REG_TRIM_MAX_CODES);
+    plant_init(&plant, c->gain, c->offset_mv, c->tau_ms);
+    // 先开环稳定在目标码值的输出上，再闭环：与编码器调到目标后开启闭环的情形相同
+    for (uint32_t n = 0; n < 100; n++) {
+        plant_step(&plant, (uint16_t)(((uint32_t)c->target_mv * 4095U) / 3300U), 0);
+    }
+    int32_t error = run_loop(&pi, &plant, c->target_mv, PI_TEST_CYCLES, &overshoot, &settle);
+
+    int fail = abs(error) > PI_MAX_STEADY_MV || overshoot > PI_MAX_OVERSHOOT_MV ||
+               settle < 0 || settle > PI_MAX_SETTLE_CYCLES || pi.saturated;
+    printf("%s %-26s steady %+ld mV, overshoot %ld mV, settled after %ld cycles, trim %ld\n",
+           fail ? "FAIL" : "ok  ", c->name, (long)error, (long)overshoot, (long)settle, (long)pi.output);
+    return fail;
+}
+
+/**
+ * @brief 抗积分饱和：偏移超出微调范围时输出限幅、积分不再增长；偏移恢复后应与普通阶跃一样快地稳定
+ */
+static int pi_run_windup(void)
+{
+    pi_controller_t pi;
+    pi_plant_t plant;
+    int32_t overshoot;
+    int32_t settle;
+    int fail = 0;
+
+    user_pi_init(&pi, REG_KP_Q16, REG_KI_Q16, -REG_TRIM_MAX_CODES, REG_TRIM_MAX_CODES);
+    plant_init(&plant, 1.0, 400.0, 5.0);
+    run_loop(&pi, &plant, 1650, PI_WINDUP_CYCLES, &overshoot, &settle);
+
+    int64_t floor_q16 = -((int64_t)REG_TRIM_MAX_CODES << 16);
+    if (!pi.saturated || pi.output != -REG_TRIM_MAX_CODES || pi.integral_q16 < floor_q16) {
+        printf("FAIL windup: saturated %d, trim %ld, integral %.1f codes\n",
+               pi.saturated, (long)pi.output, pi.integral_q16 / 65536.0);
+        fail = 1;
+    }
+
+    // 偏移消失：积分停在限幅处，恢复时间只取决于从限幅处回到零
+    plant.offset_mv = 0.0;
+    int32_t error = run_loop(&pi, &plant, 1650, PI_TEST_CYCLES, &overshoot, &settle);
+    if (abs(error) > PI_MAX_STEADY_MV || settle < 0 || settle > PI_MAX_SETTLE_CYCLES) {
+        fail = 1;
+    }
+    printf("%s %-26s recovered after %ld cycles, undershoot %ld mV, steady %+ld mV\n",
+           fail ? "FAIL" : "ok  ", "windup (+400mV offset)", (long)settle, (long)overshoot, (long)error);
+    return fail;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++) {
+        failures += pi_run_case(&g_cases[i]);
+    }
+    failures += pi_run_windup();
+
+    printf("%s: %d failure(s)\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
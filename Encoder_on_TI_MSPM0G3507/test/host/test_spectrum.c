@@ -0,0 +1,261 @@
+/*
+ * 频谱分析主机测试：固件的定点FFT（Hann窗、每级右移1位）和Goertzel检测器与双精度直接DFT比较
+ * 输入为带谐波和均匀噪声的12位码值正弦；按固件的定义（主瓣±2格、2~5次谐波、去掉直流区）
+ * 用参考频谱求THD和SNR，检查各频点幅度、基波频率和幅度、THD、SNR以及Goertzel幅度的偏差
+ *
+ * 构建（在test/host目录下）：
+ *   gcc -std=c99 -O2 -I. -I../../user -o test_spectrum test_spectrum.c host_stubs.c -lm
+ */
+#include "../../user/user_spectrum.c"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SP_N                SPECTRUM_FFT_SIZE
+#define SP_RATE_HZ          8000
+#define SP_MAX_BIN_ERROR    3.0     // 各频点幅度与参考的最大偏差（FFT输出单位，峰值约为4x码值幅度）
+#define SP_MAX_FREQ_PPM     2000.0  // 基波频率偏差（ppm）：插值公式在频点之间的固有误差
+#define SP_MAX_AMPL_PCT     1.0     // 基波幅度偏差（%）
+#define SP_MAX_GOERTZEL     1.0     // Goertzel幅度与参考的最大偏差：1码值加幅度的0.5%
+#define SP_MAX_GOERTZEL_PCT 0.5     // （Q14系数在低频时的量化误差）
+#define SP_TWO_PI           6.283185307179586
+
+typedef struct {
+    const char *name;
+    double frequency_hz;
+    double amplitude;       // 基波幅度（码值）
+    double h2_dbc;          // 2次谐波（相对基波）
+    double h3_dbc;          // 3次谐波（相对基波）
+    int32_t noise;          // 均匀噪声幅度（码值，±noise）
+    double max_thd_db;      // THD与参考的允许偏差
+    double max_snr_db;      // SNR与参考的允许偏差
+} sp_case_t;
+
+static const sp_case_t g_cases[] = {
+    // 基波正好落在频点上，无谐波：参考THD/SNR接近16位定点FFT的噪底（约63dB），实测偏低数dB
+    {"on bin, pure",          1000.0,     1800.0, -200.0, -200.0,  2, 5.0, 6.0},
+    // 频点之间，谐波和噪声均明显高于定点运算误差
+    {"between bins",          1234.567,   1200.0,  -40.0,  -50.0,  8, 0.3, 0.5},
+    {"low frequency",          187.5,      900.0,  -35.0,  -45.0,  4, 0.3, 2.0},
+    // 小信号：峰值频点只有约500，SNR受运算噪声影响
+    {"small signal",          1456.7,      120.0,  -30.0,  -40.0,  3, 0.5, 1.5},
+};
+
+static uint16_t g_codes[SP_N];
+static double g_ref_power[SPECTRUM_BINS];   // 参考频谱功率，与固件g_spectrum_power同一单位
+static uint32_t g_lcg = 12345U;
+
+static int32_t sp_noise(int32_t amplitude)
+{
+    g_lcg = g_lcg * 1103515245U + 12345U;
+    return (amplitude == 0) ? 0 : (int32_t)((g_lcg >> 16) % (uint32_t)(2 * amplitude + 1)) - amplitude;
+}
+
+static void sp_generate(const sp_case_t *c)
+{
+    double a2 = c->amplitude * pow(10.0, c->h2_dbc / 20.0);
+    double a3 = c->amplitude * pow(10.0, c->h3_dbc / 20.0);
+
+    for (uint32_t n = 0; n < SP_N; n++) {
+        double phase = SP_TWO_PI * c->frequency_hz * n / SP_RATE_HZ + 0.3;
+        double x = 2048.0 + c->amplitude * sin(phase) + a2 * sin(2.0 * phase + 1.0) + a3 * sin(3.0 * phase + 2.0);
+        long code = lround(x) + sp_noise(c->noise);
+        g_codes[n] = (uint16_t)((code < 0) ? 0 : (code > 4095) ? 4095 : code);
+    }
+}
+
+/**
+ * @brief 参考频谱：与固件相同的Hann窗和缩放（输入左移4位，输出为DFT/N），双精度直接DFT
+ */
+static void sp_reference_spectrum(void)
+{
+    double x[SP_N];
+
+    for (uint32_t n = 0; n < SP_N; n++) {
+        double w = 0.5 * (1.0 - cos(SP_TWO_PI * n / SP_N));
+        x[n] = ((double)g_codes[n] - SPECTRUM_ADC_MIDSCALE) * (1 << SPECTRUM_INPUT_SHIFT) * w;
+    }
+    for (uint32_t k = 0; k < SPECTRUM_BINS; k++) {
+        double re = 0.0;
+        double im = 0.0;
+        for (uint32_t n = 0; n < SP_N; n++) {
+            double angle = SP_TWO_PI * (double)((k * n) % SP_N) / SP_N;
+            re += x[n] * cos(angle);
+            im -= x[n] * sin(angle);
+        }
+        re /= SP_N;
+        im /= SP_N;
+        g_ref_power[k] = re * re + im * im;
+    }
+}
+
+static double sp_band_power(uint32_t center)
+{
+    double sum = 0.0;
+    for (uint32_t k = center - SPECTRUM_LOBE_HALF; k <= center + SPECTRUM_LOBE_HALF; k++) {
+        sum += g_ref_power[k];
+    }
+    return sum;
+}
+
+/**
+ * @brief Goertzel参考：矩形窗下目标频率的DFT，返回峰值幅度（码值）
+ */
+static double sp_reference_goertzel(double frequency_hz)
+{
+    double re = 0.0;
+    double im = 0.0;
+
+    for (uint32_t n = 0; n < SP_N; n++) {
+        double angle = SP_TWO_PI * frequency_hz * n / SP_RATE_HZ;
+        double x = (double)g_codes[n] - SPECTRUM_ADC_MIDSCALE;
+        re += x * cos(angle);
+        im -= x * sin(angle);
+    }
+    return 2.0 * sqrt(re * re + im * im) / SP_N;
+}
+
+static int sp_run_case(const sp_case_t *c)
+{
+    spectrum_result_t result;
+    int fail = 0;
+
+    sp_generate(c);
+    sp_reference_spectrum();
+    if (!user_spectrum_analyze(g_codes, SP_RATE_HZ * 1000U, &result)) {
+        printf("FAIL %s: no fundamental\n", c->name);
+        return 1;
+    }
+
+    // 各频点幅度
+    double max_bin_error = 0.0;
+    for (uint32_t k = 0; k < SPECTRUM_BINS; k++) {
+        double error = fabs(g_spectrum_mag[k] - sqrt(g_ref_power[k]));
+        if (error > max_bin_error) {
+            max_bin_error = error;
+        }
+    }
+    int bins_fail = max_bin_error > SP_MAX_BIN_ERROR;
+    printf("%s %-14s bins: max error %.2f (limit %.1f)\n",
+           bins_fail ? "FAIL" : "ok  ", c->name, max_bin_error, SP_MAX_BIN_ERROR);
+    fail |= bins_fail;
+
+    // 基波频率和幅度与输入信号比较
+    double freq_ppm = (result.frequency_mhz / 1000.0 - c->frequency_hz) / c->frequency_hz * 1e6;
+    double expected_mv = c->amplitude * ADC_REFERENCE_MILLIVOLTS / ADC_MAX_VALUE;
+    double ampl_pct = (result.amplitude_mv - expected_mv) / expected_mv * 100.0;
+    int fund_fail = fabs(freq_ppm) > SP_MAX_FREQ_PPM || fabs(ampl_pct) > SP_MAX_AMPL_PCT;
+    printf("%s %-14s fundamental: %.3f Hz (%+.0f ppm), %u mV (%+.2f%%)\n",
+           fund_fail ? "FAIL" : "ok  ", c->name, result.frequency_mhz / 1000.0, freq_ppm,
+           (unsigned int)result.amplitude_mv, ampl_pct);
+    fail |= fund_fail;
+
+    // THD/SNR：参考频谱按已知频率取谐波主瓣
+    uint32_t peak = (uint32_t)lround(c->frequency_hz * SP_N / SP_RATE_HZ);
+    double total = 0.0;
+    double harmonics = 0.0;
+    for (uint32_t k = SPECTRUM_DC_BINS; k < SPECTRUM_BINS; k++) {
+        total += g_ref_power[k];
+    }
+    double fundamental = sp_band_power(peak);
+    for (uint32_t h = 2; h <= SPECTRUM_MAX_HARMONIC; h++) {
+        uint32_t center = (uint32_t)lround(h * c->frequency_hz * SP_N / SP_RATE_HZ);
+        if (center + SPECTRUM_LOBE_HALF >= SPECTRUM_BINS) {
+            break;
+        }
+        harmonics += sp_band_power(center);
+    }
+    double ref_thd = 10.0 * log10(harmonics / fundamental);
+    double ref_snr = 10.0 * log10(fundamental / (total - fundamental - harmonics));
+    double thd_error = result.thd_db_x10 / 10.0 - ref_thd;
+    double snr_error = result.snr_db_x10 / 10.0 - ref_snr;
+    int db_fail = fabs(thd_error) > c->max_thd_db || fabs(snr_error) > c->max_snr_db;
+    printf("%s %-14s THD %.1f dB (ref %.2f), SNR %.1f dB (ref %.2f)\n",
+           db_fail ? "FAIL" : "ok  ", c->name, result.thd_db_x10 / 10.0, ref_thd,
+           result.snr_db_x10 / 10.0, ref_snr);
+    fail |= db_fail;
+
+    // Goertzel：基波和2次谐波
+    for (uint32_t h = 1; h <= 2; h++) {
+        goertzel_t g;
+        double frequency = h * c->frequency_hz;
+        user_spectrum_goertzel_init(&g, (uint32_t)lround(frequency * 1000.0), SP_RATE_HZ * 1000U);
+        uint16_t amplitude = user_spectrum_goertzel_run(&g, g_codes, SP_N);
+        double reference = sp_reference_goertzel(frequency);
+        int g_fail = fabs(amplitude - reference) > SP_MAX_GOERTZEL + reference * SP_MAX_GOERTZEL_PCT / 100.0;
+        printf("%s %-14s Goertzel %9.3f Hz: %u codes (ref %.2f)\n",
+               g_fail ? "FAIL" : "ok  ", c->name, frequency, (unsigned int)amplitude, reference);
+        fail |= g_fail;
+    }
+    return fail;
+}
+
+// 被测文件引用的ADC和遥测接口：本测试直接调用分析函数，不走捕获流程
+uint16_t user_adc_span_to_millivolts(uint16_t codes)
+{
+    return (uint16_t)(((uint32_t)codes * ADC_MV_PER_CODE_Q16 + 0x8000U) >> 16);
+}
+
+void user_adc_set_sample_sink(adc_sample_sink_t sink)
+{
+    (void)sink;
+}
+
+void user_adc_start_high_speed_sampling(uint32_t sample_rate_hz)
+{
+    (void)sample_rate_hz;
+}
+
+void user_adc_stop_high_speed_sampling(void)
+{
+}
+
+bool user_adc_is_sampling(void)
+{
+    return false;
+}
+
+uint32_t user_adc_last_sample_ticks(void)
+{
+    return 0;
+}
+
+uint32_t user_adc_get_late_samples(void)
+{
+    return 0;
+}
+
+void firewater_send_spectrum(const uint16_t *magnitudes, uint16_t count, uint32_t sample_rate_hz)
+{
+    (void)magnitudes;
+    (void)count;
+    (void)sample_rate_hz;
+}
+
+void firewater_send_spectrum_metrics(uint32_t frequency_mhz, uint16_t amplitude_mv,
+                                     int16_t thd_db_x10, int16_t snr_db_x10)
+{
+    (void)frequency_mhz;
+    (void)amplitude_mv;
+    (void)thd_db_x10;
+    (void)snr_db_x10;
+}
+
+void firewater_send_spectrum_tone(uint32_t frequency_mhz, uint16_t amplitude_mv, uint32_t sample_rate_hz)
+{
+    (void)frequency_mhz;
+    (void)amplitude_mv;
+    (void)sample_rate_hz;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++) {
+        failures += sp_run_case(&g_cases[i]);
+    }
+
+    printf("%s: %d failure(s)\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+/*
+ * 波形表主机测试：tools/gen_wave_tables.py生成的Flash表与原来启动时用sinf()等计算的表逐点比较
+ * 正弦经固件的dac_quarter_sine按对称性展开为整周期后比较（允许单精度sinf的1LSB舍入差），
+ * 方波、三角、锯齿和噪声须完全一致
+ *
+ * 构建（在test/host目录下）：
+ *   gcc -std=c99 -O2 -I. -I../../user -o test_wave_tables test_wave_tables.c ../../user/user_wave_tables.c host_stubs.c -lm
+ */
+#include "../../user/user_DAC.c"
+#include <math.h>
+#include <stdlib.h>
+
+#define WAVE_PI                 3.14159265358979323846
+#define WAVE_SINE_MAX_ERROR     1       // 单精度sinf与双精度生成脚本的舍入差(LSB)
+
+/**
+ * @brief 原DAC_generateSineTable：单精度sinf，lrintf取整
+ */
+static int16_t old_sine(int i)
+{
+    float angle = 2.0f * WAVE_PI * i / WAVE_TABLE_SIZE;
+    return (int16_t)lrintf(sinf(angle) * 32767.0f);
+}
+
+/**
+ * @brief 原dac_wave_sample中方波、三角、锯齿和噪声的逐点计算
+ */
+static int16_t old_wave_sample(dac_waveform_t wave, uint8_t index)
+{
+    switch (wave) {
+        case DAC_WAVE_SQUARE:
+            return (index < WAVE_TABLE_SIZE / 2) ? 32767 : -32767;
+        case DAC_WAVE_TRIANGLE: {
+            int32_t value = (index < 64) ? index * 512 :
+                            (index < 192) ? (128 - index) * 512 : (index - 256) * 512;
+            return (int16_t)((value > 32767) ? 32767 : value);
+        }
+        case DAC_WAVE_SAWTOOTH:
+            return (int16_t)(((int32_t)index - 128) * 256);
+        case DAC_WAVE_NOISE: {
+            uint32_t x = (uint32_t)(index + 1) * 2654435761U;
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            return (int16_t)(x >> 16);
+        }
+        default:
+            return 0;
+    }
+}
+
+static int check_sine(void)
+{
+    int max_error = 0;
+    int differing = 0;
+
+    for (int i = 0; i < WAVE_TABLE_SIZE; i++) {
+        int error = abs(dac_quarter_sine((uint8_t)i) - old_sine(i));
+        if (error > max_error) {
+            max_error = error;
+        }
+        if (error != 0) {
+            differing++;
+        }
+    }
+
+    int fail = (max_error > WAVE_SINE_MAX_ERROR);
+    printf("%s sine      %3d/%d points differ, max error %d LSB (limit %d)\n",
+           fail ? "FAIL" : "ok  ", differing, WAVE_TABLE_SIZE, max_error, WAVE_SINE_MAX_ERROR);
+    return fail;
+}
+
+static int check_table(const char *name, dac_waveform_t wave)
+{
+    const int16_t *table = builtin_tables[wave];
+    int differing = 0;
+
+    for (int i = 0; i < WAVE_TABLE_SIZE; i++) {
+        if (table[i] != old_wave_sample(wave, (uint8_t)i)) {
+            if (differing == 0) {
+                printf("     %s[%d] = %d, expected %d\n", name, i, table[i],
+                       old_wave_sample(wave, (uint8_t)i));
+            }
+            differing++;
+        }
+    }
+
+    printf("%s %-9s %3d/%d points differ\n", differing ? "FAIL" : "ok  ", name,
+           differing, WAVE_TABLE_SIZE);
+    return differing != 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    failures += check_sine();
+    failures += check_table("square", DAC_WAVE_SQUARE);
+    failures += check_table("triangle", DAC_WAVE_TRIANGLE);
+    failures += check_table("sawtooth", DAC_WAVE_SAWTOOTH);
+    failures += check_table("noise", DAC_WAVE_NOISE);
+
+    printf("%s: %d failure(s)\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
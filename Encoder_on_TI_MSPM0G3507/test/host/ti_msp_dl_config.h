@@ -0,0 +1,205 @@
+/*
+ * 主机测试用的ti_msp_dl_config.h替身
+ * 只提供被测源文件引用到的寄存器类型、常量和DriverLib函数，外设操作均为空操作，
+ * 使滤波、DDS、解码等纯算法代码可以在PC上编译运行（见test/host/README.md）
+ */
+#ifndef HOST_TI_MSP_DL_CONFIG_H
+#define HOST_TI_MSP_DL_CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// SysTick：基准测试函数读取VAL，主机上恒为0
+typedef struct {
+    volatile uint32_t VAL;
+    volatile uint32_t LOAD;
+} SysTick_Type;
+extern SysTick_Type host_systick;
+#define SysTick     (&host_systick)
+
+// 外设实例：只有DAC的DATA0地址被取用（DMA目的地址），其余实例仅作参数传递
+typedef struct {
+    volatile uint32_t DATA0;
+} DAC12_Regs;
+extern DAC12_Regs host_dac0;
+#define DAC0        (&host_dac0)
+#define DMA         ((void *)0)
+#define TIMG7       ((void *)0)
+#define DMA_INT_IRQn            0
+#define DMA_DAC0_EVT_BD_1_TRIG  0
+
+// 最近一次直接写入DAC的码值（斜坡等静态输出路径）
+extern volatile uint16_t host_dac_output;
+
+// NVIC
+#define NVIC_ClearPendingIRQ(irq)       ((void)(irq))
+#define NVIC_EnableIRQ(irq)             ((void)(irq))
+#define NVIC_DisableIRQ(irq)            ((void)(irq))
+#define NVIC_SetPriority(irq, pri)      ((void)(irq), (void)(pri))
+
+// DAC12
+typedef enum {
+    DL_DAC12_SAMPLES_PER_SECOND_500 = 0,
+    DL_DAC12_SAMPLES_PER_SECOND_1K,
+    DL_DAC12_SAMPLES_PER_SECOND_2K,
+    DL_DAC12_SAMPLES_PER_SECOND_4K,
+    DL_DAC12_SAMPLES_PER_SECOND_8K,
+    DL_DAC12_SAMPLES_PER_SECOND_16K,
+    DL_DAC12_SAMPLES_PER_SECOND_100K,
+    DL_DAC12_SAMPLES_PER_SECOND_200K
+} DL_DAC12_SAMPLES_PER_SECOND;
+
+enum {
+    DL_DAC12_OUTPUT_ENABLED = 1,
+    DL_DAC12_RESOLUTION_12BIT = 0,
+    DL_DAC12_REPRESENTATION_BINARY = 0,
+    DL_DAC12_VREF_SOURCE_VDDA_VSSA = 0,
+    DL_DAC12_AMP_ON = 1,
+    DL_DAC12_FIFO_ENABLED = 1,
+    DL_DAC12_FIFO_TRIGGER_SAMPLETIMER = 0,
+    DL_DAC12_FIFO_TRIGGER_HWTRIG0 = 1,
+    DL_DAC12_DMA_TRIGGER_DISABLED = 0,
+    DL_DAC12_DMA_TRIGGER_ENABLED = 1,
+    DL_DAC12_FIFO_THRESHOLD_ONE_QTR_EMPTY = 0,
+    DL_DAC12_FIFO_THRESHOLD_TWO_QTRS_EMPTY = 1,
+    DL_DAC12_FIFO_THRESHOLD_THREE_QTRS_EMPTY = 2,
+    DL_DAC12_SAMPLETIMER_DISABLE = 0,
+    DL_DAC12_SAMPLETIMER_ENABLE = 1,
+    DL_DAC12_SUBSCRIBER_INDEX_0 = 0,
+    DL_DAC12_INTERRUPT_FIFO_EMPTY = 0x1,
+    DL_DAC12_INTERRUPT_FIFO_ONE_QTR_EMPTY = 0x2
+};
+
+typedef struct {
+    uint32_t outputEnable;
+    uint32_t resolution;
+    uint32_t representation;
+    uint32_t voltageReferenceSource;
+    uint32_t amplifierSetting;
+    uint32_t fifoEnable;
+    uint32_t fifoTriggerSource;
+    uint32_t dmaTriggerEnable;
+    uint32_t dmaTriggerThreshold;
+    uint32_t sampleTimeGeneratorEnable;
+    DL_DAC12_SAMPLES_PER_SECOND sampleRate;
+} DL_DAC12_Config;
+
+#define DL_DAC12_init(inst, config)                     ((void)(inst), (void)(config))
+#define DL_DAC12_enable(inst)                           ((void)(inst))
+#define DL_DAC12_disable(inst)                          ((void)(inst))
+#define DL_DAC12_isEnabled(inst)                        ((void)(inst), true)
+#define DL_DAC12_output12(inst, value)                  ((void)(inst), host_dac_output = (uint16_t)(value))
+#define DL_DAC12_isFIFOFull(inst)                       ((void)(inst), true)
+#define DL_DAC12_enableSampleTimeGenerator(inst)        ((void)(inst))
+#define DL_DAC12_disableSampleTimeGenerator(inst)       ((void)(inst))
+#define DL_DAC12_isSampleTimeGeneratorEnabled(inst)     ((void)(inst), true)
+#define DL_DAC12_enableInterrupt(inst, mask)            ((void)(inst), (void)(mask))
+#define DL_DAC12_disableInterrupt(inst, mask)           ((void)(inst), (void)(mask))
+#define DL_DAC12_clearInterruptStatus(inst, mask)       ((void)(inst), (void)(mask))
+#define DL_DAC12_getInterruptStatus(inst, mask)         ((void)(inst), (void)(mask), 0U)
+#define DL_DAC12_getRawInterruptStatus(inst, mask)      ((void)(inst), (void)(mask), 0U)
+#define DL_DAC12_setSubscriberChanID(inst, index, id)   ((void)(inst), (void)(index), (void)(id))
+
+// DMA（地址参数在主机上是64位指针，宏中丢弃不求值）
+enum {
+    DL_DMA_FULL_CH_REPEAT_SINGLE_TRANSFER_MODE = 0,
+    DL_DMA_NORMAL_MODE = 0,
+    DL_DMA_ADDR_UNCHANGED = 0,
+    DL_DMA_ADDR_INCREMENT = 1,
+    DL_DMA_WIDTH_HALF_WORD = 1,
+    DL_DMA_TRIGGER_TYPE_EXTERNAL = 1,
+    DL_DMA_EARLY_INTERRUPT_THRESHOLD_HALF = 0,
+    DL_DMA_INTERRUPT_CHANNEL0 = 0x1,
+    DL_DMA_FULL_CH_INTERRUPT_EARLY_CHANNEL0 = 0x2,
+    DL_DMA_EVENT_IIDX_DMACH0 = 1,
+    DL_DMA_FULL_CH_EVENT_IIDX_EARLY_IRQ_DMACH0 = 2
+};
+
+typedef struct {
+    uint32_t transferMode;
+    uint32_t extendedMode;
+    uint32_t destIncrement;
+    uint32_t srcIncrement;
+    uint32_t destWidth;
+    uint32_t srcWidth;
+    uint32_t trigger;
+    uint32_t triggerType;
+} DL_DMA_Config;
+
+#define DL_DMA_initChannel(dma, ch, config)             ((void)(dma), (void)(ch), (void)(config))
+#define DL_DMA_setSrcAddr(dma, ch, addr)                ((void)(dma), (void)(ch))
+#define DL_DMA_setDestAddr(dma, ch, addr)               ((void)(dma), (void)(ch))
+#define DL_DMA_setTransferSize(dma, ch, size)           ((void)(dma), (void)(ch), (void)(size))
+#define DL_DMA_getTransferSize(dma, ch)                 ((void)(dma), (void)(ch), 0U)
+#define DL_DMA_enableChannel(dma, ch)                   ((void)(dma), (void)(ch))
+#define DL_DMA_disableChannel(dma, ch)                  ((void)(dma), (void)(ch))
+#define DL_DMA_enableInterrupt(dma, mask)               ((void)(dma), (void)(mask))
+#define DL_DMA_getPendingInterrupt(dma)                 ((void)(dma), 0U)
+#define DL_DMA_Full_Ch_setEarlyInterruptThreshold(dma, ch, th)  ((void)(dma), (void)(ch), (void)(th))
+
+// TimerG
+enum {
+    DL_TIMER_CLOCK_BUSCLK = 0,
+    DL_TIMER_CLOCK_DIVIDE_1 = 0,
+    DL_TIMER_TIMER_MODE_PERIODIC = 0,
+    DL_TIMER_STOP = 0,
+    DL_TIMER_EVENT_ROUTE_1 = 0,
+    DL_TIMER_EVENT_ZERO_EVENT = 0,
+    DL_TIMER_PUBLISHER_INDEX_0 = 0
+};
+
+typedef struct {
+    uint32_t clockSel;
+    uint32_t divideRatio;
+    uint8_t prescale;
+} DL_TimerG_ClockConfig;
+
+typedef struct {
+    uint32_t period;
+    uint32_t timerMode;
+    uint32_t startTimer;
+} DL_TimerG_TimerConfig;
+
+#define DL_TimerG_reset(timer)                          ((void)(timer))
+#define DL_TimerG_enablePower(timer)                    ((void)(timer))
+#define DL_TimerG_disablePower(timer)                   ((void)(timer))
+#define DL_TimerG_setClockConfig(timer, config)         ((void)(timer), (void)(config))
+#define DL_TimerG_initTimerMode(timer, config)          ((void)(timer), (void)(config))
+#define DL_TimerG_enableClock(timer)                    ((void)(timer))
+#define DL_TimerG_startCounter(timer)                   ((void)(timer))
+#define DL_TimerG_stopCounter(timer)                    ((void)(timer))
+#define DL_TimerG_enableEvent(timer, route, event)      ((void)(timer), (void)(route), (void)(event))
+#define DL_TimerG_setPublisherChanID(timer, index, id)  ((void)(timer), (void)(index), (void)(id))
+
+// GPIO：编码器引脚电平由测试写入host_gpio_pins，配置和中断操作为空操作
+extern volatile uint32_t host_gpio_pins;
+#define GPIOA                           ((void *)0)
+#define GPIOA_INT_IRQn                  0
+#define DL_GPIO_PIN_17                  (0x00020000U)
+#define DL_GPIO_PIN_24                  (0x01000000U)
+#define IOMUX_PINCM39                   38
+#define IOMUX_PINCM54                   53
+#define ENCODER_PORT                    (GPIOA)
+#define ENCODER_INT_IRQN                (GPIOA_INT_IRQn)
+#define ENCODER_PIN_A_PIN               (DL_GPIO_PIN_17)
+#define ENCODER_PIN_B_PIN               (DL_GPIO_PIN_24)
+
+enum {
+    DL_GPIO_INVERSION_DISABLE = 0,
+    DL_GPIO_RESISTOR_PULL_UP = 0,
+    DL_GPIO_HYSTERESIS_DISABLE = 0,
+    DL_GPIO_WAKEUP_DISABLE = 0,
+    DL_GPIO_PIN_17_EDGE_RISE_FALL = 0,
+    DL_GPIO_PIN_24_EDGE_RISE_FALL = 0
+};
+
+#define DL_GPIO_initDigitalInputFeatures(iomux, inv, res, hys, wake) \
+    ((void)(iomux), (void)(inv), (void)(res), (void)(hys), (void)(wake))
+#define DL_GPIO_setUpperPinsPolarity(port, polarity)    ((void)(port), (void)(polarity))
+#define DL_GPIO_clearInterruptStatus(port, pins)        ((void)(port), (void)(pins))
+#define DL_GPIO_enableInterrupt(port, pins)             ((void)(port), (void)(pins))
+#define DL_GPIO_disableInterrupt(port, pins)            ((void)(port), (void)(pins))
+#define DL_GPIO_readPins(port, pins)                    ((void)(port), host_gpio_pins & (pins))
+
+#endif /* HOST_TI_MSP_DL_CONFIG_H */
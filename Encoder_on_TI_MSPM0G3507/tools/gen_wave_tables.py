@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""生成DAC内置波形表（Q15，一个周期WAVE_TABLE_SIZE点），输出到user/user_wave_tables.c/.h
+
+用法: python tools/gen_wave_tables.py
+修改表格式或波形后重新运行并提交生成的文件，固件启动时不再计算。
+"""
+
+import math
+import os
+
+TABLE_SIZE = 256
+QUARTER_SIZE = TABLE_SIZE // 4
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+OUT_C = os.path.join(ROOT, "user", "user_wave_tables.c")
+OUT_H = os.path.join(ROOT, "user", "user_wave_tables.h")
+
+
+def quarter_sine():
+    # 四分之一周期（含两端点，WAVE_QUARTER_SIZE+1点），固件按对称性展开为整周期
+    return [int(round(math.sin(2.0 * math.pi * i / TABLE_SIZE) * 32767.0))
+            for i in range(QUARTER_SIZE + 1)]
+
+
+def square():
+    return [32767 if i < TABLE_SIZE // 2 else -32767 for i in range(TABLE_SIZE)]
+
+
+def triangle():
+    # 与正弦同相：0点为0，1/4周期为正峰，3/4周期为负峰
+    table = []
+    for i in range(TABLE_SIZE):
+        if i < 64:
+            value = i * 512
+        elif i < 192:
+            value = (128 - i) * 512
+        else:
+            value = (i - 256) * 512
+        table.append(min(value, 32767))
+    return table
+
+
+def sawtooth():
+    return [(i - 128) * 256 for i in range(TABLE_SIZE)]
+
+
+def noise():
+    # 由索引散列得到的固定伪随机序列（xorshift32）
+    table = []
+    for i in range(TABLE_SIZE):
+        x = ((i + 1) * 2654435761) & 0xFFFFFFFF
+        x ^= (x << 13) & 0xFFFFFFFF
+        x ^= x >> 17
+        x ^= (x << 5) & 0xFFFFFFFF
+        value = x >> 16
+        table.append(value - 0x10000 if value >= 0x8000 else value)
+    return table
+
+
+TABLES = [
+    ("g_wave_quarter_sine_q15", "WAVE_QUARTER_SIZE + 1", "正弦（四分之一周期）", quarter_sine),
+    ("g_wave_square_q15", "WAVE_TABLE_SIZE", "方波", square),
+    ("g_wave_triangle_q15", "WAVE_TABLE_SIZE", "三角波", triangle),
+    ("g_wave_sawtooth_q15", "WAVE_TABLE_SIZE", "锯齿波", sawtooth),
+    ("g_wave_noise_q15", "WAVE_TABLE_SIZE", "伪随机噪声", noise),
+]
+
+
+def format_table(name, size, title, values):
+    lines = ["// %s" % title, "const int16_t %s[%s] = {" % (name, size)]
+    for start in range(0, len(values), 8):
+        row = ", ".join("%6d" % v for v in values[start:start + 8])
+        lines.append("    %s," % row)
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def write(path, text):
+    with open(path, "w", encoding="utf-8", newline="\r\n") as f:
+        f.write(text)
+
+
+def main():
+    header = [
+        "#ifndef USER_WAVE_TABLES_H",
+        "#define USER_WAVE_TABLES_H",
+        "",
+        "// 由tools/gen_wave_tables.py生成，请勿手工修改",
+        "",
+        "#include \"user_DAC.h\"",
+        "#include <stdint.h>",
+        "",
+        "#ifdef __cplusplus",
+        "extern \"C\" {",
+        "#endif",
+        "",
+    ]
+    for name, size, title, _ in TABLES:
+        header.append("extern const int16_t %s[%s];   // %s" % (name, size, title))
+    header += ["", "#ifdef __cplusplus", "}", "#endif", "", "#endif /* USER_WAVE_TABLES_H */", ""]
+
+    source = [
+        "// 由tools/gen_wave_tables.py生成，请勿手工修改",
+        "// 内置波形表（Q15，一个周期%d点，正弦只存四分之一周期），const存放于Flash" % TABLE_SIZE,
+        "",
+        "#include \"user_wave_tables.h\"",
+        "",
+    ]
+    for name, size, title, generator in TABLES:
+        values = generator()
+        assert all(-32768 <= v <= 32767 for v in values)
+        source.append(format_table(name, size, title, values))
+        source.append("")
+
+    write(OUT_H, "\n".join(header))
+    write(OUT_C, "\n".join(source))
+
+
+if __name__ == "__main__":
+    main()
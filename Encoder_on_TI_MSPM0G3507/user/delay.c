@@ -50,6 +50,18 @@ uint32_t get_system_time_ms(void)
     return system_time_ms;
 }
 
+/**
+ * @brief 计算两次SysTick计数值之间经过的CPU周期数
+ * @param start 起始时读取的SysTick->VAL
+ * @param end 结束时读取的SysTick->VAL
+ * @return 经过的CPU周期数
+ */
+uint32_t get_elapsed_cycles(uint32_t start, uint32_t end)
+{
+    uint32_t period = SysTick->LOAD + 1;
+    return (start >= end) ? (start - end) : (start + period - end);
+}
+
 /**
  * @brief 微秒级延时函数
  * @param us 延时时间，单位：微秒
@@ -43,6 +43,15 @@ void delay_cycles(unsigned int cycles);
  */
 uint32_t get_system_time_ms(void);
 
+/**
+ * @brief 计算两次SysTick计数值之间经过的CPU周期数
+ * @param start 起始时读取的SysTick->VAL
+ * @param end 结束时读取的SysTick->VAL
+ * @return 经过的CPU周期数
+ * @note SysTick为向下计数，测量区间需小于1个SysTick周期(1ms)
+ */
+uint32_t get_elapsed_cycles(uint32_t start, uint32_t end);
+
 
 /**
  * @brief SysTick定时器中断服务函数
@@ -1,6 +1,7 @@
 #include "firewater_protocol.h"
 #include "user_uart.h"
 #include "delay.h"
+#include "user_ADC.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -109,6 +110,220 @@ void firewater_send_adc_batch(float *voltages, uint8_t count, uint32_t start_sam
     }
 }
 
+/**
+ * @brief 发送ADC电压数据（定点版本，输入为毫伏）
+ * 输出格式与firewater_send_adc_voltage_simple一致（2位小数），但不依赖浮点printf
+ */
+void firewater_send_adc_millivolts(uint16_t millivolts) {
+    char buffer[16];
+    uint32_t centivolts = ((uint32_t)millivolts + 5) / 10;  // 四舍五入到0.01V
+    snprintf(buffer, sizeof(buffer), "%u.%02u\n",
+             (unsigned int)(centivolts / 100), (unsigned int)(centivolts % 100));
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送ADC批量原始码值（每个数据单独一行发送）
+ */
+void firewater_send_adc_batch_raw(const uint16_t *raw_values, uint8_t count, uint32_t start_sample_id) {
+    (void)start_sample_id;
+    for (uint8_t i = 0; i < count; i++) {
+        firewater_send_adc_millivolts(user_adc_raw_to_millivolts(raw_values[i]));
+    }
+}
+
+/**
+ * @brief 发送示波器捕获帧头
+ * 格式: "scope:pre,post,trigger_id\n"
+ */
+void firewater_send_scope_header(uint16_t pre_samples, uint16_t post_samples, uint32_t trigger_id) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "scope:%u,%u,%u\n",
+             (unsigned int)pre_samples, (unsigned int)post_samples, (unsigned int)trigger_id);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送窗口统计帧
+ * 格式: "stats:name,mean,rms,min,max,pp\n"，每个窗口一行；rms含直流分量
+ */
+void firewater_send_stats(const char *name, int32_t mean, int32_t rms,
+                          int32_t min, int32_t max, int32_t peak_to_peak) {
+    char buffer[80];
+    snprintf(buffer, sizeof(buffer), "stats:%s,%ld,%ld,%ld,%ld,%ld\n",
+             (name != NULL) ? name : "", (long)mean, (long)rms,
+             (long)min, (long)max, (long)peak_to_peak);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送频谱帧
+ * 格式: "spec:fs,count,m0,m1,...\n"，逐段发送避免大缓冲区
+ */
+void firewater_send_spectrum(const uint16_t *magnitudes, uint16_t count, uint32_t sample_rate_hz) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "spec:%lu,%u",
+             (unsigned long)sample_rate_hz, (unsigned int)count);
+    user_uart_send_string(buffer);
+    for (uint16_t i = 0; i < count; i++) {
+        snprintf(buffer, sizeof(buffer), ",%u", (unsigned int)magnitudes[i]);
+        user_uart_send_string(buffer);
+    }
+    user_uart_send_string("\n");
+}
+
+/**
+ * @brief 发送频谱测量结果帧
+ * 格式: "specm:freq_mHz,amp_mV,thd_dBx10,snr_dBx10\n"
+ */
+void firewater_send_spectrum_metrics(uint32_t frequency_mhz, uint16_t amplitude_mv,
+                                     int16_t thd_db_x10, int16_t snr_db_x10) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "specm:%lu,%u,%d,%d\n",
+             (unsigned long)frequency_mhz, (unsigned int)amplitude_mv,
+             (int)thd_db_x10, (int)snr_db_x10);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送单频检测结果帧
+ * 格式: "spect:frequency_mhz,amplitude_mv,sample_rate_hz\n"
+ */
+void firewater_send_spectrum_tone(uint32_t frequency_mhz, uint16_t amplitude_mv, uint32_t sample_rate_hz) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "spect:%lu,%u,%lu\n",
+             (unsigned long)frequency_mhz, (unsigned int)amplitude_mv, (unsigned long)sample_rate_hz);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送ADC阈值告警事件帧
+ * 格式: "alarm:type,mV,timestamp_ms,load_cut\n"
+ */
+void firewater_send_alarm(const char *type, uint16_t millivolts, uint32_t timestamp_ms, bool load_cut) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "alarm:%s,%u,%lu,%u\n",
+             (type != NULL) ? type : "", (unsigned int)millivolts,
+             (unsigned long)timestamp_ms, load_cut ? 1U : 0U);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送ADC阈值告警状态帧（与告警事件帧区分，使用单独的标签）
+ * 格式: "alarmcfg:enabled,low_mV,high_mV,tripped,dropped\n"
+ */
+void firewater_send_alarm_status(bool enabled, uint16_t low_mv, uint16_t high_mv, bool tripped,
+                                 uint32_t dropped) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "alarmcfg:%u,%u,%u,%u,%lu\n",
+             enabled ? 1U : 0U, (unsigned int)low_mv, (unsigned int)high_mv,
+             tripped ? 1U : 0U, (unsigned long)dropped);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送数据块时间戳帧
+ * 格式: "ts:start_sample_id,timestamp_us\n"
+ */
+void firewater_send_block_timestamp(uint32_t start_sample_id, uint32_t timestamp_us) {
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "ts:%lu,%lu\n",
+             (unsigned long)start_sample_id, (unsigned long)timestamp_us);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送采样间隔直方图帧
+ * 格式: "jitter:name,nominal,width,count,min,max,under,b0,...,bN,over\n"，逐段发送
+ */
+void firewater_send_jitter(const char *name, uint32_t nominal_us, uint32_t bin_width_us,
+                           uint32_t count, uint32_t min_us, uint32_t max_us, uint32_t underflow,
+                           const uint32_t *bins, uint8_t bin_count, uint32_t overflow) {
+    char buffer[96];
+    snprintf(buffer, sizeof(buffer), "jitter:%s,%lu,%lu,%lu,%lu,%lu,%lu",
+             (name != NULL) ? name : "", (unsigned long)nominal_us, (unsigned long)bin_width_us,
+             (unsigned long)count, (unsigned long)min_us, (unsigned long)max_us,
+             (unsigned long)underflow);
+    user_uart_send_string(buffer);
+    for (uint8_t i = 0; i < bin_count; i++) {
+        snprintf(buffer, sizeof(buffer), ",%lu", (unsigned long)bins[i]);
+        user_uart_send_string(buffer);
+    }
+    snprintf(buffer, sizeof(buffer), ",%lu\n", (unsigned long)overflow);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送同步功率测量帧
+ */
+void firewater_send_power_record(int32_t voltage_mv, int32_t current_ma, int32_t instant_power_mw,
+                                 int32_t real_power_mw, int64_t energy_mj) {
+    char buffer[80];
+    // 能量为64位：long在M0+上只有32位，1W时约25天即超出其范围，用%lld完整输出
+    snprintf(buffer, sizeof(buffer), "pwr:%ld,%ld,%ld,%ld,%lld\n",
+             (long)voltage_mv, (long)current_ma, (long)instant_power_mw,
+             (long)real_power_mw, (long long)energy_mj);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送参考漂移补偿状态帧
+ */
+void firewater_send_drift(uint16_t vdda_mv, uint16_t baseline_mv, int32_t temperature_dc,
+                          uint32_t scale_q16, uint32_t rejected) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "drift:%u,%u,%ld,%lu,%lu\n",
+             (unsigned int)vdda_mv, (unsigned int)baseline_mv, (long)temperature_dc,
+             (unsigned long)scale_q16, (unsigned long)rejected);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送DAC设定值斜坡状态帧
+ */
+void firewater_send_ramp(uint16_t output_mv, uint16_t target_mv, uint8_t progress_percent,
+                         uint16_t slew_mv_per_ms) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "ramp:%u,%u,%u,%u\n",
+             (unsigned int)output_mv, (unsigned int)target_mv,
+             (unsigned int)progress_percent, (unsigned int)slew_mv_per_ms);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送闭环稳压状态帧
+ */
+void firewater_send_regulator(uint16_t target_mv, uint16_t measured_mv, int32_t trim_codes,
+                              int16_t overshoot_mv, uint32_t settle_ms, uint32_t saturations) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "reg:%u,%u,%ld,%d,%lu,%lu\n",
+             (unsigned int)target_mv, (unsigned int)measured_mv, (long)trim_codes,
+             (int)overshoot_mv, (unsigned long)settle_ms, (unsigned long)saturations);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送编码器状态帧
+ */
+void firewater_send_encoder(int16_t count, uint8_t counts_per_detent, uint32_t glitches) {
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "encoder:%d,%u,%lu\n",
+             (int)count, (unsigned int)counts_per_detent, (unsigned long)glitches);
+    user_uart_send_string(buffer);
+}
+
+/**
+ * @brief 发送DAC波形引擎健康帧
+ */
+void firewater_send_dac_health(uint32_t refills, uint32_t underruns, uint32_t late_refills,
+                               uint32_t max_latency_us) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "health:dac,%lu,%lu,%lu,%lu\n",
+             (unsigned long)refills, (unsigned long)underruns,
+             (unsigned long)late_refills, (unsigned long)max_latency_us);
+    user_uart_send_string(buffer);
+}
+
 /**
  * @brief 测试VOFA+数据发送连接
  */
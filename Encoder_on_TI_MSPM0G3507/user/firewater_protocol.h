@@ -71,6 +71,172 @@ void firewater_send_adc_voltage_simple(float voltage);
  */
 void firewater_send_adc_batch(float *voltages, uint8_t count, uint32_t start_sample_id);
 
+/**
+ * @brief 发送ADC电压数据（定点版本，输入为毫伏）
+ * @param millivolts 电压值(mV)
+ */
+void firewater_send_adc_millivolts(uint16_t millivolts);
+
+/**
+ * @brief 发送ADC批量原始码值，发送时才按定点方式换算为电压
+ * @param raw_values 原始码值数组
+ * @param count 数据个数
+ * @param start_sample_id 起始采样ID
+ */
+void firewater_send_adc_batch_raw(const uint16_t *raw_values, uint8_t count, uint32_t start_sample_id);
+
+/**
+ * @brief 发送示波器捕获帧头，随后的数据行为捕获样本
+ * @param pre_samples 触发前样本数
+ * @param post_samples 触发后样本数
+ * @param trigger_id 触发点对应的采样ID
+ */
+void firewater_send_scope_header(uint16_t pre_samples, uint16_t post_samples, uint32_t trigger_id);
+
+/**
+ * @brief 发送窗口统计帧
+ * @param name 通道名称
+ * @param mean 平均值
+ * @param rms 均方根（含直流分量）
+ * @param min 最小值
+ * @param max 最大值
+ * @param peak_to_peak 峰峰值
+ */
+void firewater_send_stats(const char *name, int32_t mean, int32_t rms,
+                          int32_t min, int32_t max, int32_t peak_to_peak);
+
+/**
+ * @brief 发送频谱帧（各频点幅度）
+ * @param magnitudes 频点幅度数组（FFT输出幅度，与ADC码值同量纲）
+ * @param count 频点数
+ * @param sample_rate_hz 采样率，上位机据此换算频率轴
+ */
+void firewater_send_spectrum(const uint16_t *magnitudes, uint16_t count, uint32_t sample_rate_hz);
+
+/**
+ * @brief 发送频谱测量结果帧
+ * @param frequency_mhz 基波频率(mHz)
+ * @param amplitude_mv 基波幅度(mV)
+ * @param thd_db_x10 总谐波失真(0.1dB)
+ * @param snr_db_x10 信噪比(0.1dB)
+ */
+void firewater_send_spectrum_metrics(uint32_t frequency_mhz, uint16_t amplitude_mv,
+                                     int16_t thd_db_x10, int16_t snr_db_x10);
+
+/**
+ * @brief 发送单频检测结果帧
+ * @param frequency_mhz 检测频率(mHz)
+ * @param amplitude_mv 该频率分量的幅度（峰值，mV）
+ * @param sample_rate_hz 实测采样率
+ */
+void firewater_send_spectrum_tone(uint32_t frequency_mhz, uint16_t amplitude_mv, uint32_t sample_rate_hz);
+
+/**
+ * @brief 发送ADC阈值告警事件帧
+ * @param type 告警类型名称（"high"/"low"）
+ * @param millivolts 触发告警的转换结果(mV)
+ * @param timestamp_ms 告警时刻(ms)
+ * @param load_cut 是否已执行快速切断负载
+ */
+void firewater_send_alarm(const char *type, uint16_t millivolts, uint32_t timestamp_ms, bool load_cut);
+
+/**
+ * @brief 发送ADC阈值告警状态帧
+ * @param enabled 告警是否启用
+ * @param low_mv 下限(mV)
+ * @param high_mv 上限(mV)
+ * @param tripped 负载是否已被切断
+ * @param dropped 因队列满而丢弃的事件数
+ */
+void firewater_send_alarm_status(bool enabled, uint16_t low_mv, uint16_t high_mv, bool tripped,
+                                 uint32_t dropped);
+
+/**
+ * @brief 发送数据块时间戳帧（紧随其后的批量数据从start_sample_id开始）
+ * @param start_sample_id 块内第一个样本的采样ID
+ * @param timestamp_us 块内第一个样本的微秒时间戳
+ */
+void firewater_send_block_timestamp(uint32_t start_sample_id, uint32_t timestamp_us);
+
+/**
+ * @brief 发送采样间隔直方图帧
+ * @param name 直方图名称
+ * @param nominal_us 标称间隔(us)
+ * @param bin_width_us 每格宽度(us)
+ * @param count 间隔总数
+ * @param min_us 最小间隔(us)
+ * @param max_us 最大间隔(us)
+ * @param underflow 低于直方图下界的个数
+ * @param bins 各格计数
+ * @param bin_count 格数
+ * @param overflow 高于直方图上界的个数
+ */
+void firewater_send_jitter(const char *name, uint32_t nominal_us, uint32_t bin_width_us,
+                           uint32_t count, uint32_t min_us, uint32_t max_us, uint32_t underflow,
+                           const uint32_t *bins, uint8_t bin_count, uint32_t overflow);
+
+/**
+ * @brief 发送同步功率测量帧
+ * @param voltage_mv 窗口平均电压(mV)
+ * @param current_ma 窗口平均电流(mA)
+ * @param instant_power_mw 瞬时功率(mW)
+ * @param real_power_mw 有功功率(mW)
+ * @param energy_mj 累计能量(mJ)
+ */
+void firewater_send_power_record(int32_t voltage_mv, int32_t current_ma, int32_t instant_power_mw,
+                                 int32_t real_power_mw, int64_t energy_mj);
+
+/**
+ * @brief 发送参考漂移补偿状态帧
+ * @param vdda_mv 当前VDDA估计(mV)，0表示尚未测得
+ * @param baseline_mv ADC增益对应的VDDA(mV)
+ * @param temperature_dc 芯片温度(0.1°C)
+ * @param scale_q16 当前修正系数(Q16)
+ * @param rejected 超出范围被丢弃的估计数
+ */
+void firewater_send_drift(uint16_t vdda_mv, uint16_t baseline_mv, int32_t temperature_dc,
+                          uint32_t scale_q16, uint32_t rejected);
+
+/**
+ * @brief 发送DAC设定值斜坡状态帧
+ * @param output_mv 当前输出(mV)
+ * @param target_mv 目标电压(mV)
+ * @param progress_percent 本段斜坡进度 (0 ~ 100)
+ * @param slew_mv_per_ms 压摆率(mV/ms)，0为不限速
+ */
+void firewater_send_ramp(uint16_t output_mv, uint16_t target_mv, uint8_t progress_percent,
+                         uint16_t slew_mv_per_ms);
+
+/**
+ * @brief 发送闭环稳压状态帧
+ * @param target_mv 目标电压(mV)
+ * @param measured_mv 测量电压(mV)
+ * @param trim_codes 当前DAC微调量（码值）
+ * @param overshoot_mv 本次阶跃的超调量(mV)
+ * @param settle_ms 本次阶跃的稳定时间(ms)，尚未稳定时为0
+ * @param saturations 开启以来输出限幅的周期数
+ */
+void firewater_send_regulator(uint16_t target_mv, uint16_t measured_mv, int32_t trim_codes,
+                              int16_t overshoot_mv, uint32_t settle_ms, uint32_t saturations);
+
+/**
+ * @brief 发送编码器状态帧
+ * @param count 当前计数值
+ * @param counts_per_detent 每个定位格的计数值(1/2/4)
+ * @param glitches GPIO解码丢弃的非法转移数（QEI模式下为0）
+ */
+void firewater_send_encoder(int16_t count, uint8_t counts_per_detent, uint32_t glitches);
+
+/**
+ * @brief 发送DAC波形引擎健康帧
+ * @param refills 补充次数
+ * @param underruns FIFO取空次数
+ * @param late_refills DMA回绕到待补充半块的次数
+ * @param max_latency_us 最大补充延迟(us)
+ */
+void firewater_send_dac_health(uint32_t refills, uint32_t underruns, uint32_t late_refills,
+                               uint32_t max_latency_us);
+
 /**
  * @brief 测试VOFA+数据发送连接
  */
@@ -1,6 +1,11 @@
 #include "user_ADC.h"
 #include "delay.h"
 #include "firewater_protocol.h"  // 引入firewater协议
+#include "user_filter.h"
+#include "user_adc_alarm.h"
+#include "user_timestamp.h"
+#include "user_uart.h"
+#include <stdio.h>
 #include <string.h>
 
 // 全局变量定义
@@ -10,9 +15,66 @@ volatile bool gCheckADC = false;  // ADC采集成功标志位
 static volatile bool g_adc_sampling_active = false;    // 采样激活标志
 static uint32_t g_sample_rate = 0;                     // 采样频率
 static uint32_t g_adc_sample_counter = 0;              // 采样计数器
-static float g_voltage_buffer[ADC_MAX_BATCH_SIZE];     // 电压数据缓冲区
+static uint16_t g_raw_buffer[ADC_MAX_BATCH_SIZE];      // 原始码值缓冲区（按需再换算电压）
 static uint8_t g_buffer_index = 0;                     // 缓冲区索引
 static uint8_t g_batch_size = 10;                      // 批处理大小
+static adc_sample_sink_t g_sample_sink = NULL;         // 样本接收函数（NULL时走批量发送）
+static uint32_t g_block_timestamp_us = 0;              // 当前批次第一个样本的时间戳
+static jitter_histogram_t g_hs_jitter;                 // 高速采样间隔直方图
+static uint32_t g_sample_period_ticks = 0;             // 采样周期（时间戳定时器计数）
+static uint32_t g_next_sample_ticks = 0;               // 下一个采样时刻
+static uint32_t g_last_sample_ticks = 0;               // 最近一个样本的采样时刻
+static uint32_t g_late_samples = 0;                    // 主循环阻塞而错过的采样时刻数
+
+// 异步请求槽位与先进先出队列
+typedef struct {
+    volatile uint8_t state;                // adc_request_state_t
+    adc_channel_t channel;                 // 请求通道
+    uint8_t samples;                       // 平均次数
+    volatile uint8_t remaining;            // 剩余转换次数
+    uint32_t sum;                          // 转换结果累加
+    uint16_t result;                       // 平均后的码值
+    adc_request_callback_t callback;       // 完成回调（NULL时由调用者查询）
+    void *context;                         // 回调参数
+} adc_request_t;
+
+static adc_request_t g_requests[ADC_REQUEST_QUEUE_SIZE];
+static int8_t g_request_fifo[ADC_REQUEST_QUEUE_SIZE];  // 等待中的句柄，按提交顺序
+static volatile uint8_t g_fifo_head = 0;               // 出队位置
+static volatile uint8_t g_fifo_count = 0;              // 等待中的请求数
+static volatile int8_t g_active_request = ADC_REQUEST_INVALID;  // 正在转换的请求
+static volatile bool g_async_hold = false;             // 阻塞读取期间暂停启动新请求
+
+// 码值换算系数（默认为理想3.3V参考，校准后由user_adc_set_calibration更新）
+// 实际使用的增益 = 校准增益 x 参考电压修正系数，两者任一变化时重新计算，换算热路径不变
+static uint32_t g_cal_mv_per_code_q16 = ADC_MV_PER_CODE_Q16;
+static uint32_t g_ref_scale_q16 = ADC_REF_SCALE_ONE_Q16;
+static uint32_t g_mv_per_code_q16 = ADC_MV_PER_CODE_Q16;
+static int32_t g_mv_offset_q16 = ADC_MV_OFFSET_Q16;
+
+// 各通道对应的转换存储器、起始地址和结果中断
+typedef struct {
+    uint32_t mem;
+    uint32_t start_address;
+    uint32_t interrupt;
+} adc_channel_map_t;
+
+static const adc_channel_map_t g_channel_map[ADC_CHANNEL_MAX] = {
+    {DL_ADC12_MEM_IDX_0, DL_ADC12_SEQ_START_ADDR_00, DL_ADC12_INTERRUPT_MEM0_RESULT_LOADED},
+    {DL_ADC12_MEM_IDX_1, DL_ADC12_SEQ_START_ADDR_01, DL_ADC12_INTERRUPT_MEM1_RESULT_LOADED},
+    {DL_ADC12_MEM_IDX_2, DL_ADC12_SEQ_START_ADDR_02, DL_ADC12_INTERRUPT_MEM2_RESULT_LOADED},
+};
+
+// 内部参考：1.4V，供电源监测和温度传感器通道使用
+static const DL_VREF_Config g_vref_config = {
+    .vrefEnable     = DL_VREF_ENABLE_ENABLE,
+    .bufConfig      = DL_VREF_BUFCONFIG_OUTPUT_1_4V,
+    .shModeEnable   = DL_VREF_SHMODE_DISABLE,
+    .holdCycleCount = DL_VREF_HOLD_MIN_DELAY,
+    .shCycleCount   = DL_VREF_SH_MIN_DELAY,
+};
+
+static void adc_async_start_next(void);
 
 /**
  * @brief 初始化ADC模块
@@ -28,7 +90,24 @@ void user_adc_init(void)
     // 确保ADC已启用
     DL_ADC12_enablePower(ADC12_0_INST);
     
-    // 等待ADC稳定
+    // 内部参考上电，配置内部通道（SysConfig只配置了MEM0）
+    DL_VREF_enablePower(VREF);
+    DL_VREF_configReference(VREF, (DL_VREF_Config *)&g_vref_config);
+    DL_ADC12_disableConversions(ADC12_0_INST);
+    DL_ADC12_configConversionMem(ADC12_0_INST, DL_ADC12_MEM_IDX_1, ADC_SUPPLY_INPUT_CHANNEL,
+        DL_ADC12_REFERENCE_VOLTAGE_INTREF, DL_ADC12_SAMPLE_TIMER_SOURCE_SCOMP0,
+        DL_ADC12_AVERAGING_MODE_DISABLED, DL_ADC12_BURN_OUT_SOURCE_DISABLED,
+        DL_ADC12_TRIGGER_MODE_AUTO_NEXT, DL_ADC12_WINDOWS_COMP_MODE_DISABLED);
+    DL_ADC12_configConversionMem(ADC12_0_INST, DL_ADC12_MEM_IDX_2, ADC_TEMP_INPUT_CHANNEL,
+        DL_ADC12_REFERENCE_VOLTAGE_INTREF, DL_ADC12_SAMPLE_TIMER_SOURCE_SCOMP0,
+        DL_ADC12_AVERAGING_MODE_DISABLED, DL_ADC12_BURN_OUT_SOURCE_DISABLED,
+        DL_ADC12_TRIGGER_MODE_AUTO_NEXT, DL_ADC12_WINDOWS_COMP_MODE_DISABLED);
+    DL_ADC12_clearInterruptStatus(ADC12_0_INST,
+        DL_ADC12_INTERRUPT_MEM1_RESULT_LOADED | DL_ADC12_INTERRUPT_MEM2_RESULT_LOADED);
+    DL_ADC12_enableInterrupt(ADC12_0_INST,
+        DL_ADC12_INTERRUPT_MEM1_RESULT_LOADED | DL_ADC12_INTERRUPT_MEM2_RESULT_LOADED);
+    
+    // 等待ADC和内部参考稳定
     delay_ms(1);
     
     // 启用ADC转换
@@ -47,10 +126,14 @@ void user_adc_init(void)
  */
 adc_status_t user_adc_read_raw(adc_channel_t channel, uint16_t *value)
 {
-    if (value == NULL || channel >= ADC_CHANNEL_MAX) {
+    // 阻塞读取只使用MEM0，内部通道需通过异步请求读取
+    if (value == NULL || channel != ADC_CHANNEL_0) {
         return ADC_STATUS_ERROR;
     }
     
+    // 等待正在进行的异步请求完成，期间不再启动排队的请求
+    user_adc_hold_async();
+    
     // 清除中断状态和标志位
     DL_ADC12_clearInterruptStatus(ADC12_0_INST, DL_ADC12_INTERRUPT_MEM0_RESULT_LOADED);
     gCheckADC = false;
@@ -72,9 +155,35 @@ adc_status_t user_adc_read_raw(adc_channel_t channel, uint16_t *value)
     // 清除标志位
     gCheckADC = false;
     
+    // 恢复异步队列
+    user_adc_release_async();
+    
     return ADC_STATUS_OK;
 }
 
+/**
+ * @brief 暂停异步队列：等待正在转换的请求完成，此后不再启动排队的请求
+ * 阻塞读取或修改MEMCTL等ADC配置前调用，完成后须调用user_adc_release_async
+ */
+void user_adc_hold_async(void)
+{
+    g_async_hold = true;
+    while (g_active_request != ADC_REQUEST_INVALID) {
+        __WFE();
+    }
+}
+
+/**
+ * @brief 恢复异步队列，立即启动排队的请求
+ */
+void user_adc_release_async(void)
+{
+    __disable_irq();
+    g_async_hold = false;
+    adc_async_start_next();
+    __enable_irq();
+}
+
 /**
  * @brief 读取ADC电压值
  * @param channel ADC通道
@@ -142,8 +251,37 @@ adc_status_t user_adc_read_voltage_average(adc_channel_t channel, float *voltage
  */
 uint16_t user_adc_raw_to_millivolts(uint16_t raw_value)
 {
-    // 计算: (raw_value / 4095) * 3300mV
-    return (uint16_t)((uint32_t)raw_value * 3300 / ADC_MAX_VALUE);
+    // 计算: raw_value * 增益 + 偏移（未校准时即 (raw_value / 4095) * 3300mV）
+    // 使用Q16定点乘法+移位代替除法，M0+上无硬件除法器
+    int32_t mv_q16 = (int32_t)(raw_value * g_mv_per_code_q16) + g_mv_offset_q16;
+    return (mv_q16 > 0) ? (uint16_t)(mv_q16 >> 16) : 0;
+}
+
+/**
+ * @brief 将码值幅度（RMS、峰峰值等差值量）换算为毫伏，只乘增益不加偏移
+ * @param codes 码值幅度
+ * @return 毫伏值（四舍五入）
+ */
+uint16_t user_adc_span_to_millivolts(uint16_t codes)
+{
+    return (uint16_t)(((uint32_t)codes * g_mv_per_code_q16 + 0x8000u) >> 16);
+}
+
+/**
+ * @brief 将毫伏换算为ADC原始值（用于阈值配置等非热路径）
+ * @param millivolts 毫伏值
+ * @return 原始码值（0 ~ 4095）
+ */
+uint16_t user_adc_millivolts_to_raw(uint16_t millivolts)
+{
+    int32_t mv_q16 = ((int32_t)millivolts << 16) - (g_mv_offset_q16 - ADC_MV_OFFSET_Q16);
+    int32_t raw;
+
+    if (mv_q16 <= 0 || g_mv_per_code_q16 == 0) {
+        return 0;
+    }
+    raw = (int32_t)(((uint32_t)mv_q16 + g_mv_per_code_q16 / 2) / g_mv_per_code_q16);
+    return (raw > ADC_MAX_VALUE) ? ADC_MAX_VALUE : (uint16_t)raw;
 }
 
 /**
@@ -153,8 +291,89 @@ uint16_t user_adc_raw_to_millivolts(uint16_t raw_value)
  */
 float user_adc_raw_to_voltage(uint16_t raw_value)
 {
-    // 计算: (raw_value / 4095) * 3.3V
-    return ((float)raw_value * ADC_REFERENCE_VOLTAGE) / (float)ADC_MAX_VALUE;
+    // 计算: (raw_value * 增益 + 偏移) / 1000，与毫伏换算使用同一组校准系数
+    int32_t mv_q16 = (int32_t)(raw_value * g_mv_per_code_q16) + g_mv_offset_q16 - ADC_MV_OFFSET_Q16;
+    return (float)mv_q16 * (1.0f / (65536.0f * 1000.0f));
+}
+
+/**
+ * @brief 设置码值到电压的换算系数（由校准模块在启动或校准后调用）
+ * @param mv_per_code_q16 每个码值对应的毫伏数(Q16)
+ * @param offset_mv_q16 偏移(Q16 mV)，含0.5mV舍入量
+ */
+void user_adc_set_calibration(uint32_t mv_per_code_q16, int32_t offset_mv_q16)
+{
+    g_cal_mv_per_code_q16 = mv_per_code_q16;
+    g_mv_offset_q16 = offset_mv_q16;
+    g_mv_per_code_q16 = (uint32_t)(((uint64_t)g_cal_mv_per_code_q16 * g_ref_scale_q16) >> 16);
+}
+
+/**
+ * @brief 设置参考电压修正系数（由漂移补偿模块根据实测VDDA更新）
+ * @param scale_q16 当前VDDA / 校准时VDDA (Q16)
+ */
+void user_adc_set_reference_scale(uint32_t scale_q16)
+{
+    g_ref_scale_q16 = scale_q16;
+    g_mv_per_code_q16 = (uint32_t)(((uint64_t)g_cal_mv_per_code_q16 * g_ref_scale_q16) >> 16);
+}
+
+/**
+ * @brief 启动一次转换（单次模式下每次都需重新使能，起始地址选择通道对应的MEM）
+ */
+static void adc_async_start_conversion(adc_channel_t channel)
+{
+    DL_ADC12_clearInterruptStatus(ADC12_0_INST, g_channel_map[channel].interrupt);
+    DL_ADC12_setStartAddress(ADC12_0_INST, g_channel_map[channel].start_address);
+    DL_ADC12_enableConversions(ADC12_0_INST);
+    DL_ADC12_startConversion(ADC12_0_INST);
+}
+
+/**
+ * @brief 若ADC空闲则启动队首请求（主循环和中断中都会调用，调用者需关中断或处于中断中）
+ */
+static void adc_async_start_next(void)
+{
+    if (g_active_request != ADC_REQUEST_INVALID || g_fifo_count == 0 ||
+        g_async_hold || g_adc_sampling_active) {
+        return;
+    }
+
+    int8_t handle = g_request_fifo[g_fifo_head];
+    g_fifo_head = (g_fifo_head + 1) % ADC_REQUEST_QUEUE_SIZE;
+    g_fifo_count--;
+
+    adc_request_t *request = &g_requests[handle];
+    request->state = ADC_REQUEST_ACTIVE;
+    request->remaining = request->samples;
+    request->sum = 0;
+    g_active_request = handle;
+    adc_async_start_conversion(request->channel);
+}
+
+/**
+ * @brief 异步请求的一次转换完成（中断中调用）
+ * 未达到平均次数时立即启动下一次转换，完成后直接启动队列中的下一个请求
+ */
+static void adc_async_conversion_done(void)
+{
+    adc_request_t *request = &g_requests[g_active_request];
+
+    request->sum += DL_ADC12_getMemResult(ADC12_0_INST, g_channel_map[request->channel].mem);
+    if (--request->remaining != 0) {
+        adc_async_start_conversion(request->channel);
+        return;
+    }
+
+    // 内部通道完成后恢复MEM0起始地址，阻塞读取和高速采样仍直接启动转换
+    if (request->channel != ADC_CHANNEL_0) {
+        DL_ADC12_setStartAddress(ADC12_0_INST, DL_ADC12_SEQ_START_ADDR_00);
+    }
+
+    request->result = (uint16_t)((request->sum + request->samples / 2) / request->samples);
+    request->state = ADC_REQUEST_DONE;
+    g_active_request = ADC_REQUEST_INVALID;
+    adc_async_start_next();
 }
 
 /**
@@ -167,7 +386,25 @@ void ADC0_IRQHandler(void)
     {
         // 检查是否完成数据采集
         case DL_ADC12_IIDX_MEM0_RESULT_LOADED:
-            gCheckADC = true;//将标志位置1
+            if (g_active_request != ADC_REQUEST_INVALID) {
+                adc_async_conversion_done();  // 异步请求的转换
+            } else {
+                gCheckADC = true;//将标志位置1
+            }
+            break;
+        // 内部通道只由异步请求启动
+        case DL_ADC12_IIDX_MEM1_RESULT_LOADED:
+        case DL_ADC12_IIDX_MEM2_RESULT_LOADED:
+            if (g_active_request != ADC_REQUEST_INVALID) {
+                adc_async_conversion_done();
+            }
+            break;
+        // 窗口比较器：本次转换结果超出上/下限
+        case DL_ADC12_IIDX_WINDOW_COMP_HIGH:
+            user_adc_alarm_handle_interrupt(ADC_ALARM_HIGH);
+            break;
+        case DL_ADC12_IIDX_WINDOW_COMP_LOW:
+            user_adc_alarm_handle_interrupt(ADC_ALARM_LOW);
             break;
         default:
             break;
@@ -214,7 +451,8 @@ bool user_adc_is_ready(void)
  */
 adc_status_t user_adc_read_raw_polling(adc_channel_t channel, uint16_t *value)
 {
-    if (value == NULL || channel >= ADC_CHANNEL_MAX) {
+    // 阻塞读取只使用MEM0，内部通道需通过异步请求读取
+    if (value == NULL || channel != ADC_CHANNEL_0) {
         return ADC_STATUS_ERROR;
     }
     
@@ -277,23 +515,98 @@ adc_status_t user_adc_read_raw_fast(uint16_t *value)
     return ADC_STATUS_ERROR;
 }
 
+/**
+ * @brief 原始的浮点换算（仅作基准测试的对照组）
+ * user_adc_raw_to_voltage已改为定点校准换算，这里保留改动前的浮点乘除法
+ */
+static float adc_bench_float_reference(uint16_t raw_value)
+{
+    return ((float)raw_value * ADC_REFERENCE_VOLTAGE) / (float)ADC_MAX_VALUE;
+}
+
+/**
+ * @brief 对比一个批次的浮点换算与定点换算所需CPU周期数（串口命令"adc bench"）
+ * 以ADC_MAX_BATCH_SIZE个样本为一批，结果通过串口输出
+ */
+void user_adc_benchmark_conversion(void)
+{
+    static uint16_t bench_raw[ADC_MAX_BATCH_SIZE];
+    volatile float float_sink = 0.0f;
+    volatile uint32_t fixed_sink = 0;
+    char msg[96];
+
+    // 用覆盖全量程的码值填充测试数据
+    for (uint8_t i = 0; i < ADC_MAX_BATCH_SIZE; i++) {
+        bench_raw[i] = (uint16_t)((uint32_t)i * ADC_MAX_VALUE / (ADC_MAX_BATCH_SIZE - 1));
+    }
+
+    // 浮点换算（旧路径：每个样本入缓冲前都要换算）
+    uint32_t start = SysTick->VAL;
+    for (uint8_t i = 0; i < ADC_MAX_BATCH_SIZE; i++) {
+        float_sink = adc_bench_float_reference(bench_raw[i]);
+    }
+    uint32_t float_cycles = get_elapsed_cycles(start, SysTick->VAL);
+
+    // 定点换算（新路径：只在需要显示/发送时换算）
+    start = SysTick->VAL;
+    for (uint8_t i = 0; i < ADC_MAX_BATCH_SIZE; i++) {
+        fixed_sink = user_adc_raw_to_millivolts(bench_raw[i]);
+    }
+    uint32_t fixed_cycles = get_elapsed_cycles(start, SysTick->VAL);
+
+    (void)float_sink;
+    (void)fixed_sink;
+
+    snprintf(msg, sizeof(msg), "ADC bench (%d samples): float=%u cycles, fixed=%u cycles\r\n",
+             ADC_MAX_BATCH_SIZE, (unsigned int)float_cycles, (unsigned int)fixed_cycles);
+    user_uart_send_string(msg);
+}
+
+/**
+ * @brief 将当前批次送入滤波级，再把滤波输出发送出去
+ * 滤波在缓冲区上原地进行，CIC抽取时输出样本数少于输入
+ */
+static void adc_flush_batch(void)
+{
+    uint16_t out_count = user_filter_process_block(g_raw_buffer, g_raw_buffer, g_buffer_index);
+    uint32_t start_id = g_adc_sample_counter - g_buffer_index;
+    
+    firewater_send_block_timestamp(start_id, g_block_timestamp_us);
+    firewater_send_adc_batch_raw(g_raw_buffer, (uint8_t)out_count, start_id);
+    g_buffer_index = 0;
+}
+
 /**
  * @brief 开始高频ADC采样
- * @param sample_rate_hz 采样频率(Hz)
+ * 默认批量发送时速率受串口带宽限制(ADC_MAX_SAMPLE_RATE)；已设置样本接收函数时样本在本地处理，
+ * 上限为ADC_MAX_CAPTURE_RATE，因此需先调用user_adc_set_sample_sink
+ * @param sample_rate_hz 采样频率(Hz)，0或超出上限时取上限
  */
 void user_adc_start_high_speed_sampling(uint32_t sample_rate_hz)
 {
-    if (sample_rate_hz > ADC_MAX_SAMPLE_RATE) {
-        sample_rate_hz = ADC_MAX_SAMPLE_RATE;
+    uint32_t max_rate = (g_sample_sink != NULL) ? ADC_MAX_CAPTURE_RATE : ADC_MAX_SAMPLE_RATE;
+
+    if (sample_rate_hz == 0 || sample_rate_hz > max_rate) {
+        sample_rate_hz = max_rate;
     }
     
     g_sample_rate = sample_rate_hz;
+    
+    // 采样节拍由时间戳定时器给出，与主循环速度无关
+    g_sample_period_ticks = (TIMESTAMP_TICKS_PER_US * 1000000U) / sample_rate_hz;
+    g_next_sample_ticks = user_timestamp_ticks();
+    g_late_samples = 0;
+    
+    // 间隔直方图以本次采样率为标称值，每格为标称间隔的1/8
+    uint32_t nominal_us = 1000000U / sample_rate_hz;
+    user_jitter_init(&g_hs_jitter, "adc_hs", nominal_us, nominal_us / 8);
+    user_jitter_register(&g_hs_jitter);
     g_adc_sampling_active = true;
     g_adc_sample_counter = 0;
     g_buffer_index = 0;
     
     // 清空缓冲区
-    memset((void*)g_voltage_buffer, 0, sizeof(g_voltage_buffer));
+    memset((void*)g_raw_buffer, 0, sizeof(g_raw_buffer));
 }
 
 /**
@@ -305,9 +618,7 @@ void user_adc_stop_high_speed_sampling(void)
     
     // 发送剩余的缓冲数据
     if (g_buffer_index > 0) {
-        firewater_send_adc_batch(g_voltage_buffer, g_buffer_index, 
-                                 g_adc_sample_counter - g_buffer_index);
-        g_buffer_index = 0;
+        adc_flush_batch();
     }
 }
 
@@ -319,6 +630,31 @@ bool user_adc_is_sampling(void)
     return g_adc_sampling_active;
 }
 
+/**
+ * @brief 获取高速采样的标称采样率(Hz)
+ */
+uint32_t user_adc_get_sample_rate(void)
+{
+    return g_sample_rate;
+}
+
+/**
+ * @brief 获取最近一个高速采样样本的采样时刻（时间戳定时器计数）
+ * @note 样本接收函数中调用即得到当前样本的时刻
+ */
+uint32_t user_adc_last_sample_ticks(void)
+{
+    return g_last_sample_ticks;
+}
+
+/**
+ * @brief 获取本次高速采样以来错过的采样时刻数（主循环阻塞超过一个采样周期）
+ */
+uint32_t user_adc_get_late_samples(void)
+{
+    return g_late_samples;
+}
+
 /**
  * @brief 设置批处理大小
  */
@@ -329,6 +665,16 @@ void user_adc_set_batch_size(uint8_t batch_size)
     }
 }
 
+/**
+ * @brief 设置高速采样样本接收函数
+ * @param sink 接收函数，NULL表示恢复默认的批量滤波发送
+ * @note 示波器捕获等模块借助此接口接管原始样本流
+ */
+void user_adc_set_sample_sink(adc_sample_sink_t sink)
+{
+    g_sample_sink = sink;
+}
+
 /**
  * @brief 高频采样处理函数（优化版本，减少开销）
  * 需要在定时器中断或主循环中高频调用
@@ -339,21 +685,145 @@ void user_adc_high_speed_process(void)
         return;
     }
     
+    // 等待启动采样前已在转换的异步请求完成，避免两者争用MEM0
+    if (g_active_request != ADC_REQUEST_INVALID) {
+        return;
+    }
+    
+    // 按时间戳定时器节拍采样，未到采样时刻直接返回
+    uint32_t now_ticks = user_timestamp_ticks();
+    if ((int32_t)(now_ticks - g_next_sample_ticks) < 0) {
+        return;
+    }
+    g_next_sample_ticks += g_sample_period_ticks;
+    if ((int32_t)(now_ticks - g_next_sample_ticks) >= 0) {
+        // 落后超过一个周期：重新对齐，不连续补采（补采的样本间隔不对）
+        g_late_samples++;
+        g_next_sample_ticks = now_ticks + g_sample_period_ticks;
+    }
+    
     // 使用专门的高速读取函数
     uint16_t raw_value;
     if (user_adc_read_raw_fast(&raw_value) == ADC_STATUS_OK) {
-        float voltage = user_adc_raw_to_voltage(raw_value);
+        g_last_sample_ticks = now_ticks;
+        user_jitter_record(&g_hs_jitter, now_ticks);
+        
+        // 样本流已被其他模块接管，直接交给接收函数
+        if (g_sample_sink != NULL) {
+            g_adc_sample_counter++;
+            g_sample_sink(raw_value);
+            return;
+        }
         
-        // 添加到缓冲区
-        g_voltage_buffer[g_buffer_index] = voltage;
+        // 直接缓存原始码值，电压换算推迟到发送时按需进行
+        if (g_buffer_index == 0) {
+            g_block_timestamp_us = now_ticks / TIMESTAMP_TICKS_PER_US;
+        }
+        g_raw_buffer[g_buffer_index] = raw_value;
         g_buffer_index++;
         g_adc_sample_counter++;
         
-        // 当缓冲区满时，发送数据
+        // 当缓冲区满时，滤波后发送数据
         if (g_buffer_index >= g_batch_size) {
-            firewater_send_adc_batch(g_voltage_buffer, g_buffer_index, 
-                                     g_adc_sample_counter - g_buffer_index);
-            g_buffer_index = 0;
+            adc_flush_batch();
+        }
+    }
+}
+
+/**
+ * @brief 提交异步ADC请求，立即返回
+ * 请求按提交顺序排队，转换由ADC中断推进，主循环可同时处理OLED/I2C等工作
+ * @param channel ADC通道
+ * @param samples 平均次数（1~255）
+ * @param callback 完成回调，NULL时由调用者通过user_adc_request_poll查询
+ * @param context 回调参数
+ * @return 请求句柄，队列满或参数无效时返回ADC_REQUEST_INVALID
+ */
+int8_t user_adc_submit(adc_channel_t channel, uint8_t samples,
+                       adc_request_callback_t callback, void *context)
+{
+    if (channel >= ADC_CHANNEL_MAX || samples == 0) {
+        return ADC_REQUEST_INVALID;
+    }
+
+    for (int8_t handle = 0; handle < ADC_REQUEST_QUEUE_SIZE; handle++) {
+        adc_request_t *request = &g_requests[handle];
+        if (request->state != ADC_REQUEST_FREE) {
+            continue;
         }
+
+        request->channel = channel;
+        request->samples = samples;
+        request->callback = callback;
+        request->context = context;
+        request->state = ADC_REQUEST_PENDING;
+
+        // 队列与中断共享，入队和启动期间关中断
+        __disable_irq();
+        g_request_fifo[(g_fifo_head + g_fifo_count) % ADC_REQUEST_QUEUE_SIZE] = handle;
+        g_fifo_count++;
+        adc_async_start_next();
+        __enable_irq();
+        return handle;
+    }
+    return ADC_REQUEST_INVALID;
+}
+
+/**
+ * @brief 查询异步请求状态
+ */
+adc_request_state_t user_adc_request_state(int8_t handle)
+{
+    if (handle < 0 || handle >= ADC_REQUEST_QUEUE_SIZE) {
+        return ADC_REQUEST_FREE;
     }
+    return (adc_request_state_t)g_requests[handle].state;
+}
+
+/**
+ * @brief 查询无回调请求的结果，完成时取出结果并释放槽位
+ * @param handle 请求句柄
+ * @param value 输出的平均码值
+ * @return true: 已完成，value有效
+ */
+bool user_adc_request_poll(int8_t handle, uint16_t *value)
+{
+    if (handle < 0 || handle >= ADC_REQUEST_QUEUE_SIZE || value == NULL) {
+        return false;
+    }
+
+    adc_request_t *request = &g_requests[handle];
+    if (request->state != ADC_REQUEST_DONE || request->callback != NULL) {
+        return false;
+    }
+    *value = request->result;
+    request->state = ADC_REQUEST_FREE;
+    return true;
+}
+
+/**
+ * @brief 是否有正在转换或排队等待的异步请求
+ */
+bool user_adc_async_busy(void)
+{
+    return g_active_request != ADC_REQUEST_INVALID || g_fifo_count != 0;
+}
+
+/**
+ * @brief 异步请求处理函数，需在主循环中调用
+ * 调用已完成请求的回调并释放槽位；高速采样结束后恢复排队请求
+ */
+void user_adc_async_process(void)
+{
+    for (int8_t handle = 0; handle < ADC_REQUEST_QUEUE_SIZE; handle++) {
+        adc_request_t *request = &g_requests[handle];
+        if (request->state == ADC_REQUEST_DONE && request->callback != NULL) {
+            request->state = ADC_REQUEST_FREE;
+            request->callback(handle, request->result, request->context);
+        }
+    }
+
+    __disable_irq();
+    adc_async_start_next();
+    __enable_irq();
 }
@@ -12,12 +12,28 @@ extern "C" {
 #define ADC_RESOLUTION_BITS         12
 #define ADC_MAX_VALUE              (4095)      // 2^12 - 1
 #define ADC_REFERENCE_VOLTAGE       3.3f       // VDDA参考电压
+#define ADC_REFERENCE_MILLIVOLTS    3300       // VDDA参考电压(mV)
+#define ADC_MV_PER_CODE_Q16         52814U     // 3300 * 65536 / 4095，每个码值对应的毫伏数(Q16)
+#define ADC_MV_OFFSET_Q16           0x8000     // 默认偏移：仅包含0.5mV舍入量(Q16)
 #define ADC_SAMPLES_FOR_AVERAGE     10         // 平均采样次数
 
+// 内部通道（参考漂移补偿用）：使用MEM1/MEM2和内部1.4V参考，VDDA变化不影响其结果
+#define ADC_INTREF_MILLIVOLTS       1400       // 内部参考电压(mV)
+#define ADC_SUPPLY_INPUT_CHANNEL    DL_ADC12_INPUT_CHAN_15  // 电源监测，输入为VDDA/3
+#define ADC_TEMP_INPUT_CHANNEL      DL_ADC12_INPUT_CHAN_11  // 内部温度传感器
+#define ADC_REF_SCALE_ONE_Q16       65536U     // 参考电压修正系数1.0(Q16)
+
 // 高频采样相关定义
 #define ADC_MAX_BATCH_SIZE          50         // 批处理最大数据数量（增加批量大小）
 #define ADC_BUFFER_SIZE             200        // 采样缓冲区大小（增加缓冲区）
 #define ADC_MAX_SAMPLE_RATE         1000       // 最大采样频率(Hz) - 适配50000波特率
+                                               // 采样时刻由时间戳定时器给出，主循环只需足够快地轮询
+#define ADC_MAX_CAPTURE_RATE        20000      // 样本交给接收函数在本地缓存时（示波器等）的最大采样频率(Hz)，
+                                               // 不受串口带宽限制，只受主循环轮询速度限制，实际速率由时间戳测量
+
+// 异步请求相关定义
+#define ADC_REQUEST_QUEUE_SIZE      4          // 同时排队的异步请求数
+#define ADC_REQUEST_INVALID         (-1)       // 提交失败时返回的句柄
 
 // ADC状态枚举
 typedef enum {
@@ -29,9 +45,25 @@ typedef enum {
 // ADC通道枚举
 typedef enum {
     ADC_CHANNEL_0 = 0,      // GPIOA.27
+    ADC_CHANNEL_SUPPLY,     // 内部电源监测（仅异步请求）
+    ADC_CHANNEL_TEMPERATURE,// 内部温度传感器（仅异步请求）
     ADC_CHANNEL_MAX
 } adc_channel_t;
 
+// 高速采样样本接收函数（设置后样本直接交给接收函数，不再批量发送）
+typedef void (*adc_sample_sink_t)(uint16_t raw_value);
+
+// 异步请求完成回调（在user_adc_async_process中调用，不在中断中）
+typedef void (*adc_request_callback_t)(int8_t handle, uint16_t raw_value, void *context);
+
+// 异步请求状态枚举
+typedef enum {
+    ADC_REQUEST_FREE = 0,       // 空闲槽位
+    ADC_REQUEST_PENDING,        // 排队等待
+    ADC_REQUEST_ACTIVE,         // 正在转换
+    ADC_REQUEST_DONE            // 转换完成，等待回调或查询
+} adc_request_state_t;
+
 // 全局变量声明
 extern volatile bool gCheckADC;  // ADC采集成功标志位
 
@@ -41,7 +73,11 @@ adc_status_t user_adc_read_raw(adc_channel_t channel, uint16_t *value);
 adc_status_t user_adc_read_voltage(adc_channel_t channel, float *voltage);
 adc_status_t user_adc_read_voltage_average(adc_channel_t channel, float *voltage, uint8_t samples);
 uint16_t user_adc_raw_to_millivolts(uint16_t raw_value);
+uint16_t user_adc_span_to_millivolts(uint16_t codes);
+uint16_t user_adc_millivolts_to_raw(uint16_t millivolts);
 float user_adc_raw_to_voltage(uint16_t raw_value);
+void user_adc_set_calibration(uint32_t mv_per_code_q16, int32_t offset_mv_q16);
+void user_adc_set_reference_scale(uint32_t scale_q16);
 
 // ADC中断服务函数（修正为配置文件中的正确名称：ADC0_IRQHandler）
 void ADC0_IRQHandler(void);
@@ -51,13 +87,28 @@ void user_adc_test_interrupt(void);
 bool user_adc_is_ready(void);
 adc_status_t user_adc_read_raw_polling(adc_channel_t channel, uint16_t *value);
 adc_status_t user_adc_read_raw_fast(uint16_t *value);  // 高速采样专用函数
+void user_adc_benchmark_conversion(void);              // 浮点/定点换算周期数对比
 
 // 高频采样函数
 void user_adc_start_high_speed_sampling(uint32_t sample_rate_hz);
 void user_adc_stop_high_speed_sampling(void);
 void user_adc_high_speed_process(void);
 bool user_adc_is_sampling(void);
+uint32_t user_adc_get_sample_rate(void);
+uint32_t user_adc_last_sample_ticks(void);
+uint32_t user_adc_get_late_samples(void);
 void user_adc_set_batch_size(uint8_t batch_size);
+void user_adc_set_sample_sink(adc_sample_sink_t sink);
+
+// 异步请求函数：提交后立即返回，转换在ADC中断中推进
+int8_t user_adc_submit(adc_channel_t channel, uint8_t samples,
+                       adc_request_callback_t callback, void *context);
+adc_request_state_t user_adc_request_state(int8_t handle);
+bool user_adc_request_poll(int8_t handle, uint16_t *value);
+bool user_adc_async_busy(void);
+void user_adc_async_process(void);
+void user_adc_hold_async(void);
+void user_adc_release_async(void);
 
 #ifdef __cplusplus
 }
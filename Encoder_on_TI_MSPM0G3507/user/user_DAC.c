@@ -1,56 +1,832 @@
 #include "user_DAC.h"
+#include "user_wave_tables.h"
 #include "user_uart.h"
+#include "firewater_protocol.h"
 #include "delay.h"
 #include <stdio.h>
 
-// 正弦波数据表
-static uint16_t sine_table[SINE_TABLE_SIZE];
-static volatile uint32_t sine_index = 0;
+// 播放表：当前波形按幅度、偏移和校正表换算后的DAC码值，中断/DMA路径只查此表
+static uint16_t play_table[WAVE_TABLE_SIZE];
+
+// 内置波形源表（Q15，const存放于Flash，由tools/gen_wave_tables.py生成）
+// 正弦只存四分之一周期，按对称性展开，此处为NULL
+static const int16_t *const builtin_tables[DAC_WAVE_USER0] = {
+    NULL,
+    g_wave_square_q15,
+    g_wave_triangle_q15,
+    g_wave_sawtooth_q15,
+    g_wave_noise_q15,
+};
+
+// 当前波形选择（校正表变化时按此重新生成播放表）
+static dac_waveform_t current_wave = DAC_WAVE_SINE;
+static uint16_t current_amplitude_mv = DAC_DEFAULT_AMPLITUDE_MV;
+static uint16_t current_offset_mv = DAC_DEFAULT_OFFSET_MV;
+static const int16_t *user_tables[DAC_USER_WAVE_SLOTS];
+// 播放方式：连续波形在相邻表项间线性插值，跳变波形直接取表，选择波形时确定
+typedef void (*dac_fill_t)(uint16_t *block, uint32_t count);
+static void dac_fill_nearest(uint16_t *block, uint32_t count);
+static void dac_fill_interpolated(uint16_t *block, uint32_t count);
+static void dac_fill_replay(uint16_t *block, uint32_t count);
+static void dac_fill_multitone(uint16_t *block, uint32_t count);
+static volatile dac_fill_t dac_fill = dac_fill_interpolated;
+
+// 回放：按源采样率与DAC采样率之比逐点推进位置(Q16)，相邻记录点间线性插值
+static const uint16_t *replay_codes = NULL;    // 已校正的DAC码值，由调用者保持有效
+static uint32_t replay_length_q16 = 0;          // 记录长度(Q16)
+static uint32_t replay_position_q16 = 0;
+static uint32_t replay_step_q16 = 0;            // 每个DAC采样点前进的记录点数(Q16)
+static uint32_t replay_source_rate_hz = 0;
+static uint16_t replay_speed_percent = 100;
+static bool replay_loop = false;
+static volatile bool replay_active = false;     // 单次回放结束后为false，输出保持最后一点
+
+// 多音合成：各振荡器独立相位累加，按块逐个音累加到混合缓冲区，最后统一限幅和校正
+typedef struct {
+    uint32_t phase;             // 相位累加器
+    uint32_t tuning;            // 调谐字
+    uint32_t frequency_mhz;
+    int32_t amplitude;          // 峰值（码值，已按限幅系数缩小）
+} dac_oscillator_t;
+
+static dac_oscillator_t multitone[DAC_MULTITONE_MAX];
+static uint8_t multitone_count = 0;
+static int32_t multitone_offset = 2048;         // 偏移（理想码值）
+static uint8_t multitone_scale_percent = 100;   // 限幅保护的缩小比例
+static int32_t multitone_mix[DAC_DMA_BLOCK_SIZE_MAX];  // 混合缓冲区（码值 x 2^15）
+
+static volatile uint32_t dds_phase = 0;         // DDS相位累加器（2^32对应一个周期）
+static volatile uint32_t dds_tuning_word = 0;   // 每个采样点的相位增量
+static uint32_t dds_frequency_mhz = 0;          // 当前输出频率(mHz)
 static volatile bool dac_running = false;
-static volatile uint32_t interrupt_count = 0;  // 添加中断计数器用于调试
+
+// 采样率与块大小（块大小同时是DMA半缓冲区长度和调制更新间隔）
+static uint32_t dac_sample_rate_hz = DAC_DEFAULT_SAMPLE_RATE_HZ;
+static volatile uint32_t dac_block_size = DAC_DMA_BLOCK_SIZE;
+static bool dac_use_timer_trigger = false;      // true: TIMG7触发, false: DAC采样定时器
+
+// 采样定时器档位（DAC硬件支持的固定速率）
+typedef struct {
+    uint32_t rate_hz;
+    DL_DAC12_SAMPLES_PER_SECOND setting;
+} dac_rate_preset_t;
+
+static const dac_rate_preset_t dac_rate_presets[] = {
+    {500,    DL_DAC12_SAMPLES_PER_SECOND_500},
+    {1000,   DL_DAC12_SAMPLES_PER_SECOND_1K},
+    {2000,   DL_DAC12_SAMPLES_PER_SECOND_2K},
+    {4000,   DL_DAC12_SAMPLES_PER_SECOND_4K},
+    {8000,   DL_DAC12_SAMPLES_PER_SECOND_8K},
+    {16000,  DL_DAC12_SAMPLES_PER_SECOND_16K},
+    {100000, DL_DAC12_SAMPLES_PER_SECOND_100K},
+    {200000, DL_DAC12_SAMPLES_PER_SECOND_200K},
+};
+
+// DAC配置：在SysConfig配置基础上打开DMA触发（SysConfig中未启用），
+// DAC_init时写入一次，切换FIFO触发源和采样率时在此基础上重新初始化
+static DL_DAC12_Config dac_config = {
+    .outputEnable              = DL_DAC12_OUTPUT_ENABLED,
+    .resolution                = DL_DAC12_RESOLUTION_12BIT,
+    .representation            = DL_DAC12_REPRESENTATION_BINARY,
+    .voltageReferenceSource    = DL_DAC12_VREF_SOURCE_VDDA_VSSA,
+    .amplifierSetting          = DL_DAC12_AMP_ON,
+    .fifoEnable                = DL_DAC12_FIFO_ENABLED,
+    .fifoTriggerSource         = DL_DAC12_FIFO_TRIGGER_SAMPLETIMER,
+#if DAC_USE_DMA
+    .dmaTriggerEnable          = DL_DAC12_DMA_TRIGGER_ENABLED,
+    .dmaTriggerThreshold       = DL_DAC12_FIFO_THRESHOLD_TWO_QTRS_EMPTY,
+#else
+    .dmaTriggerEnable          = DL_DAC12_DMA_TRIGGER_DISABLED,
+    .dmaTriggerThreshold       = DL_DAC12_FIFO_THRESHOLD_ONE_QTR_EMPTY,
+#endif
+    .sampleTimeGeneratorEnable = DL_DAC12_SAMPLETIMER_ENABLE,
+    .sampleRate                = DL_DAC12_SAMPLES_PER_SECOND_8K,
+};
+
+// 扫频状态：调谐字以Q16保存，逐块累加，避免对数扫频的舍入误差累积
+static volatile bool sweep_active = false;
+static bool sweep_log = false;
+static bool sweep_repeat = false;
+static uint64_t sweep_tuning_q16 = 0;           // 当前调谐字(Q16)
+static int64_t sweep_step_q16 = 0;              // 线性：每块调谐字增量(Q16)
+static int32_t sweep_ratio_q30 = 0;             // 对数：每块倍率减1(Q30)
+static uint32_t sweep_start_tuning = 0;
+static uint32_t sweep_stop_tuning = 0;
+static uint32_t sweep_blocks = 0;               // 每次扫频的块数
+static uint32_t sweep_remaining = 0;            // 本次扫频剩余块数
+
+// 包络状态：增益Q15（32768为1.0），以中点码值为中心缩放播放表输出
+typedef enum {
+    DAC_ENVELOPE_NONE = 0,
+    DAC_ENVELOPE_AM,
+    DAC_ENVELOPE_RAMP
+} dac_envelope_t;
+static volatile dac_envelope_t envelope_mode = DAC_ENVELOPE_NONE;
+static volatile int32_t envelope_gain_q15 = 32768;
+static uint32_t envelope_phase = 0;             // AM调制相位
+static uint32_t envelope_tuning = 0;            // AM每块相位增量
+static int32_t envelope_depth_q15 = 0;          // AM调制深度
+static int32_t envelope_ramp_q30 = 0;           // 斜坡当前增益(Q30)
+static int32_t envelope_step_q30 = 0;           // 斜坡每块增益增量(Q30)
+static int32_t envelope_target_q30 = 0;
+static uint32_t envelope_remaining = 0;         // 斜坡剩余块数
+static int32_t play_mid_code = 2048;            // 偏移对应的校正后码值（包络缩放中心）
+static uint32_t mod_sample_count = 0;           // FIFO模式下距上次块更新的采样点数
+
+#if DAC_USE_DMA
+// DMA乒乓缓冲区：DMA播放一半时CPU用DDS生成另一半
+static uint16_t dma_buffer[DAC_DMA_BUFFER_SIZE];
+
+// 重复单次传输：每个DAC触发搬运一个采样点，整块完成后自动重装地址和长度
+static const DL_DMA_Config dma_config = {
+    .transferMode   = DL_DMA_FULL_CH_REPEAT_SINGLE_TRANSFER_MODE,
+    .extendedMode   = DL_DMA_NORMAL_MODE,
+    .destIncrement  = DL_DMA_ADDR_UNCHANGED,
+    .srcIncrement   = DL_DMA_ADDR_INCREMENT,
+    .destWidth      = DL_DMA_WIDTH_HALF_WORD,
+    .srcWidth       = DL_DMA_WIDTH_HALF_WORD,
+    .trigger        = DMA_DAC0_EVT_BD_1_TRIG,
+    .triggerType    = DL_DMA_TRIGGER_TYPE_EXTERNAL,
+};
+#endif
+
+// 健康计数：中断中只做自增和比较，换算在读取时完成
+static volatile uint32_t health_refills = 0;
+static volatile uint32_t health_underruns = 0;
+static volatile uint32_t health_late_refills = 0;
+static volatile uint32_t health_max_latency_samples = 0;   // 最大补充延迟（采样点数）
+
+// 校正表：第i个节点为输出理想码值i*DAC_CORRECTION_STEP时实际应写入的码值
+static uint16_t correction_table[DAC_CORRECTION_POINTS];
+static bool correction_enabled = false;
 
 /**
  * @brief 初始化DAC
  */
 void DAC_init(void)
 {
-    // 生成正弦波表
-    DAC_generateSineTable();
+    // 生成播放表
+    DAC_selectWaveform(DAC_WAVE_SINE, DAC_DEFAULT_AMPLITUDE_MV, DAC_DEFAULT_OFFSET_MV);
     
     // 重置状态
-    sine_index = 0;
+    dds_phase = 0;
     dac_running = false;
+    DAC_setSineFrequency(DAC_DEFAULT_FREQ_MHZ);
     
     // 清除中断标志
     DL_DAC12_clearInterruptStatus(DAC_INST, DL_DAC12_INTERRUPT_FIFO_ONE_QTR_EMPTY);
     
+    // 按dac_config重新初始化：SYSCFG_DL_init()生成的配置不含DMA触发
+    DL_DAC12_disable(DAC_INST);
+    DL_DAC12_init(DAC_INST, &dac_config);
+
+#if DAC_USE_DMA
+    // DMA模式下FIFO由DMA触发填充，不使用FIFO中断
+    DL_DAC12_disableInterrupt(DAC_INST, DL_DAC12_INTERRUPT_FIFO_ONE_QTR_EMPTY);
+    
+    DL_DMA_initChannel(DMA, DAC_DMA_CHANNEL, (DL_DMA_Config *)&dma_config);
+    DL_DMA_setSrcAddr(DMA, DAC_DMA_CHANNEL, (uint32_t)&dma_buffer[0]);
+    DL_DMA_setDestAddr(DMA, DAC_DMA_CHANNEL, (uint32_t)&DAC_INST->DATA0);
+    DL_DMA_setTransferSize(DMA, DAC_DMA_CHANNEL, dac_block_size * 2);
+    DL_DMA_Full_Ch_setEarlyInterruptThreshold(DMA, DAC_DMA_CHANNEL,
+        DL_DMA_EARLY_INTERRUPT_THRESHOLD_HALF);
+    DL_DMA_enableInterrupt(DMA, DL_DMA_INTERRUPT_CHANNEL0 | DL_DMA_FULL_CH_INTERRUPT_EARLY_CHANNEL0);
+    NVIC_ClearPendingIRQ(DMA_INT_IRQn);
+    NVIC_EnableIRQ(DMA_INT_IRQn);
+#else
     // NVIC中断配置（确保NVIC层面启用）
     NVIC_ClearPendingIRQ(DAC12_INT_IRQN);
     NVIC_EnableIRQ(DAC12_INT_IRQN);
+#endif
     
-    // 注意：DAC和中断在SYSCFG_DL_init()中已经初始化和启用
-    // 这里只需要确保是启用状态
+    // 上面重新初始化时关闭了DAC，重新使能
     DL_DAC12_enable(DAC_INST);
     
     user_uart_send_string("DAC: Initialization complete\r\n");
 }
 
 /**
- * @brief 生成正弦波数据表 (0V到3.3V，即0到4095)
+ * @brief 用DDS生成一块采样点：相位累加器高位直接索引播放表（方波、锯齿、噪声）
+ * 调谐字每块只读一次，修改频率时相位连续、无毛刺；循环内无取模和寄存器查询
+ */
+static void dac_fill_nearest(uint16_t *block, uint32_t count)
+{
+    uint32_t phase = dds_phase;
+    uint32_t tuning = dds_tuning_word;
+
+    for (uint32_t i = 0; i < count; i++) {
+        block[i] = play_table[phase >> (32 - WAVE_TABLE_BITS)];
+        phase += tuning;
+    }
+    dds_phase = phase;
+}
+
+/**
+ * @brief 用DDS生成一块采样点：相位高8位选表项，其后8位在相邻表项间线性插值
+ * 8kSPS、1234.567Hz时SFDR由直接取表的48dBc提高到约85dBc，优于4096点直接取表
+ * （相位截断限制在约72dBc），见test/host/test_dac_sfdr.c
+ */
+static void dac_fill_interpolated(uint16_t *block, uint32_t count)
+{
+    uint32_t phase = dds_phase;
+    uint32_t tuning = dds_tuning_word;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = phase >> (32 - WAVE_TABLE_BITS);
+        int32_t frac = (int32_t)((phase >> (32 - WAVE_TABLE_BITS - WAVE_INTERP_BITS)) &
+                                 ((1U << WAVE_INTERP_BITS) - 1U));
+        int32_t a = play_table[index];
+        int32_t b = play_table[(index + 1U) & (WAVE_TABLE_SIZE - 1U)];
+        block[i] = (uint16_t)(a + (((b - a) * frac) >> WAVE_INTERP_BITS));
+        phase += tuning;
+    }
+    dds_phase = phase;
+}
+
+/**
+ * @brief 由四分之一周期表按对称性取正弦第index点(Q15)
+ */
+static inline int16_t dac_quarter_sine(uint8_t index)
+{
+    uint8_t offset = index & (WAVE_QUARTER_SIZE - 1);
+
+    switch (index / WAVE_QUARTER_SIZE) {
+        case 0:  return g_wave_quarter_sine_q15[offset];
+        case 1:  return g_wave_quarter_sine_q15[WAVE_QUARTER_SIZE - offset];
+        case 2:  return (int16_t)-g_wave_quarter_sine_q15[offset];
+        default: return (int16_t)-g_wave_quarter_sine_q15[WAVE_QUARTER_SIZE - offset];
+    }
+}
+
+/**
+ * @brief 频率换算为DDS调谐字：f / fs x 2^32，四舍五入
+ */
+static uint32_t dac_tuning_word(uint32_t frequency_mhz)
+{
+    return (uint32_t)((((uint64_t)frequency_mhz << 32) + dac_sample_rate_hz * 500U) /
+                      ((uint64_t)dac_sample_rate_hz * 1000U));
+}
+
+/**
+ * @brief 定点log2(x)，Q30，x > 0
+ * 整数部分取最高位位置，小数部分对归一化尾数逐位平方求得（每次平方得到一位）
+ */
+static int64_t dac_log2_q30(uint32_t x)
+{
+    int64_t result;
+    uint64_t mantissa;      // [1, 2)，Q30
+    int bit = 31;
+
+    while ((x & (1UL << bit)) == 0) {
+        bit--;
+    }
+    result = (int64_t)bit << 30;
+    mantissa = ((uint64_t)x << 30) >> bit;
+
+    for (int32_t fraction = 1L << 29; fraction > 0; fraction >>= 1) {
+        mantissa = (mantissa * mantissa + (1ULL << 29)) >> 30;
+        if (mantissa >= (2ULL << 30)) {
+            mantissa >>= 1;
+            result += fraction;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 定点2^x，x与结果均为Q30，x < 1
+ * x拆为整数部分i和小数部分f∈[0,1)：2^f按e^y的级数展开（y = f ln2 < 0.7），
+ * 逐项递推直到项为0，再右移-i位；各步四舍五入，避免截断误差在长扫频中单向累积
+ */
+static int64_t dac_exp2_q30(int64_t x_q30)
+{
+    const int64_t ln2_q30 = 744261118;     // ln2 x 2^30
+    int64_t integer = x_q30 >> 30;          // 向负无穷取整，x < 1时不大于0
+    int64_t y = ((x_q30 - (integer << 30)) * ln2_q30) >> 30;
+    int64_t term = 1LL << 30;
+    int64_t sum = 0;
+
+    for (int32_t k = 1; term != 0; k++) {
+        sum += term;
+        term = (((term * y + (1LL << 29)) >> 30) + k / 2) / k;
+    }
+    if (integer <= -62) {
+        return 0;
+    }
+    return (integer == 0) ? sum : ((sum + (1LL << (-integer - 1))) >> -integer);
+}
+
+/**
+ * @brief 检查FIFO空标志：置位说明自上次检查以来FIFO曾被取空
+ */
+static inline void dac_check_underrun(void)
+{
+    if (DL_DAC12_getRawInterruptStatus(DAC_INST, DL_DAC12_INTERRUPT_FIFO_EMPTY)) {
+        health_underruns++;
+        DL_DAC12_clearInterruptStatus(DAC_INST, DL_DAC12_INTERRUPT_FIFO_EMPTY);
+    }
+}
+
+/**
+ * @brief 时长(ms)换算为调制块数
+ */
+static uint32_t dac_blocks_for_ms(uint32_t duration_ms)
+{
+    return (uint32_t)(((uint64_t)duration_ms * dac_sample_rate_hz) / (1000U * dac_block_size));
+}
+
+/**
+ * @brief 每块一次：推进扫频调谐字和包络增益
+ */
+static void dac_modulation_step(void)
+{
+    if (sweep_active) {
+        if (sweep_remaining > 0) {
+            sweep_remaining--;
+            if (sweep_log) {
+                // f *= r，写成 f += f x (r - 1)，乘积不超过64位
+                sweep_tuning_q16 += ((int64_t)(sweep_tuning_q16 >> 16) * sweep_ratio_q30) >> 14;
+            } else {
+                sweep_tuning_q16 += sweep_step_q16;
+            }
+        } else if (sweep_repeat) {
+            sweep_tuning_q16 = (uint64_t)sweep_start_tuning << 16;
+            sweep_remaining = sweep_blocks;
+        } else {
+            sweep_tuning_q16 = (uint64_t)sweep_stop_tuning << 16;   // 停在终止频率
+            sweep_active = false;
+        }
+        dds_tuning_word = (uint32_t)(sweep_tuning_q16 >> 16);
+    }
+
+    switch (envelope_mode) {
+        case DAC_ENVELOPE_AM: {
+            // 增益在1-m到1之间变化，峰值不超过设定幅度
+            int32_t s = dac_quarter_sine((uint8_t)(envelope_phase >> 24));
+            envelope_gain_q15 = 32768 - ((envelope_depth_q15 * (32768 - s)) >> 16);
+            envelope_phase += envelope_tuning;
+            break;
+        }
+        case DAC_ENVELOPE_RAMP:
+            if (envelope_remaining > 0) {
+                envelope_remaining--;
+                envelope_ramp_q30 += envelope_step_q30;
+            } else {
+                envelope_ramp_q30 = envelope_target_q30;
+            }
+            envelope_gain_q15 = envelope_ramp_q30 >> 15;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 按包络增益以中点码值为中心缩放一块采样点
+ */
+static void dac_apply_envelope(uint16_t *block, uint32_t count)
+{
+    int32_t gain = envelope_gain_q15;
+    int32_t mid = play_mid_code;
+
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t code = mid + ((((int32_t)block[i] - mid) * gain) >> 15);
+        if (code < 0) code = 0;
+        if (code > DAC_MAX_VALUE) code = DAC_MAX_VALUE;
+        block[i] = (uint16_t)code;
+    }
+}
+
+#if DAC_USE_DMA
+/**
+ * @brief 生成一块采样点：块更新调制参数，DDS填充，再叠加包络
+ */
+static void dac_produce_block(uint16_t *block, uint32_t count)
+{
+    dac_modulation_step();
+    dac_fill(block, count);
+    if (envelope_mode != DAC_ENVELOPE_NONE) {
+        dac_apply_envelope(block, count);
+    }
+}
+#endif
+
+/**
+ * @brief 回放记录数据：位置整数部分选记录点，小数部分在相邻点间插值
+ * 循环回放时最后一点与第一点之间也插值；单次回放到末尾后保持最后一点
+ */
+static void dac_fill_replay(uint16_t *block, uint32_t count)
+{
+    const uint16_t *codes = replay_codes;
+    uint32_t position = replay_position_q16;
+    uint32_t step = replay_step_q16;
+    uint32_t length = replay_length_q16;
+    uint32_t last = (length >> 16) - 1U;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = position >> 16;
+        int32_t frac = (int32_t)((position >> 8) & 0xFFU);
+        int32_t a = codes[index];
+        int32_t b = (index < last) ? codes[index + 1U] : (replay_loop ? codes[0] : a);
+        block[i] = (uint16_t)(a + (((b - a) * frac) >> 8));
+
+        position += step;
+        if (position >= length) {
+            if (replay_loop) {
+                position -= length;
+            } else {
+                position = last << 16;
+                step = 0;
+                replay_step_q16 = 0;
+                replay_active = false;
+            }
+        }
+    }
+    replay_position_q16 = position;
+}
+
+/**
+ * @brief 按源采样率、回放速度和当前DAC采样率计算回放步进(Q16)
+ */
+static uint32_t dac_replay_step(void)
+{
+    return (uint32_t)((((uint64_t)replay_source_rate_hz * replay_speed_percent) << 16) /
+                      ((uint64_t)dac_sample_rate_hz * 100U));
+}
+
+/**
+ * @brief 多音合成一块采样点：外层按音、内层按点，每个音的参数整块只读一次
+ * 每点每音两次查表和两次乘法，直接查Flash中的四分之一周期表，不占用RAM；
+ * N个音的Q15乘积之和不超过2^31，不会溢出
+ */
+static void dac_fill_multitone(uint16_t *block, uint32_t count)
+{
+    int32_t *mix = multitone_mix;
+
+    for (uint32_t i = 0; i < count; i++) {
+        mix[i] = 0;
+    }
+    for (uint8_t t = 0; t < multitone_count; t++) {
+        dac_oscillator_t *osc = &multitone[t];
+        uint32_t phase = osc->phase;
+        uint32_t tuning = osc->tuning;
+        int32_t amplitude = osc->amplitude;
+
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t index = phase >> (32 - WAVE_TABLE_BITS);
+            int32_t frac = (int32_t)((phase >> (32 - WAVE_TABLE_BITS - WAVE_INTERP_BITS)) &
+                                     ((1U << WAVE_INTERP_BITS) - 1U));
+            int32_t a = dac_quarter_sine((uint8_t)index);
+            int32_t b = dac_quarter_sine((uint8_t)(index + 1U));
+            mix[i] += amplitude * (a + (((b - a) * frac) >> WAVE_INTERP_BITS));
+            phase += tuning;
+        }
+        osc->phase = phase;
+    }
+
+    // 启动时已按摆幅缩小幅度，这里的削顶只处理舍入误差
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t code = multitone_offset + ((mix[i] + (1 << 14)) >> 15);
+        if (code < 0) code = 0;
+        if (code > DAC_MAX_VALUE) code = DAC_MAX_VALUE;
+        block[i] = correction_enabled ? DAC_correctCode((uint16_t)code) : (uint16_t)code;
+    }
+}
+
+/**
+ * @brief DDS取下一个采样点（FIFO中断模式逐点填充时使用）
+ * 每dac_block_size个点更新一次调制参数，与DMA模式的块节拍一致
+ */
+static inline uint16_t dac_next_sample(void)
+{
+    uint16_t sample;
+
+    if (++mod_sample_count >= dac_block_size) {
+        mod_sample_count = 0;
+        dac_modulation_step();
+    }
+    dac_fill(&sample, 1);
+    if (envelope_mode != DAC_ENVELOPE_NONE) {
+        dac_apply_envelope(&sample, 1);
+    }
+    return sample;
+}
+
+/**
+ * @brief 当前波形的源表(Q15)
+ */
+static const int16_t *dac_wave_source(void)
+{
+    if (current_wave < DAC_WAVE_USER0) {
+        return builtin_tables[current_wave];
+    }
+    return user_tables[current_wave - DAC_WAVE_USER0];
+}
+
+/**
+ * @brief 按当前波形、幅度、偏移和校正表生成播放表
+ * 运行中重新生成时直接覆盖播放表，最多有一个周期为新旧波形的混合
+ */
+static void dac_render_play_table(void)
+{
+    // mV换算为码值：x 4095 / 3300，四舍五入
+    int32_t amplitude = ((int32_t)current_amplitude_mv * DAC_MAX_VALUE + 1650) / 3300;
+    int32_t offset = ((int32_t)current_offset_mv * DAC_MAX_VALUE + 1650) / 3300;
+    const int16_t *source = dac_wave_source();
+
+    for (int i = 0; i < WAVE_TABLE_SIZE; i++) {
+        int32_t sample = (source != NULL) ? source[i] : dac_quarter_sine((uint8_t)i);
+        int32_t code = offset + ((amplitude * sample) >> 15);
+        if (code < 0) code = 0;
+        if (code > DAC_MAX_VALUE) code = DAC_MAX_VALUE;
+        // 校正在生成表时一次完成，中断中直接输出表值
+        play_table[i] = DAC_correctCode((uint16_t)code);
+    }
+
+    int32_t mid = (offset > DAC_MAX_VALUE) ? DAC_MAX_VALUE : offset;
+    play_mid_code = DAC_correctCode((uint16_t)mid);
+}
+
+/**
+ * @brief 选择输出波形（运行中可切换，播放路径不变）
+ * @param wave 波形类型
+ * @param amplitude_mv 峰值幅度(mV)
+ * @param offset_mv 直流偏移(mV)，超出0~3.3V的部分被削顶
+ * @return true: 设置成功, false: 参数无效或用户槽位为空
+ */
+bool DAC_selectWaveform(dac_waveform_t wave, uint16_t amplitude_mv, uint16_t offset_mv)
+{
+    if (wave >= DAC_WAVE_COUNT) {
+        return false;
+    }
+    if (wave >= DAC_WAVE_USER0 && user_tables[wave - DAC_WAVE_USER0] == NULL) {
+        return false;
+    }
+
+    current_wave = wave;
+    current_amplitude_mv = amplitude_mv;
+    current_offset_mv = offset_mv;
+    dac_render_play_table();
+
+    // 带跳变的波形插值会把边沿变成斜坡，直接取表；选择波形同时结束回放
+    replay_active = false;
+    if (wave == DAC_WAVE_SQUARE || wave == DAC_WAVE_SAWTOOTH || wave == DAC_WAVE_NOISE) {
+        dac_fill = dac_fill_nearest;
+    } else {
+        dac_fill = dac_fill_interpolated;
+    }
+    return true;
+}
+
+/**
+ * @brief 获取当前波形类型
+ */
+dac_waveform_t DAC_getWaveform(void)
+{
+    return current_wave;
+}
+
+/**
+ * @brief 登记用户波形表（由波形上传模块调用）
+ * @param slot 槽位号
+ * @param table WAVE_TABLE_SIZE点Q15数据，需在使用期间保持有效；NULL时清除
+ */
+void DAC_setUserWaveform(uint8_t slot, const int16_t *table)
+{
+    if (slot >= DAC_USER_WAVE_SLOTS) {
+        return;
+    }
+
+    user_tables[slot] = table;
+    if (current_wave == (dac_waveform_t)(DAC_WAVE_USER0 + slot)) {
+        if (table == NULL) {
+            current_wave = DAC_WAVE_SINE;  // 正在播放的槽位被清除时回到正弦
+            if (dac_fill != dac_fill_replay && dac_fill != dac_fill_multitone) {
+                dac_fill = dac_fill_interpolated;
+            }
+        }
+        dac_render_play_table();
+    }
+}
+
+/**
+ * @brief 设置DAC校正表（由校准模块加载或生成）
+ * @param table DAC_CORRECTION_POINTS个节点，NULL时关闭校正
+ */
+void DAC_setCorrectionTable(const uint16_t *table)
+{
+    if (table == NULL) {
+        correction_enabled = false;
+    } else {
+        for (int i = 0; i < DAC_CORRECTION_POINTS; i++) {
+            correction_table[i] = table[i];
+        }
+        correction_enabled = true;
+    }
+
+    // 播放表中的码值已按旧校正表换算，需重新生成
+    dac_render_play_table();
+    if (dac_fill == dac_fill_multitone) {
+        play_mid_code = DAC_correctCode((uint16_t)multitone_offset);
+    }
+}
+
+/**
+ * @brief 理想码值换算为校正后的码值（分段线性插值，只用整数运算）
+ * @param ideal_code 理想码值 (0 ~ 4095)
+ * @return 实际写入DAC的码值
+ */
+uint16_t DAC_correctCode(uint16_t ideal_code)
+{
+    if (ideal_code > DAC_MAX_VALUE) {
+        ideal_code = DAC_MAX_VALUE;
+    }
+    if (!correction_enabled) {
+        return ideal_code;
+    }
+
+    uint16_t index = ideal_code >> DAC_CORRECTION_SHIFT;
+    int32_t frac = ideal_code & (DAC_CORRECTION_STEP - 1);
+    int32_t low = correction_table[index];
+    int32_t high = correction_table[index + 1];
+    int32_t code = low + (((high - low) * frac) >> DAC_CORRECTION_SHIFT);
+
+    if (code < 0) code = 0;
+    if (code > DAC_MAX_VALUE) code = DAC_MAX_VALUE;
+    return (uint16_t)code;
+}
+
+/**
+ * @brief 启动采样触发
+ */
+static void dac_trigger_start(void)
+{
+    if (dac_use_timer_trigger) {
+        DL_TimerG_startCounter(DAC_TRIGGER_TIMER);
+    } else {
+        DL_DAC12_enableSampleTimeGenerator(DAC_INST);
+    }
+}
+
+/**
+ * @brief 停止采样触发
+ */
+static void dac_trigger_stop(void)
+{
+    if (dac_use_timer_trigger) {
+        DL_TimerG_stopCounter(DAC_TRIGGER_TIMER);
+    } else {
+        DL_DAC12_disableSampleTimeGenerator(DAC_INST);
+    }
+}
+
+/**
+ * @brief 配置TIMG7按给定速率发布零点事件，DAC订阅该事件作为FIFO触发
+ * 16位计数器：32MHz时钟覆盖489Hz以上，更低速率改用1MHz时钟
+ * @return 实际采样率(Hz)
+ */
+static uint32_t dac_configure_trigger_timer(uint32_t rate_hz)
+{
+    uint32_t clock_hz = DAC_TRIGGER_TIMER_CLOCK_HZ;
+    uint8_t prescale = 0;
+
+    if (rate_hz < DAC_TRIGGER_TIMER_CLOCK_HZ / 65536U + 1U) {
+        prescale = 31;
+        clock_hz = DAC_TRIGGER_TIMER_CLOCK_HZ / 32U;
+    }
+
+    DL_TimerG_ClockConfig clock_config = {
+        .clockSel    = DL_TIMER_CLOCK_BUSCLK,
+        .divideRatio = DL_TIMER_CLOCK_DIVIDE_1,
+        .prescale    = prescale
+    };
+    uint32_t period = (clock_hz + rate_hz / 2U) / rate_hz;
+    DL_TimerG_TimerConfig timer_config = {
+        .period     = period - 1U,
+        .timerMode  = DL_TIMER_TIMER_MODE_PERIODIC,
+        .startTimer = DL_TIMER_STOP,
+    };
+
+    DL_TimerG_reset(DAC_TRIGGER_TIMER);
+    DL_TimerG_enablePower(DAC_TRIGGER_TIMER);
+    delay_cycles(16);  // 外设上电等待
+    DL_TimerG_setClockConfig(DAC_TRIGGER_TIMER, &clock_config);
+    DL_TimerG_initTimerMode(DAC_TRIGGER_TIMER, &timer_config);
+    DL_TimerG_enableEvent(DAC_TRIGGER_TIMER, DL_TIMER_EVENT_ROUTE_1, DL_TIMER_EVENT_ZERO_EVENT);
+    DL_TimerG_setPublisherChanID(DAC_TRIGGER_TIMER, DL_TIMER_PUBLISHER_INDEX_0, DAC_TRIGGER_EVENT_CHANNEL);
+    DL_TimerG_enableClock(DAC_TRIGGER_TIMER);
+
+    return (clock_hz + period / 2U) / period;
+}
+
+/**
+ * @brief 设置DAC采样率（运行中可修改，短暂停止送数后继续，相位连续）
+ * 与采样定时器档位相同时使用DAC内部定时器，否则使用TIMG7触发
+ * 块大小随采样率调整：高采样率用大块，补充中断频率不超过约1.6kHz
+ * 输出频率保持不变；正在进行的扫频和包络按旧采样率计算，一并取消
+ * @param rate_hz 采样率 (DAC_MIN_SAMPLE_RATE_HZ ~ DAC_MAX_SAMPLE_RATE_HZ)
+ * @return true: 设置成功, false: 超出范围或当前输出频率不低于新的奈奎斯特频率
  */
-void DAC_generateSineTable(void)
+bool DAC_setSampleRate(uint32_t rate_hz)
 {
-    for (int i = 0; i < SINE_TABLE_SIZE; i++) {
-        // 生成0到3.3V的正弦波（全正值）
-        // sin(2πi/N) 范围是-1到1，转换为0到1，再映射到0-4095
-        float angle = 2.0f * M_PI * i / SINE_TABLE_SIZE;
-        float sine_value = (sin(angle) + 1.0f) / 2.0f;  // 转换为0-1范围
-        sine_table[i] = (uint16_t)(sine_value * DAC_MAX_VALUE);
+    if (rate_hz < DAC_MIN_SAMPLE_RATE_HZ || rate_hz > DAC_MAX_SAMPLE_RATE_HZ) {
+        return false;
+    }
+    if (dds_frequency_mhz >= rate_hz * 500U) {
+        return false;
     }
+    if (dac_fill == dac_fill_multitone) {
+        for (uint8_t t = 0; t < multitone_count; t++) {
+            if (multitone[t].frequency_mhz >= rate_hz * 500U) {
+                return false;
+            }
+        }
+    }
+
+    const dac_rate_preset_t *preset = NULL;
+    for (uint8_t i = 0; i < sizeof(dac_rate_presets) / sizeof(dac_rate_presets[0]); i++) {
+        if (dac_rate_presets[i].rate_hz == rate_hz) {
+            preset = &dac_rate_presets[i];
+            break;
+        }
+    }
+
+    // 暂停触发和送数（空闲时触发同样在运行）
+    bool running = dac_running;
+    dac_trigger_stop();
+#if DAC_USE_DMA
+    if (running) {
+        DL_DMA_disableChannel(DMA, DAC_DMA_CHANNEL);
+    }
+#endif
+    if (dac_use_timer_trigger && preset != NULL) {
+        DL_TimerG_disablePower(DAC_TRIGGER_TIMER);
+    }
+
+    // 切换FIFO触发源需要在DAC关闭时重新初始化
+    DL_DAC12_disable(DAC_INST);
+    if (preset != NULL) {
+        dac_config.fifoTriggerSource = DL_DAC12_FIFO_TRIGGER_SAMPLETIMER;
+        dac_config.sampleTimeGeneratorEnable = DL_DAC12_SAMPLETIMER_DISABLE;
+        dac_config.sampleRate = preset->setting;
+        dac_use_timer_trigger = false;
+    } else {
+        dac_config.fifoTriggerSource = DL_DAC12_FIFO_TRIGGER_HWTRIG0;
+        dac_config.sampleTimeGeneratorEnable = DL_DAC12_SAMPLETIMER_DISABLE;
+        rate_hz = dac_configure_trigger_timer(rate_hz);
+        dac_use_timer_trigger = true;
+    }
+    DL_DAC12_init(DAC_INST, &dac_config);
+    if (dac_use_timer_trigger) {
+        DL_DAC12_setSubscriberChanID(DAC_INST, DL_DAC12_SUBSCRIBER_INDEX_0, DAC_TRIGGER_EVENT_CHANNEL);
+    }
+    DL_DAC12_enable(DAC_INST);
+
+    // 采样率相关的派生量
+    sweep_active = false;
+    DAC_clearEnvelope();
+    dac_sample_rate_hz = rate_hz;
+    dac_block_size = (rate_hz > DAC_DMA_LARGE_BLOCK_RATE_HZ) ? DAC_DMA_BLOCK_SIZE_MAX : DAC_DMA_BLOCK_SIZE;
+    mod_sample_count = 0;
+    dds_tuning_word = dac_tuning_word(dds_frequency_mhz);
+    if (replay_active) {
+        replay_step_q16 = dac_replay_step();   // 回放速度保持不变
+    }
+    for (uint8_t t = 0; t < multitone_count; t++) {
+        multitone[t].tuning = dac_tuning_word(multitone[t].frequency_mhz);
+    }
+
+#if DAC_USE_DMA
+    DL_DMA_setSrcAddr(DMA, DAC_DMA_CHANNEL, (uint32_t)&dma_buffer[0]);
+    DL_DMA_setTransferSize(DMA, DAC_DMA_CHANNEL, dac_block_size * 2);
+#endif
+
+    if (running) {
+#if DAC_USE_DMA
+        dac_produce_block(&dma_buffer[0], dac_block_size);
+        dac_produce_block(&dma_buffer[dac_block_size], dac_block_size);
+        DL_DMA_enableChannel(DMA, DAC_DMA_CHANNEL);
+#endif
+        // 暂停期间的FIFO取空不计入欠载
+        DL_DAC12_clearInterruptStatus(DAC_INST, DL_DAC12_INTERRUPT_FIFO_EMPTY);
+    }
+    // 引擎空闲时编码器/斜坡的静态设定值也经FIFO按采样触发输出，无论是否运行都要重新启动触发
+    dac_trigger_start();
+    return true;
+}
+
+/**
+ * @brief 获取实际采样率(Hz)
+ */
+uint32_t DAC_getSampleRate(void)
+{
+    return dac_sample_rate_hz;
 }
 
 /**
- * @brief 启动正弦波输出
+ * @brief 启动波形引擎（当前选择的波形、回放或多音）
+ * 上电后DAC由编码器/斜坡模块直接写入静态设定值；启动后由DMA/FIFO补充路径独占DAC，
+ * 频率、扫频、包络、波形和多音的设置从此开始出现在输出上，停止后交还静态设定值
  */
 void DAC_startSineWave(void)
 {
@@ -58,43 +834,39 @@ void DAC_startSineWave(void)
         return; // 已经在运行
     }
     
-    sine_index = 0;
+    dds_phase = 0;
     dac_running = true;
     
-    user_uart_send_string("DAC: Starting sine wave\r\n");
-    
-    // 基本输出测试
-    DL_DAC12_output12(DAC_INST, 2048);
-    user_uart_send_string("DAC: Basic test output\r\n");
-    delay_ms(10);
-    
+#if DAC_USE_DMA
+    // 先生成整个乒乓缓冲区，之后由DMA半程/完成中断交替补充
+    dac_produce_block(&dma_buffer[0], dac_block_size);
+    dac_produce_block(&dma_buffer[dac_block_size], dac_block_size);
+    DL_DMA_enableChannel(DMA, DAC_DMA_CHANNEL);
+#else
     // 清除中断标志
     DL_DAC12_clearInterruptStatus(DAC_INST, DL_DAC12_INTERRUPT_FIFO_ONE_QTR_EMPTY);
-    user_uart_send_string("DAC: Cleared interrupts\r\n");
     
     // 填充FIFO初始数据
-    user_uart_send_string("DAC: Filling FIFO\r\n");
-    for (int i = 0; i < 4 && i < SINE_TABLE_SIZE; i++) {
+    for (int i = 0; i < 4 && i < WAVE_TABLE_SIZE; i++) {
         if (!DL_DAC12_isFIFOFull(DAC_INST)) {
-            DL_DAC12_output12(DAC_INST, sine_table[sine_index]);
-            sine_index = (sine_index + 1) % SINE_TABLE_SIZE;
+            DL_DAC12_output12(DAC_INST, dac_next_sample());
         }
     }
-    user_uart_send_string("DAC: FIFO filled\r\n");
     
     // 确保中断启用（即使配置中已设置）
     DL_DAC12_enableInterrupt(DAC_INST, DL_DAC12_INTERRUPT_FIFO_ONE_QTR_EMPTY);
-    user_uart_send_string("DAC: Interrupt enabled\r\n");
+#endif
     
-    // 启动采样定时器（即使配置中已设置）
-    DL_DAC12_enableSampleTimeGenerator(DAC_INST);
-    user_uart_send_string("DAC: Sample timer started\r\n");
+    // 停止期间FIFO已被取空，从此处开始统计
+    DAC_resetHealth();
     
-    user_uart_send_string("DAC: Auto mode ready\r\n");
+    // 启动采样触发（DAC采样定时器或TIMG7）
+    dac_trigger_start();
 }
 
 /**
- * @brief 停止正弦波输出
+ * @brief 停止波形引擎，DAC交还给编码器/斜坡的静态设定值
+ * 采样触发保持运行：静态设定值同样经FIFO输出，由斜坡模块在引擎停止后重新写入
  */
 void DAC_stopSineWave(void)
 {
@@ -102,38 +874,71 @@ void DAC_stopSineWave(void)
         return; // 已经停止
     }
     
-    // 停止采样定时器
-    DL_DAC12_disableSampleTimeGenerator(DAC_INST);
-    
-    // 禁用中断
+    // 停止送数（采样触发不停）
+#if DAC_USE_DMA
+    DL_DMA_disableChannel(DMA, DAC_DMA_CHANNEL);
+#else
     DL_DAC12_disableInterrupt(DAC_INST, DL_DAC12_INTERRUPT_FIFO_ONE_QTR_EMPTY);
+#endif
     
-    // 等待FIFO处理完成（简单延时）
-    for (volatile int i = 0; i < 1000; i++) {
-        // 简单延时等待
-    }
-    
-    // 输出0V
-    DL_DAC12_output12(DAC_INST, 0);
-    
+    // FIFO中剩余的样本由采样触发照常输出，之后由斜坡模块写入的设定值接上，无需等待
     dac_running = false;
-    user_uart_send_string("DAC: Auto sine wave stopped\r\n");
 }
 
 /**
- * @brief 检查DAC状态（调试用）
+ * @brief 波形输出是否正在运行
+ */
+bool DAC_isRunning(void)
+{
+    return dac_running;
+}
+
+/**
+ * @brief 检查DAC状态并发送健康帧
  */
 void DAC_checkStatus(void)
 {
     char msg[100];
+    dac_health_t health;
     
     bool dac_enabled = DL_DAC12_isEnabled(DAC_INST);
     bool fifo_full = DL_DAC12_isFIFOFull(DAC_INST);
     bool sample_timer_enabled = DL_DAC12_isSampleTimeGeneratorEnabled(DAC_INST);
     
-    snprintf(msg, sizeof(msg), "DAC Status: EN=%d, FIFO_FULL=%d, TIMER=%d, INT_CNT=%u\r\n", 
-             dac_enabled, fifo_full, sample_timer_enabled, (unsigned int)interrupt_count);
+    snprintf(msg, sizeof(msg), "DAC Status: EN=%d, FIFO_FULL=%d, TIMER=%d, RATE=%lu\r\n", 
+             dac_enabled, fifo_full, sample_timer_enabled, (unsigned long)dac_sample_rate_hz);
     user_uart_send_string(msg);
+
+    DAC_getHealth(&health);
+    firewater_send_dac_health(health.refills, health.underruns, health.late_refills,
+                              health.max_latency_us);
+}
+
+/**
+ * @brief 读取波形引擎健康计数
+ */
+void DAC_getHealth(dac_health_t *health)
+{
+    if (health == NULL) {
+        return;
+    }
+    health->refills = health_refills;
+    health->underruns = health_underruns;
+    health->late_refills = health_late_refills;
+    health->max_latency_us = (uint32_t)(((uint64_t)health_max_latency_samples * 1000000U) /
+                                        dac_sample_rate_hz);
+}
+
+/**
+ * @brief 清零健康计数（同时清除FIFO空标志，之前的取空不再计入）
+ */
+void DAC_resetHealth(void)
+{
+    health_refills = 0;
+    health_underruns = 0;
+    health_late_refills = 0;
+    health_max_latency_samples = 0;
+    DL_DAC12_clearInterruptStatus(DAC_INST, DL_DAC12_INTERRUPT_FIFO_EMPTY);
 }
 
 /**
@@ -141,27 +946,316 @@ void DAC_checkStatus(void)
  */
 void DAC_manualUpdate(void)
 {
-    if (!dac_running) {
+    // DMA模式下FIFO只由DMA写入
+    if (!dac_running || DAC_USE_DMA) {
         return;
     }
     
     // 如果FIFO不满，填充数据
     while (!DL_DAC12_isFIFOFull(DAC_INST)) {
-        DL_DAC12_output12(DAC_INST, sine_table[sine_index]);
-        sine_index = (sine_index + 1) % SINE_TABLE_SIZE;
+        DL_DAC12_output12(DAC_INST, dac_next_sample());
+    }
+}
+
+/**
+ * @brief 设置正弦波频率（DDS调谐字，采样率保持不变）
+ * 调谐字 = f / fs x 2^32，分辨率 fs / 2^32 约为1.9uHz；运行中修改时相位连续
+ * @param frequency_mhz 输出频率(mHz)，0为直流，需低于奈奎斯特频率
+ * @return true: 设置成功, false: 频率超出范围
+ */
+bool DAC_setSineFrequency(uint32_t frequency_mhz)
+{
+    if (frequency_mhz >= dac_sample_rate_hz * 500U) {
+        return false;
+    }
+
+    // 固定频率取代正在进行的扫频
+    sweep_active = false;
+    // 一次32位写入，中断中读到的总是完整值
+    dds_tuning_word = dac_tuning_word(frequency_mhz);
+    dds_frequency_mhz = frequency_mhz;
+    return true;
+}
+
+/**
+ * @brief 获取当前正弦波频率(mHz)，扫频时为当前瞬时频率
+ */
+uint32_t DAC_getSineFrequency(void)
+{
+    if (sweep_active) {
+        return (uint32_t)(((uint64_t)dds_tuning_word * (dac_sample_rate_hz * 1000U)) >> 32);
     }
+    return dds_frequency_mhz;
 }
 
 /**
- * @brief 设置正弦波频率（通过调整采样率）
- * @param sample_rate 采样率 (Hz)
+ * @brief 启动扫频（调谐字每块更新，相位连续）
+ * @param mode 线性或对数
+ * @param start_mhz 起始频率(mHz)，对数扫频时不能为0
+ * @param stop_mhz 终止频率(mHz)，可低于起始频率（向下扫）
+ * @param duration_ms 单次扫频时长，不短于一块
+ * @param repeat true: 到达终止频率后从起始频率重新开始, false: 停在终止频率
+ * @return true: 启动成功, false: 参数无效
  */
-void DAC_setSineFrequency(uint32_t sample_rate)
+bool DAC_startSweep(dac_sweep_mode_t mode, uint32_t start_mhz, uint32_t stop_mhz,
+                    uint32_t duration_ms, bool repeat)
 {
-    // 注意：这个函数需要重新配置采样定时器
-    // 对于当前的8kHz固定配置，这个函数暂时不实现
-    // 如果需要动态调整频率，需要重新配置DAC的采样定时器
-    (void)sample_rate; // 避免未使用参数警告
+    uint32_t nyquist_mhz = dac_sample_rate_hz * 500U;
+    uint32_t blocks = dac_blocks_for_ms(duration_ms);
+
+    if (start_mhz >= nyquist_mhz || stop_mhz >= nyquist_mhz || blocks == 0) {
+        return false;
+    }
+
+    uint32_t start_tuning = dac_tuning_word(start_mhz);
+    uint32_t stop_tuning = dac_tuning_word(stop_mhz);
+    int32_t ratio_q30 = 0;
+    int64_t step_q16 = 0;
+
+    if (mode == DAC_SWEEP_LOG) {
+        if (start_mhz == 0 || stop_mhz == 0) {
+            return false;
+        }
+        // 每块倍率 r = 2^(log2(f1/f0) / N)，只在启动时用整数运算计算一次；
+        // 限制r < 2（每块log2小于1）使(r-1)在Q30内
+        int64_t span_q30 = dac_log2_q30(stop_mhz) - dac_log2_q30(start_mhz);
+        int64_t half = (span_q30 < 0) ? -(int64_t)(blocks / 2) : (int64_t)(blocks / 2);
+        int64_t per_block_q30 = (span_q30 + half) / (int64_t)blocks;
+        if (per_block_q30 >= (1LL << 30)) {
+            return false;
+        }
+        ratio_q30 = (int32_t)(dac_exp2_q30(per_block_q30) - (1LL << 30));
+    } else {
+        step_q16 = (((int64_t)stop_tuning - (int64_t)start_tuning) * 65536) / (int64_t)blocks;
+    }
+
+    sweep_active = false;   // 配置期间中断不使用扫频参数
+    sweep_log = (mode == DAC_SWEEP_LOG);
+    sweep_repeat = repeat;
+    sweep_ratio_q30 = ratio_q30;
+    sweep_step_q16 = step_q16;
+    sweep_start_tuning = start_tuning;
+    sweep_stop_tuning = stop_tuning;
+    sweep_blocks = blocks;
+    sweep_remaining = blocks;
+    sweep_tuning_q16 = (uint64_t)start_tuning << 16;
+    dds_tuning_word = start_tuning;
+    dds_frequency_mhz = stop_mhz;   // 扫频结束后停在终止频率
+    sweep_active = true;
+    return true;
+}
+
+/**
+ * @brief 停止扫频，保持当前瞬时频率
+ */
+void DAC_stopSweep(void)
+{
+    if (!sweep_active) {
+        return;
+    }
+    sweep_active = false;
+    dds_frequency_mhz = (uint32_t)(((uint64_t)dds_tuning_word * (dac_sample_rate_hz * 1000U)) >> 32);
+}
+
+/**
+ * @brief 是否正在扫频（单次扫频到达终止频率后返回false）
+ */
+bool DAC_isSweeping(void)
+{
+    return sweep_active;
+}
+
+/**
+ * @brief 设置正弦调幅包络：增益在(1 - depth)到1之间按调制频率变化
+ * @param modulation_mhz 调制频率(mHz)，需低于块更新率的一半
+ * @param depth_percent 调制深度 (0 ~ 100)
+ * @return true: 设置成功, false: 参数无效
+ */
+bool DAC_setAmEnvelope(uint32_t modulation_mhz, uint8_t depth_percent)
+{
+    // 块更新率 = 采样率 / 块大小
+    uint64_t block_rate_mhz = ((uint64_t)dac_sample_rate_hz * 1000U) / dac_block_size;
+    if (depth_percent > 100 || modulation_mhz >= block_rate_mhz / 2U) {
+        return false;
+    }
+
+    envelope_mode = DAC_ENVELOPE_NONE;
+    envelope_depth_q15 = ((int32_t)depth_percent * 32768) / 100;
+    envelope_tuning = (uint32_t)((((uint64_t)modulation_mhz << 32) + block_rate_mhz / 2U) /
+                                 block_rate_mhz);
+    envelope_phase = 0;
+    envelope_mode = DAC_ENVELOPE_AM;
+    return true;
+}
+
+/**
+ * @brief 设置斜坡包络：增益在给定时长内从from线性变到to，之后保持
+ * @return true: 设置成功, false: 参数无效
+ */
+bool DAC_setRampEnvelope(uint8_t from_percent, uint8_t to_percent, uint32_t duration_ms)
+{
+    if (from_percent > 100 || to_percent > 100) {
+        return false;
+    }
+
+    uint32_t blocks = dac_blocks_for_ms(duration_ms);
+    int32_t from_q30 = (int32_t)(((int64_t)from_percent << 30) / 100);
+    int32_t to_q30 = (int32_t)(((int64_t)to_percent << 30) / 100);
+
+    envelope_mode = DAC_ENVELOPE_NONE;
+    envelope_ramp_q30 = from_q30;
+    envelope_target_q30 = to_q30;
+    envelope_step_q30 = (blocks > 0) ? (to_q30 - from_q30) / (int32_t)blocks : 0;
+    envelope_remaining = blocks;
+    envelope_gain_q15 = from_q30 >> 15;
+    envelope_mode = DAC_ENVELOPE_RAMP;
+    return true;
+}
+
+/**
+ * @brief 开始回放一段记录数据（取代当前波形，沿用DMA/FIFO补充路径）
+ * @param codes 已换算并校正的DAC码值，回放期间需保持有效
+ * @param count 记录点数 (2 ~ 65535)
+ * @param source_rate_hz 记录时的采样率
+ * @param speed_percent 回放速度，100为原速；步进超过每采样点一个记录点时跳点
+ * @param loop true: 循环回放, false: 单次回放后保持最后一点
+ * @return true: 开始回放, false: 参数无效
+ */
+bool DAC_startReplay(const uint16_t *codes, uint16_t count, uint32_t source_rate_hz,
+                     uint16_t speed_percent, bool loop)
+{
+    if (codes == NULL || count < 2 || source_rate_hz == 0 || speed_percent == 0) {
+        return false;
+    }
+
+    replay_active = false;
+    dac_fill = dac_fill_interpolated;   // 配置期间补充中断不读回放参数
+    replay_codes = codes;
+    replay_length_q16 = (uint32_t)count << 16;
+    replay_position_q16 = 0;
+    replay_source_rate_hz = source_rate_hz;
+    replay_speed_percent = speed_percent;
+    replay_step_q16 = dac_replay_step();
+    replay_loop = loop;
+    replay_active = true;
+    dac_fill = dac_fill_replay;
+    return true;
+}
+
+/**
+ * @brief 停止回放，恢复当前选择的波形
+ */
+void DAC_stopReplay(void)
+{
+    if (dac_fill != dac_fill_replay) {
+        return;
+    }
+    replay_active = false;
+    DAC_selectWaveform(current_wave, current_amplitude_mv, current_offset_mv);
+}
+
+/**
+ * @brief 是否正在回放（单次回放结束后返回false）
+ */
+bool DAC_isReplaying(void)
+{
+    return replay_active;
+}
+
+/**
+ * @brief 开始多音输出（取代当前波形，沿用DMA/FIFO补充路径，包络仍然有效）
+ * 幅度之和超过偏移到0或满量程的较小距离时，所有音按同一比例缩小，保持相对电平
+ * @param tones 各音参数，幅度为0的音被跳过
+ * @param count 音数 (1 ~ DAC_MULTITONE_MAX)
+ * @param offset_mv 直流偏移(mV)
+ * @return true: 开始输出, false: 参数无效或频率不低于奈奎斯特频率
+ */
+bool DAC_startMultitone(const dac_tone_t *tones, uint8_t count, uint16_t offset_mv)
+{
+    if (tones == NULL || count == 0 || count > DAC_MULTITONE_MAX) {
+        return false;
+    }
+
+    int32_t offset = ((int32_t)offset_mv * DAC_MAX_VALUE + 1650) / 3300;
+    if (offset > DAC_MAX_VALUE) {
+        return false;
+    }
+
+    dac_oscillator_t oscillators[DAC_MULTITONE_MAX];
+    uint8_t active = 0;
+    int32_t total = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (tones[i].frequency_mhz >= dac_sample_rate_hz * 500U) {
+            return false;
+        }
+        if (tones[i].amplitude_mv == 0) {
+            continue;
+        }
+        dac_oscillator_t *osc = &oscillators[active++];
+        osc->frequency_mhz = tones[i].frequency_mhz;
+        osc->tuning = dac_tuning_word(tones[i].frequency_mhz);
+        osc->phase = (uint32_t)(((uint64_t)(tones[i].phase_deg % 360U) << 32) / 360U);
+        osc->amplitude = ((int32_t)tones[i].amplitude_mv * DAC_MAX_VALUE + 1650) / 3300;
+        total += osc->amplitude;
+    }
+
+    // 限幅保护：按偏移两侧较小的摆幅统一缩小
+    int32_t headroom = (offset < DAC_MAX_VALUE - offset) ? offset : DAC_MAX_VALUE - offset;
+    uint8_t scale_percent = 100;
+    if (total > headroom) {
+        for (uint8_t i = 0; i < active; i++) {
+            oscillators[i].amplitude = (int32_t)(((int64_t)oscillators[i].amplitude * headroom) / total);
+        }
+        scale_percent = (uint8_t)((headroom * 100) / total);
+    }
+
+    replay_active = false;
+    dac_fill = dac_fill_interpolated;   // 配置期间补充中断不读多音参数
+    for (uint8_t i = 0; i < active; i++) {
+        multitone[i] = oscillators[i];
+    }
+    multitone_count = active;
+    multitone_offset = offset;
+    multitone_scale_percent = scale_percent;
+    play_mid_code = DAC_correctCode((uint16_t)offset);  // 包络以偏移为中心缩放
+    dac_fill = dac_fill_multitone;
+    return true;
+}
+
+/**
+ * @brief 停止多音输出，恢复当前选择的波形
+ */
+void DAC_stopMultitone(void)
+{
+    if (dac_fill != dac_fill_multitone) {
+        return;
+    }
+    DAC_selectWaveform(current_wave, current_amplitude_mv, current_offset_mv);
+}
+
+/**
+ * @brief 是否正在多音输出
+ */
+bool DAC_isMultitone(void)
+{
+    return dac_fill == dac_fill_multitone;
+}
+
+/**
+ * @brief 最近一次启动多音输出时限幅保护的缩小比例(%)，100表示未缩小
+ */
+uint8_t DAC_getMultitoneScale(void)
+{
+    return multitone_scale_percent;
+}
+
+/**
+ * @brief 取消包络，恢复设定幅度
+ */
+void DAC_clearEnvelope(void)
+{
+    envelope_mode = DAC_ENVELOPE_NONE;
+    envelope_gain_q15 = 32768;
 }
 
 /**
@@ -172,23 +1266,58 @@ void DAC0_IRQHandler(void)
     // 检查是否是FIFO 1/4空中断
     uint32_t status = DL_DAC12_getInterruptStatus(DAC_INST, DL_DAC12_INTERRUPT_FIFO_ONE_QTR_EMPTY);
     if (status != 0) {
-        interrupt_count++;  // 增加中断计数
-        
         // FIFO 1/4空时，补充数据
         if (dac_running) {
+            health_refills++;
+            // 补充前检查：中断被其他中断推迟时FIFO可能已被取空
+            dac_check_underrun();
             // 填充FIFO直到满或者没有更多数据
             while (!DL_DAC12_isFIFOFull(DAC_INST)) {
-                DL_DAC12_output12(DAC_INST, sine_table[sine_index]);
-                sine_index = (sine_index + 1) % SINE_TABLE_SIZE;
+                DL_DAC12_output12(DAC_INST, dac_next_sample());
             }
         }
         // 清除中断标志
         DL_DAC12_clearInterruptStatus(DAC_INST, DL_DAC12_INTERRUPT_FIFO_ONE_QTR_EMPTY);
-        
-        // 每100次中断打印一次状态（仅用于调试）
-        if (interrupt_count % 100 == 0) {
-            // 在实际应用中，应避免在中断中使用串口
-            // 这里仅用于调试验证中断是否工作
-        }
     }
 }
+
+#if DAC_USE_DMA
+/**
+ * @brief DMA中断：半程时补充前半块，完成（自动重装）时补充后半块
+ */
+void DMA_IRQHandler(void)
+{
+    uint32_t block = dac_block_size;
+    uint32_t remaining;
+    uint32_t latency;
+
+    switch (DL_DMA_getPendingInterrupt(DMA)) {
+        case DL_DMA_FULL_CH_EVENT_IIDX_EARLY_IRQ_DMACH0:
+            // 半程事件时剩余block个，此后每搬运一个减1；大于block说明已回绕到前半块
+            remaining = DL_DMA_getTransferSize(DMA, DAC_DMA_CHANNEL);
+            latency = (remaining > block) ? block + (2U * block - remaining) : block - remaining;
+            if (remaining > block) {
+                health_late_refills++;
+            }
+            dac_produce_block(&dma_buffer[0], block);
+            break;
+        case DL_DMA_EVENT_IIDX_DMACH0:
+            // 重装后剩余2*block个；不大于block说明DMA已进入后半块
+            remaining = DL_DMA_getTransferSize(DMA, DAC_DMA_CHANNEL);
+            latency = 2U * block - remaining;
+            if (remaining <= block) {
+                health_late_refills++;
+            }
+            dac_produce_block(&dma_buffer[block], block);
+            break;
+        default:
+            return;
+    }
+
+    health_refills++;
+    if (latency > health_max_latency_samples) {
+        health_max_latency_samples = latency;
+    }
+    dac_check_underrun();
+}
+#endif
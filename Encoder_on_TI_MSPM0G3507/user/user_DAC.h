@@ -3,10 +3,16 @@
 
 #include "ti_msp_dl_config.h"
 #include <stdint.h>
-#include <math.h>
 
-// 正弦波表大小
-#define SINE_TABLE_SIZE 256
+// 波形表大小（一个周期的采样点数）
+#define WAVE_TABLE_SIZE 256
+#define WAVE_TABLE_BITS 8           // log2(WAVE_TABLE_SIZE)
+#define WAVE_QUARTER_SIZE   (WAVE_TABLE_SIZE / 4)   // 正弦四分之一周期表点数（另加一个端点）
+#define WAVE_INTERP_BITS    8       // 相邻表项间线性插值的小数位数（相位分辨率共16位）
+
+// DDS参数：32位相位累加器，高WAVE_TABLE_BITS位作为波形表索引
+#define DAC_DEFAULT_SAMPLE_RATE_HZ  8000    // 默认DAC采样率（SysConfig采样定时器8KSPS）
+#define DAC_DEFAULT_FREQ_MHZ    31250       // 默认输出频率(mHz)，与原来每次步进一格的31.25Hz一致
 
 // DAC分辨率 (12位)
 #define DAC_MAX_VALUE   4095
@@ -14,16 +20,105 @@
 // DAC实例定义（根据生成的配置）
 #define DAC_INST        DAC0
 
+// DMA送数：1时由DMA从乒乓缓冲区搬运到DAC FIFO，0时由FIFO 1/4空中断逐点填充
+#define DAC_USE_DMA             1
+#define DAC_DMA_CHANNEL         0           // 全功能通道（支持重复传输和半程中断）
+#define DAC_DMA_BLOCK_SIZE      32          // 每半个缓冲区的采样点数
+#define DAC_DMA_BLOCK_SIZE_MAX  128         // 高采样率时的块大小，限制补充中断频率
+#define DAC_DMA_LARGE_BLOCK_RATE_HZ 20000   // 采样率超过此值时使用大块
+#define DAC_DMA_BUFFER_SIZE     (DAC_DMA_BLOCK_SIZE_MAX * 2)
+
+// 采样率：与采样定时器档位相同时直接使用DAC内部定时器，其他速率由TIMG7经事件触发
+#define DAC_MIN_SAMPLE_RATE_HZ  100
+#define DAC_MAX_SAMPLE_RATE_HZ  200000      // 受补充中断的CPU占用限制（DAC本身最高1MSPS）
+#define DAC_TRIGGER_TIMER       TIMG7
+#define DAC_TRIGGER_EVENT_CHANNEL   2       // 一对一事件通道
+#define DAC_TRIGGER_TIMER_CLOCK_HZ  32000000U
+
+// 波形库：幅度和偏移以mV表示，默认0~3.3V满摆幅
+#define DAC_USER_WAVE_SLOTS     2           // 用户自定义波形槽位数
+#define DAC_DEFAULT_AMPLITUDE_MV    1650
+#define DAC_DEFAULT_OFFSET_MV       1650
+
+// 多音合成：最多DAC_MULTITONE_MAX个DDS振荡器叠加，幅度之和超出偏移两侧的可用摆幅时按比例缩小
+#define DAC_MULTITONE_MAX       4
+
+// 单个音的参数
+typedef struct {
+    uint32_t frequency_mhz;     // 频率(mHz)，需低于奈奎斯特频率
+    uint16_t amplitude_mv;      // 峰值幅度(mV)，0为不输出该音
+    uint16_t phase_deg;         // 初相(度)
+} dac_tone_t;
+
+// 扫频与包络：每块（与DMA块大小相同，8KSPS下32点即4ms）更新一次，逐点只做一次乘法
+
+// 扫频方式
+typedef enum {
+    DAC_SWEEP_LINEAR = 0,       // 频率随时间线性变化
+    DAC_SWEEP_LOG               // 频率按固定倍率变化（每倍频程时间相同）
+} dac_sweep_mode_t;
+
+// 波形类型
+typedef enum {
+    DAC_WAVE_SINE = 0,
+    DAC_WAVE_SQUARE,
+    DAC_WAVE_TRIANGLE,
+    DAC_WAVE_SAWTOOTH,
+    DAC_WAVE_NOISE,             // 伪随机噪声（每周期重复的256点序列）
+    DAC_WAVE_USER0,             // 用户波形槽位0
+    DAC_WAVE_USER1,             // 用户波形槽位1
+    DAC_WAVE_COUNT
+} dac_waveform_t;
+
+// 波形引擎健康计数（启动输出或复位计数后开始累计）
+typedef struct {
+    uint32_t refills;           // 补充次数（DMA半块或FIFO 1/4空中断）
+    uint32_t underruns;         // FIFO被取空的次数（输出保持旧值，波形出现台阶）
+    uint32_t late_refills;      // DMA已回绕到待补充的半块（播放了上一轮的旧数据）
+    uint32_t max_latency_us;    // 补充事件到中断开始处理的最大延迟（DMA模式）
+} dac_health_t;
+
+// DAC校正表：理想码值每隔DAC_CORRECTION_STEP一个节点，节点间线性插值
+#define DAC_CORRECTION_SHIFT    8
+#define DAC_CORRECTION_STEP     (1 << DAC_CORRECTION_SHIFT)
+#define DAC_CORRECTION_POINTS   ((DAC_MAX_VALUE + 1) / DAC_CORRECTION_STEP + 1)   // 17个节点
+
 // 函数声明
 void DAC_init(void);
-void DAC_generateSineTable(void);
 void DAC_startSineWave(void);
 void DAC_stopSineWave(void);
-void DAC_setSineFrequency(uint32_t sample_rate);
+bool DAC_isRunning(void);
+bool DAC_setSineFrequency(uint32_t frequency_mhz);
+uint32_t DAC_getSineFrequency(void);
+bool DAC_setSampleRate(uint32_t rate_hz);
+uint32_t DAC_getSampleRate(void);
 void DAC_manualUpdate(void);  // 添加手动更新函数
 void DAC_checkStatus(void);   // 添加状态检查函数
+void DAC_getHealth(dac_health_t *health);
+bool DAC_startReplay(const uint16_t *codes, uint16_t count, uint32_t source_rate_hz,
+                     uint16_t speed_percent, bool loop);
+void DAC_stopReplay(void);
+bool DAC_isReplaying(void);
+void DAC_resetHealth(void);
+bool DAC_startMultitone(const dac_tone_t *tones, uint8_t count, uint16_t offset_mv);
+void DAC_stopMultitone(void);
+bool DAC_isMultitone(void);
+uint8_t DAC_getMultitoneScale(void);
+void DAC_setCorrectionTable(const uint16_t *table);  // NULL时恢复理想输出
+uint16_t DAC_correctCode(uint16_t ideal_code);
+bool DAC_selectWaveform(dac_waveform_t wave, uint16_t amplitude_mv, uint16_t offset_mv);
+dac_waveform_t DAC_getWaveform(void);
+void DAC_setUserWaveform(uint8_t slot, const int16_t *table);  // WAVE_TABLE_SIZE点Q15，NULL时清除
+bool DAC_startSweep(dac_sweep_mode_t mode, uint32_t start_mhz, uint32_t stop_mhz,
+                    uint32_t duration_ms, bool repeat);
+void DAC_stopSweep(void);
+bool DAC_isSweeping(void);
+bool DAC_setAmEnvelope(uint32_t modulation_mhz, uint8_t depth_percent);
+bool DAC_setRampEnvelope(uint8_t from_percent, uint8_t to_percent, uint32_t duration_ms);
+void DAC_clearEnvelope(void);
 
 // 中断处理函数（使用生成的名称）
 void DAC0_IRQHandler(void);
+void DMA_IRQHandler(void);
 
 #endif /* USER_DAC_H */
@@ -2,6 +2,8 @@
 #include "user/user_DAC.h"
 #include "user/delay.h"
 #include "user/user_uart.h"
+#include "user/user_ramp.h"
+#include "user/firewater_protocol.h"
 
 // 编码器状态全局变量
 volatile encoder_state_t g_encoder_state = {
@@ -12,9 +14,39 @@ volatile encoder_state_t g_encoder_state = {
     .dac_value = 0
 };
 
+#if ENCODER_USE_QEI
+// QEI计数器时钟：直接使用BUSCLK，计数只由输入边沿推进
+static const DL_TimerG_ClockConfig g_qei_clock_config = {
+    .clockSel    = DL_TIMER_CLOCK_BUSCLK,
+    .divideRatio = DL_TIMER_CLOCK_DIVIDE_1,
+    .prescale    = 0U
+};
+
+#else
+// 状态转移表：下标为(上次状态 << 2) | 本次状态，状态 = (A << 1) | B
+// 顺时针 11->01->00->10->11 加1；两相同时变化为非法转移（抖动或漏掉了边沿）
+#define ENCODER_STEP_ILLEGAL    2
+static const int8_t g_quadrature_table[16] = {
+     0, -1,  1,  2,     // 00 -> 00 01 10 11
+     1,  0,  2, -1,     // 01 -> 00 01 10 11
+    -1,  2,  0,  1,     // 10 -> 00 01 10 11
+     2,  1, -1,  0      // 11 -> 00 01 10 11
+};
+
+static uint8_t g_gpio_state = 0;                // 上次的两相状态
+static volatile uint16_t g_gpio_position = 0;   // 中断中累计的边沿位置（只由中断写入）
+static volatile uint32_t g_gpio_glitches = 0;   // 丢弃的非法转移数
+#endif
+
+static uint16_t g_position_last = 0;            // 上次读取的边沿位置
+static int32_t g_edges = 0;                     // 不足一个计数的边沿数（带方向）
+static uint8_t g_edges_per_count = ENCODER_EDGES_PER_DETENT / ENCODER_DEFAULT_RESOLUTION;
+
 // 内部函数声明
 static void encoder_limit_count(void);
 static void encoder_update_voltage_and_dac(void);
+static uint16_t encoder_read_position(void);
+static void encoder_poll(void);
 
 /**
  * @brief 初始化旋转编码器
@@ -24,9 +56,33 @@ void user_encoder_init(void)
 {
     user_uart_send_string("Encoder initialized\r\n");
     
+#if ENCODER_USE_QEI
+    // 关闭SysConfig配置的GPIO中断，引脚改为TIMG8的捕获输入
+    DL_GPIO_disableInterrupt(ENCODER_PIN_A_PORT, ENCODER_PIN_A | ENCODER_PIN_B);
+    DL_GPIO_clearInterruptStatus(ENCODER_PIN_A_PORT, ENCODER_PIN_A | ENCODER_PIN_B);
+    DL_GPIO_initPeripheralInputFunctionFeatures(ENCODER_PIN_A_IOMUX, ENCODER_QEI_PHA_FUNC,
+         DL_GPIO_INVERSION_DISABLE, DL_GPIO_RESISTOR_PULL_UP,
+         DL_GPIO_HYSTERESIS_DISABLE, DL_GPIO_WAKEUP_DISABLE);
+    DL_GPIO_initPeripheralInputFunctionFeatures(ENCODER_PIN_B_IOMUX, ENCODER_QEI_PHB_FUNC,
+         DL_GPIO_INVERSION_DISABLE, DL_GPIO_RESISTOR_PULL_UP,
+         DL_GPIO_HYSTERESIS_DISABLE, DL_GPIO_WAKEUP_DISABLE);
+
+    // 双输入QEI：计数器在0~65535间按方向加减，回绕由读取时的16位差值处理
+    DL_TimerG_reset(ENCODER_QEI_TIMER);
+    DL_TimerG_enablePower(ENCODER_QEI_TIMER);
+    delay_cycles(16);  // 外设上电等待
+    DL_TimerG_setClockConfig(ENCODER_QEI_TIMER, (DL_TimerG_ClockConfig *)&g_qei_clock_config);
+    DL_TimerG_configQEI(ENCODER_QEI_TIMER, DL_TIMER_QEI_MODE_2_INPUT,
+        DL_TIMER_CC_INPUT_INV_NOINVERT, DL_TIMER_CC_0_INDEX);
+    DL_TimerG_configQEI(ENCODER_QEI_TIMER, DL_TIMER_QEI_MODE_2_INPUT,
+        DL_TIMER_CC_INPUT_INV_NOINVERT, DL_TIMER_CC_1_INDEX);
+    DL_TimerG_setLoadValue(ENCODER_QEI_TIMER, 0xFFFFU);
+    DL_TimerG_enableClock(ENCODER_QEI_TIMER);
+    DL_TimerG_startCounter(ENCODER_QEI_TIMER);
+#else
     // GPIO和中断配置已经在ti_msp_dl_config.c中完成，包括：
     // - PA17和PA24配置为数字输入，启用上拉电阻
-    // - 下降沿触发中断
+    // 这里改为两相双边沿触发
     
     // 重新配置引脚以确保设置正确
     DL_GPIO_initDigitalInputFeatures(ENCODER_PIN_A_IOMUX,
@@ -37,20 +93,27 @@ void user_encoder_init(void)
          DL_GPIO_INVERSION_DISABLE, DL_GPIO_RESISTOR_PULL_UP,
          DL_GPIO_HYSTERESIS_DISABLE, DL_GPIO_WAKEUP_DISABLE);
          
-    // 确保下降沿触发设置正确 - 只对PIN_A设置下降沿触发
-    DL_GPIO_setUpperPinsPolarity(GPIOA, DL_GPIO_PIN_17_EDGE_FALL);
+    // 两相的上升沿和下降沿都触发，由状态转移表判断方向
+    DL_GPIO_setUpperPinsPolarity(GPIOA, DL_GPIO_PIN_17_EDGE_RISE_FALL | DL_GPIO_PIN_24_EDGE_RISE_FALL);
     
     // 确保中断标志被清除
     DL_GPIO_clearInterruptStatus(ENCODER_PIN_A_PORT, ENCODER_PIN_A);
     DL_GPIO_clearInterruptStatus(ENCODER_PIN_B_PORT, ENCODER_PIN_B);
     
-    // 只启用PIN_A的GPIO中断，避免重复触发
-    DL_GPIO_enableInterrupt(ENCODER_PIN_A_PORT, ENCODER_PIN_A);
+    // 记录初始状态，第一个边沿即可正确判断方向
+    uint32_t pins = DL_GPIO_readPins(ENCODER_PIN_A_PORT, ENCODER_PIN_A | ENCODER_PIN_B);
+    g_gpio_state = (uint8_t)(((pins & ENCODER_PIN_A) ? 2U : 0U) | ((pins & ENCODER_PIN_B) ? 1U : 0U));
+    
+    DL_GPIO_enableInterrupt(ENCODER_PIN_A_PORT, ENCODER_PIN_A | ENCODER_PIN_B);
     
     // 手动配置NVIC中断（使用ENCODER_INT_IRQN，即GPIOA_INT_IRQn）
     NVIC_SetPriority(ENCODER_INT_IRQN, 1);  // 设置编码器中断优先级
     NVIC_ClearPendingIRQ(ENCODER_INT_IRQN);
     NVIC_EnableIRQ(ENCODER_INT_IRQN);       // 启用编码器NVIC中断
+#endif
+    
+    g_position_last = encoder_read_position();
+    g_edges = 0;
     
     // 初始化DAC值
     encoder_update_voltage_and_dac();
@@ -62,6 +125,7 @@ void user_encoder_init(void)
  */
 int16_t user_encoder_get_count(void)
 {
+    encoder_poll();
     return g_encoder_state.count;
 }
 
@@ -71,6 +135,7 @@ int16_t user_encoder_get_count(void)
  */
 bool user_encoder_is_changed(void)
 {
+    encoder_poll();
     bool changed = g_encoder_state.count_changed;
     if (changed) {
         g_encoder_state.count_changed = false;  // 清除标志
@@ -106,20 +171,20 @@ uint16_t user_encoder_voltage_to_dac(float voltage)
     
     uint16_t dac_value = (uint16_t)((voltage / 3.3f) * DAC_MAX_COUNT_VALUE);
     
-    return dac_value;
+    // 按校准结果修正DAC的增益、偏移和非线性
+    return DAC_correctCode(dac_value);
 }
 
 /**
  * @brief 更新DAC输出
- * 根据当前编码器计数值更新DAC输出电压
+ * 根据当前编码器计数值设置斜坡目标，DAC按设定压摆率过渡到新电压
  */
 void user_encoder_update_dac(void)
 {
-    // 更新电压和DAC值
+    // 更新电压和DAC值（dac_value为斜坡终点的校正后码值）
     encoder_update_voltage_and_dac();
     
-    // 设置DAC输出值
-    DL_DAC12_output12(DAC0, g_encoder_state.dac_value);
+    user_ramp_set_target_mv((uint16_t)(g_encoder_state.target_voltage * 1000.0f + 0.5f));
 }
 
 /**
@@ -141,6 +206,7 @@ void user_encoder_set_count(int16_t count)
 {
     g_encoder_state.count = count;
     encoder_limit_count();
+    g_encoder_state.last_count = g_encoder_state.count;    // 否则转到旧的last_count时这一步会被丢掉
     g_encoder_state.count_changed = true;
     encoder_update_voltage_and_dac();
 }
@@ -158,6 +224,113 @@ static void encoder_limit_count(void)
     }
 }
 
+/**
+ * @brief 设置每个定位格的计数值（1x/2x/4x），不足一个计数的边沿清零
+ * @return true: 设置成功, false: 不是1、2或4
+ */
+bool user_encoder_set_resolution(uint8_t counts_per_detent)
+{
+    if (counts_per_detent != 1 && counts_per_detent != 2 && counts_per_detent != 4) {
+        return false;
+    }
+    g_edges_per_count = ENCODER_EDGES_PER_DETENT / counts_per_detent;
+    g_position_last = encoder_read_position();
+    g_edges = 0;
+    return true;
+}
+
+/**
+ * @brief 获取每个定位格的计数值（1/2/4）
+ */
+uint8_t user_encoder_get_resolution(void)
+{
+    return (uint8_t)(ENCODER_EDGES_PER_DETENT / g_edges_per_count);
+}
+
+/**
+ * @brief 获取GPIO解码丢弃的非法转移数（QEI模式下为0）
+ */
+uint32_t user_encoder_get_glitches(void)
+{
+#if ENCODER_USE_QEI
+    return 0;
+#else
+    return g_gpio_glitches;
+#endif
+}
+
+/**
+ * @brief 发送计数值、分辨率和非法转移数
+ */
+void user_encoder_report(void)
+{
+    firewater_send_encoder(user_encoder_get_count(), user_encoder_get_resolution(),
+                           user_encoder_get_glitches());
+}
+
+#if !ENCODER_USE_QEI
+/**
+ * @brief GPIO解码：编码器任一相的任一边沿触发，查表得到方向（GROUP1中断中调用）
+ * 先清标志再读引脚，读之后的边沿会再次触发；抖动产生的+1/-1在累计位置中相互抵消
+ */
+void user_encoder_gpio_irq(void)
+{
+    DL_GPIO_clearInterruptStatus(ENCODER_PIN_A_PORT, ENCODER_PIN_A | ENCODER_PIN_B);
+
+    uint32_t pins = DL_GPIO_readPins(ENCODER_PIN_A_PORT, ENCODER_PIN_A | ENCODER_PIN_B);
+    uint8_t state = (uint8_t)(((pins & ENCODER_PIN_A) ? 2U : 0U) | ((pins & ENCODER_PIN_B) ? 1U : 0U));
+    int8_t step = g_quadrature_table[(g_gpio_state << 2) | state];
+
+    g_gpio_state = state;
+    if (step == ENCODER_STEP_ILLEGAL) {
+        g_gpio_glitches++;
+    } else {
+        g_gpio_position += (uint16_t)step;
+    }
+}
+#endif
+
+/**
+ * @brief 读取累计边沿位置（16位回绕）：QEI硬件计数器或GPIO中断的累计值
+ */
+static uint16_t encoder_read_position(void)
+{
+#if ENCODER_USE_QEI
+    return (uint16_t)DL_TimerG_getTimerCount(ENCODER_QEI_TIMER);
+#else
+    return g_gpio_position;
+#endif
+}
+
+/**
+ * @brief 把新增边沿折算为计数并更新计数值（主循环中调用）
+ * 位置只由硬件或中断写入、一次读出，无需关中断；两次读取之间不超过32767个边沿即不会丢计数
+ */
+static void encoder_poll(void)
+{
+    uint16_t now = encoder_read_position();
+
+    g_edges += (int16_t)(now - g_position_last);
+    g_position_last = now;
+
+    // 向零取整，余下的边沿留到下次（定位格之间的抖动来回抵消）
+    int32_t steps = g_edges / g_edges_per_count;
+    if (steps == 0) {
+        return;
+    }
+    g_edges -= steps * g_edges_per_count;
+
+    int32_t count = g_encoder_state.count + steps;
+    if (count < ENCODER_COUNT_MIN) count = ENCODER_COUNT_MIN;
+    if (count > ENCODER_COUNT_MAX) count = ENCODER_COUNT_MAX;
+    if (count != g_encoder_state.last_count) {
+        g_encoder_state.count = (int16_t)count;
+        g_encoder_state.last_count = (int16_t)count;
+        g_encoder_state.count_changed = true;
+        encoder_update_voltage_and_dac();
+    }
+}
+
 /**
  * @brief 更新电压值和DAC值
  */
@@ -24,6 +24,18 @@ extern "C" {
 #define ENCODER_PIN_B_PORT          ENCODER_PORT        // GPIOA  
 #define ENCODER_PIN_B               ENCODER_PIN_B_PIN   // DL_GPIO_PIN_24 (PA24)
 
+// 正交解码：1时由TIMG8的QEI模式硬件计数（两相的每个边沿加减1，不产生中断），
+// 0时两相双边沿GPIO中断查16项状态转移表解码（无延时消抖，非法转移丢弃）
+// QEI模式下PA17/PA24复用为TIMG8的CCP0/CCP1输入，SysConfig中编码器引脚不再需要GPIO中断
+#ifndef ENCODER_USE_QEI
+#define ENCODER_USE_QEI             1
+#endif
+#define ENCODER_QEI_TIMER           TIMG8       // MSPM0G350x中只有TIMG8支持QEI模式
+#define ENCODER_QEI_PHA_FUNC        IOMUX_PINCM39_PF_TIMG8_CCP0     // PA17 -> PHA
+#define ENCODER_QEI_PHB_FUNC        IOMUX_PINCM54_PF_TIMG8_CCP1     // PA24 -> PHB
+#define ENCODER_EDGES_PER_DETENT    4           // 每个定位格一个完整正交周期，即4个边沿
+#define ENCODER_DEFAULT_RESOLUTION  1           // 每个定位格的计数值：1/2/4
+
 // 编码器计数范围定义
 #define ENCODER_COUNT_MIN           0
 #define ENCODER_COUNT_MAX           33      // 0-3.3V，步进0.1V，共34个级别(0-33)
@@ -55,6 +67,11 @@ uint16_t user_encoder_voltage_to_dac(float voltage);
 void user_encoder_update_dac(void);
 void user_encoder_reset_count(void);
 void user_encoder_set_count(int16_t count);
+bool user_encoder_set_resolution(uint8_t counts_per_detent);
+uint8_t user_encoder_get_resolution(void);
+uint32_t user_encoder_get_glitches(void);
+void user_encoder_report(void);
+void user_encoder_gpio_irq(void);   // GPIO解码时由GROUP1中断调用
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,197 @@
+#include "user_adc_alarm.h"
+#include "user_ADC.h"
+#include "delay.h"
+#include "firewater_protocol.h"
+#include "user_power.h"
+#include <stddef.h>
+
+#define ADC_ALARM_QUEUE_MASK        (ADC_ALARM_QUEUE_SIZE - 1)
+#define ADC_ALARM_INTERRUPTS        (DL_ADC12_INTERRUPT_WINDOW_COMP_HIGH | DL_ADC12_INTERRUPT_WINDOW_COMP_LOW)
+
+// 事件队列：单生产者（ADC中断）单消费者（主循环）
+static adc_alarm_event_t g_alarm_queue[ADC_ALARM_QUEUE_SIZE];
+static volatile uint8_t g_alarm_head = 0;          // 写入位置（中断中修改）
+static volatile uint8_t g_alarm_tail = 0;          // 读取位置（主循环中修改）
+static volatile uint32_t g_alarm_dropped = 0;      // 队列满时丢弃的事件数
+
+// 告警状态
+static adc_alarm_config_t g_alarm_config;
+static volatile bool g_alarm_enabled = false;
+static volatile bool g_load_tripped = false;       // 负载已被快速切断（需手动恢复）
+static volatile uint32_t g_alarm_masked = 0;       // 处于屏蔽期的中断
+static volatile uint32_t g_alarm_mask_time = 0;    // 开始屏蔽的时刻
+
+// 告警类型名称（遥测帧使用）
+static const char *const g_alarm_names[] = {"high", "low"};
+
+/**
+ * @brief 配置并启用窗口比较器告警
+ * 转换结果超出[low, high]时，硬件在该次转换完成时即产生中断，无需软件轮询
+ * @param config 告警配置
+ * @return true: 配置成功, false: 参数无效或功率测量正占用ADC0
+ */
+bool user_adc_alarm_configure(const adc_alarm_config_t *config)
+{
+    if (config == NULL || config->high_mv <= config->low_mv) {
+        return false;
+    }
+    // 功率测量期间ADC0由同步采样接管，结束恢复时会清除MEMCTL上的窗口比较器配置
+    if (user_power_is_running()) {
+        return false;
+    }
+
+    g_alarm_config = *config;
+    g_alarm_masked = 0;
+
+    // 修改MEMCTL前需先关闭转换；异步请求会切换起始地址并使能转换，等其完成并暂停队列
+    user_adc_hold_async();
+    DL_ADC12_disableConversions(ADC12_0_INST);
+    DL_ADC12_configWinCompLowThld(ADC12_0_INST, user_adc_millivolts_to_raw(config->low_mv));
+    DL_ADC12_configWinCompHighThld(ADC12_0_INST, user_adc_millivolts_to_raw(config->high_mv));
+    DL_ADC12_configConversionMem(ADC12_0_INST, ADC12_0_ADCMEM_ADC_CH0,
+        DL_ADC12_INPUT_CHAN_0, DL_ADC12_REFERENCE_VOLTAGE_VDDA, DL_ADC12_SAMPLE_TIMER_SOURCE_SCOMP0,
+        DL_ADC12_AVERAGING_MODE_DISABLED, DL_ADC12_BURN_OUT_SOURCE_DISABLED,
+        DL_ADC12_TRIGGER_MODE_AUTO_NEXT, DL_ADC12_WINDOWS_COMP_MODE_ENABLED);
+
+    DL_ADC12_clearInterruptStatus(ADC12_0_INST, ADC_ALARM_INTERRUPTS);
+    DL_ADC12_enableInterrupt(ADC12_0_INST, ADC_ALARM_INTERRUPTS);
+    DL_ADC12_enableConversions(ADC12_0_INST);
+    user_adc_release_async();
+
+    g_alarm_enabled = true;
+    return true;
+}
+
+/**
+ * @brief 关闭窗口比较器告警
+ */
+void user_adc_alarm_disable(void)
+{
+    g_alarm_enabled = false;
+
+    DL_ADC12_disableInterrupt(ADC12_0_INST, ADC_ALARM_INTERRUPTS);
+    // 功率测量结束恢复ADC0时会清除窗口比较器配置，此时不能改动MEMCTL
+    if (user_power_is_running()) {
+        return;
+    }
+    user_adc_hold_async();
+    DL_ADC12_disableConversions(ADC12_0_INST);
+    DL_ADC12_configConversionMem(ADC12_0_INST, ADC12_0_ADCMEM_ADC_CH0,
+        DL_ADC12_INPUT_CHAN_0, DL_ADC12_REFERENCE_VOLTAGE_VDDA, DL_ADC12_SAMPLE_TIMER_SOURCE_SCOMP0,
+        DL_ADC12_AVERAGING_MODE_DISABLED, DL_ADC12_BURN_OUT_SOURCE_DISABLED,
+        DL_ADC12_TRIGGER_MODE_AUTO_NEXT, DL_ADC12_WINDOWS_COMP_MODE_DISABLED);
+    DL_ADC12_enableConversions(ADC12_0_INST);
+    user_adc_release_async();
+}
+
+/**
+ * @brief 窗口比较器中断处理（由ADC0_IRQHandler调用）
+ * 快速动作先于入队执行；随后屏蔽同方向中断，由主循环在屏蔽期后恢复
+ */
+void user_adc_alarm_handle_interrupt(adc_alarm_type_t type)
+{
+    uint32_t interrupt = (type == ADC_ALARM_HIGH) ? DL_ADC12_INTERRUPT_WINDOW_COMP_HIGH
+                                                  : DL_ADC12_INTERRUPT_WINDOW_COMP_LOW;
+    bool cut = (type == ADC_ALARM_HIGH) ? g_alarm_config.cut_load_on_high
+                                        : g_alarm_config.cut_load_on_low;
+
+    if (!g_alarm_enabled) {
+        return;
+    }
+
+    if (cut) {
+        DL_GPIO_clearPins(OUTPUT_PORT, OUTPUT_OUTPUT1_PIN);
+        g_load_tripped = true;
+    }
+
+    DL_ADC12_disableInterrupt(ADC12_0_INST, interrupt);
+    g_alarm_masked |= interrupt;
+    g_alarm_mask_time = system_time_ms;
+
+    uint8_t head = g_alarm_head;
+    uint8_t next = (head + 1) & ADC_ALARM_QUEUE_MASK;
+    if (next == g_alarm_tail) {
+        g_alarm_dropped++;
+        return;
+    }
+    g_alarm_queue[head].timestamp_ms = system_time_ms;
+    g_alarm_queue[head].raw = DL_ADC12_getMemResult(ADC12_0_INST, ADC12_0_ADCMEM_ADC_CH0);
+    g_alarm_queue[head].type = (uint8_t)type;
+    g_alarm_queue[head].load_cut = cut;
+    g_alarm_head = next;
+}
+
+/**
+ * @brief 从队列取出一个告警事件
+ * @return true: 取到事件
+ */
+bool user_adc_alarm_pop_event(adc_alarm_event_t *event)
+{
+    uint8_t tail = g_alarm_tail;
+
+    if (event == NULL || tail == g_alarm_head) {
+        return false;
+    }
+    *event = g_alarm_queue[tail];
+    g_alarm_tail = (tail + 1) & ADC_ALARM_QUEUE_MASK;
+    return true;
+}
+
+/**
+ * @brief 告警处理函数，需在主循环中调用
+ * 发送排队的告警遥测帧，屏蔽期结束后重新使能中断
+ */
+void user_adc_alarm_process(void)
+{
+    adc_alarm_event_t event;
+
+    while (user_adc_alarm_pop_event(&event)) {
+        firewater_send_alarm(g_alarm_names[event.type], user_adc_raw_to_millivolts(event.raw),
+                             event.timestamp_ms, event.load_cut);
+    }
+
+    if (g_alarm_enabled && g_alarm_masked != 0 &&
+        system_time_ms - g_alarm_mask_time >= ADC_ALARM_HOLDOFF_MS) {
+        // 与中断共享屏蔽位，读取和清零期间关中断
+        __disable_irq();
+        uint32_t masked = g_alarm_masked;
+        g_alarm_masked = 0;
+        DL_ADC12_clearInterruptStatus(ADC12_0_INST, masked);
+        DL_ADC12_enableInterrupt(ADC12_0_INST, masked);
+        __enable_irq();
+    }
+}
+
+/**
+ * @brief 负载是否已被快速切断
+ */
+bool user_adc_alarm_is_tripped(void)
+{
+    return g_load_tripped;
+}
+
+/**
+ * @brief 恢复负载输出（确认故障排除后手动调用）
+ */
+void user_adc_alarm_restore_load(void)
+{
+    g_load_tripped = false;
+    DL_GPIO_setPins(OUTPUT_PORT, OUTPUT_OUTPUT1_PIN);
+}
+
+/**
+ * @brief 获取因队列满而丢弃的事件数
+ */
+uint32_t user_adc_alarm_get_dropped(void)
+{
+    return g_alarm_dropped;
+}
+
+/**
+ * @brief 通过串口输出告警状态帧：使能,下限mV,上限mV,已切断,丢弃事件数
+ */
+void user_adc_alarm_report(void)
+{
+    firewater_send_alarm_status(g_alarm_enabled, g_alarm_config.low_mv, g_alarm_config.high_mv,
+                                g_load_tripped, g_alarm_dropped);
+}
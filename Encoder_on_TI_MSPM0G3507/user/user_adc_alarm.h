@@ -0,0 +1,52 @@
+#ifndef USER_ADC_ALARM_H
+#define USER_ADC_ALARM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 告警事件相关定义
+#define ADC_ALARM_QUEUE_SIZE        16         // 事件队列长度（必须为2的幂）
+#define ADC_ALARM_HOLDOFF_MS        100        // 告警后屏蔽同一方向中断的时间，避免中断风暴
+
+// 告警类型枚举
+typedef enum {
+    ADC_ALARM_HIGH = 0,         // 转换结果高于上限
+    ADC_ALARM_LOW               // 转换结果低于下限
+} adc_alarm_type_t;
+
+// 告警配置（阈值单位为mV，内部换算为ADC码值写入窗口比较器）
+typedef struct {
+    uint16_t low_mv;            // 下限
+    uint16_t high_mv;           // 上限
+    bool cut_load_on_high;      // 超上限时在中断中立即拉低OUTPUT1切断负载
+    bool cut_load_on_low;       // 低于下限时在中断中立即拉低OUTPUT1切断负载
+} adc_alarm_config_t;
+
+// 告警事件（中断中入队，主循环中发送）
+typedef struct {
+    uint32_t timestamp_ms;      // 告警时刻
+    uint16_t raw;               // 触发告警的转换结果
+    uint8_t type;               // adc_alarm_type_t
+    bool load_cut;              // 是否执行了快速切断
+} adc_alarm_event_t;
+
+// 函数声明
+bool user_adc_alarm_configure(const adc_alarm_config_t *config);
+void user_adc_alarm_disable(void);
+void user_adc_alarm_handle_interrupt(adc_alarm_type_t type);
+void user_adc_alarm_process(void);
+bool user_adc_alarm_pop_event(adc_alarm_event_t *event);
+bool user_adc_alarm_is_tripped(void);
+void user_adc_alarm_restore_load(void);
+uint32_t user_adc_alarm_get_dropped(void);
+void user_adc_alarm_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_ADC_ALARM_H */
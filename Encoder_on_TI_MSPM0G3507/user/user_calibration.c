@@ -0,0 +1,269 @@
+#include "user_calibration.h"
+#include "user_ADC.h"
+#include "user_drift.h"
+#include "user_flash.h"
+#include "user_uart.h"
+#include "delay.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#define CAL_SWEEP_POINTS            DAC_CORRECTION_POINTS
+
+// 当前生效的校准数据
+static calibration_data_t g_cal;
+
+// ADC两点校准的采集点
+static uint16_t g_adc_point_raw_q4[2];
+static uint16_t g_adc_point_mv[2];
+static uint8_t g_adc_point_mask = 0;
+
+/**
+ * @brief 恢复理想换算系数（未校准状态）
+ */
+static void cal_set_defaults(void)
+{
+    memset(&g_cal, 0, sizeof(g_cal));
+    g_cal.magic = CAL_MAGIC;
+    g_cal.version = CAL_VERSION;
+    g_cal.adc_mv_per_code_q16 = ADC_MV_PER_CODE_Q16;
+    g_cal.adc_offset_mv_q16 = ADC_MV_OFFSET_Q16;
+    g_cal.dac_gain_q15 = 32768;
+    for (uint16_t i = 0; i < DAC_CORRECTION_POINTS; i++) {
+        uint32_t code = (uint32_t)i * DAC_CORRECTION_STEP;
+        g_cal.dac_table[i] = (code > DAC_MAX_VALUE) ? DAC_MAX_VALUE : (uint16_t)code;
+    }
+}
+
+/**
+ * @brief 把校准系数下发到ADC和DAC换算路径
+ */
+static void cal_apply(void)
+{
+    // 校准增益对应校准时的VDDA，漂移补偿以此为基准修正
+    if (g_cal.flags & CAL_FLAG_ADC_VALID) {
+        user_adc_set_calibration(g_cal.adc_mv_per_code_q16, g_cal.adc_offset_mv_q16);
+        user_drift_set_baseline(g_cal.vdda_mv);
+    } else {
+        user_adc_set_calibration(ADC_MV_PER_CODE_Q16, ADC_MV_OFFSET_Q16);
+        user_drift_set_baseline(0);
+    }
+    DAC_setCorrectionTable((g_cal.flags & CAL_FLAG_DAC_VALID) ? g_cal.dac_table : NULL);
+}
+
+/**
+ * @brief ADC多次采样平均
+ * @return 平均码值(Q4，保留4位小数)
+ */
+static uint16_t cal_read_adc_average_q4(void)
+{
+    uint32_t sum = 0;
+    uint16_t raw;
+
+    for (uint16_t i = 0; i < CAL_ADC_AVERAGE; i++) {
+        user_adc_read_raw(ADC_CHANNEL_0, &raw);
+        sum += raw;
+    }
+    return (uint16_t)(((sum << 4) + CAL_ADC_AVERAGE / 2) / CAL_ADC_AVERAGE);
+}
+
+/**
+ * @brief 启动时加载Flash中的校准数据，无效时使用理想值
+ */
+void user_cal_init(void)
+{
+    const calibration_data_t *stored = (const calibration_data_t *)CAL_FLASH_ADDRESS;
+
+    if (stored->magic == CAL_MAGIC && stored->version == CAL_VERSION &&
+        stored->crc == user_flash_crc16(stored, offsetof(calibration_data_t, crc))) {
+        memcpy(&g_cal, stored, sizeof(g_cal));
+        user_uart_send_string("CAL: Loaded from flash\r\n");
+    } else {
+        cal_set_defaults();
+        user_uart_send_string("CAL: No valid data, using defaults\r\n");
+    }
+    cal_apply();
+}
+
+/**
+ * @brief 采集ADC两点校准的一个点：在PA27上施加已知电压后调用
+ * 两个点都采集后计算ADC增益和偏移并立即生效（需调用user_cal_save保存）
+ * @param index 点序号（0: 低点, 1: 高点）
+ * @param known_mv 实际输入电压(mV)，以万用表测得为准
+ * @return true: 采集成功, false: 参数无效或ADC正忙
+ */
+bool user_cal_adc_point(uint8_t index, uint16_t known_mv)
+{
+    if (index > 1 || user_adc_is_sampling()) {
+        return false;
+    }
+
+    g_adc_point_raw_q4[index] = cal_read_adc_average_q4();
+    g_adc_point_mv[index] = known_mv;
+    g_adc_point_mask |= (uint8_t)(1U << index);
+    if (g_adc_point_mask != 0x03) {
+        return true;
+    }
+    g_adc_point_mask = 0;
+
+    int32_t raw_span_q4 = (int32_t)g_adc_point_raw_q4[1] - g_adc_point_raw_q4[0];
+    int32_t mv_span = (int32_t)g_adc_point_mv[1] - g_adc_point_mv[0];
+    if (raw_span_q4 <= 0 || mv_span <= 0) {
+        user_uart_send_string("CAL: ADC points invalid\r\n");
+        return false;
+    }
+
+    // 增益 = mV跨度 / 码值跨度，码值为Q4故多左移4位
+    uint32_t gain_q16 = (uint32_t)(((int64_t)mv_span << 20) / raw_span_q4);
+    int32_t offset_q16 = ((int32_t)g_adc_point_mv[0] << 16) -
+                         (int32_t)(((int64_t)g_adc_point_raw_q4[0] * gain_q16) >> 4);
+
+    g_cal.adc_mv_per_code_q16 = gain_q16;
+    g_cal.adc_offset_mv_q16 = offset_q16 + ADC_MV_OFFSET_Q16;
+    g_cal.vdda_mv = user_drift_get_vdda_mv();
+    g_cal.flags |= CAL_FLAG_ADC_VALID;
+    cal_apply();
+    return true;
+}
+
+/**
+ * @brief DAC->ADC环回自校准：扫描DAC全量程并用ADC回读
+ * 以ADC（已做两点校准时为校准后的ADC）为测量基准，拟合DAC增益/偏移，
+ * 并生成分段线性校正表使DAC输出等于请求值。完成后保存到Flash。
+ * @return true: 校准成功, false: ADC正忙或环回未连接
+ */
+bool user_cal_run_loopback(void)
+{
+    uint16_t code[CAL_SWEEP_POINTS];
+    int32_t mv_q4[CAL_SWEEP_POINTS];
+    float n = 0.0f, sx = 0.0f, sy = 0.0f, sxx = 0.0f, sxy = 0.0f;
+
+    if (user_adc_is_sampling()) {
+        return false;
+    }
+
+    // 扫描期间停止正弦输出，直接写入未校正的码值
+    DAC_stopSineWave();
+    user_uart_send_string("CAL: DAC loopback sweep\r\n");
+
+    for (uint16_t i = 0; i < CAL_SWEEP_POINTS; i++) {
+        uint32_t c = (uint32_t)i * DAC_CORRECTION_STEP;
+        code[i] = (c > DAC_MAX_VALUE) ? DAC_MAX_VALUE : (uint16_t)c;
+
+        DL_DAC12_output12(DAC_INST, code[i]);
+        delay_ms(CAL_SETTLE_MS);
+
+        // 用当前ADC系数换算为mV(Q4)
+        uint16_t raw_q4 = cal_read_adc_average_q4();
+        mv_q4[i] = (int32_t)(((int64_t)raw_q4 * g_cal.adc_mv_per_code_q16 +
+                              ((int64_t)(g_cal.adc_offset_mv_q16 - ADC_MV_OFFSET_Q16) << 4)) >> 16);
+
+        // 两端饱和区不参与线性拟合
+        if (mv_q4[i] > (CAL_LINEAR_MARGIN_MV << 4) &&
+            mv_q4[i] < ((ADC_REFERENCE_MILLIVOLTS - CAL_LINEAR_MARGIN_MV) << 4)) {
+            float x = code[i];
+            float y = mv_q4[i] * (1.0f / 16.0f);
+            n += 1.0f;
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+    }
+    DL_DAC12_output12(DAC_INST, 0);
+
+    // 最小二乘拟合 mv = a * code + b（只在校准时执行一次，使用浮点）
+    float denom = n * sxx - sx * sx;
+    if (n < 2.0f || denom <= 0.0f) {
+        user_uart_send_string("CAL: Loopback not connected\r\n");
+        return false;
+    }
+    float slope = (n * sxy - sx * sy) / denom;
+    float intercept = (sy - slope * sx) / n;
+    int32_t gain_q15 = (int32_t)(slope * (float)DAC_MAX_VALUE / (float)ADC_REFERENCE_MILLIVOLTS * 32768.0f);
+    if (gain_q15 < CAL_GAIN_MIN_Q15 || gain_q15 > CAL_GAIN_MAX_Q15) {
+        user_uart_send_string("CAL: Loopback not connected\r\n");
+        return false;
+    }
+
+    // 反查测量曲线：理想码值对应的目标电压落在哪两个扫描点之间
+    for (uint16_t j = 0; j < DAC_CORRECTION_POINTS; j++) {
+        int32_t target_q4 = (int32_t)(((uint32_t)j * DAC_CORRECTION_STEP *
+                                       ADC_REFERENCE_MILLIVOLTS * 16U) / DAC_MAX_VALUE);
+        int32_t corrected;
+
+        if (target_q4 <= mv_q4[0]) {
+            corrected = code[0];
+        } else if (target_q4 >= mv_q4[CAL_SWEEP_POINTS - 1]) {
+            corrected = code[CAL_SWEEP_POINTS - 1];
+        } else {
+            corrected = code[CAL_SWEEP_POINTS - 1];
+            for (uint16_t i = 0; i + 1 < CAL_SWEEP_POINTS; i++) {
+                int32_t y0 = mv_q4[i];
+                int32_t y1 = mv_q4[i + 1];
+                if (y1 > y0 && target_q4 >= y0 && target_q4 <= y1) {
+                    corrected = code[i] + ((target_q4 - y0) * (code[i + 1] - code[i])) / (y1 - y0);
+                    break;
+                }
+            }
+        }
+        g_cal.dac_table[j] = (uint16_t)corrected;
+    }
+
+    g_cal.dac_gain_q15 = gain_q15;
+    g_cal.dac_offset_mv = (int32_t)(intercept + ((intercept >= 0.0f) ? 0.5f : -0.5f));
+    g_cal.flags |= CAL_FLAG_DAC_VALID;
+    cal_apply();
+    user_cal_report();
+
+    return user_cal_save();
+}
+
+/**
+ * @brief 把当前校准数据写入Flash（擦除整个扇区后按64位写入，硬件生成ECC）
+ * @return true: 写入并校验成功
+ */
+bool user_cal_save(void)
+{
+    g_cal.magic = CAL_MAGIC;
+    g_cal.version = CAL_VERSION;
+    g_cal.crc = user_flash_crc16(&g_cal, offsetof(calibration_data_t, crc));
+
+    if (!user_flash_write_sector(CAL_FLASH_ADDRESS, &g_cal, sizeof(g_cal))) {
+        user_uart_send_string("CAL: Flash write failed\r\n");
+        return false;
+    }
+    user_uart_send_string("CAL: Saved to flash\r\n");
+    return true;
+}
+
+/**
+ * @brief 清除校准：恢复理想换算并写回Flash
+ */
+void user_cal_clear(void)
+{
+    cal_set_defaults();
+    cal_apply();
+    user_cal_save();
+}
+
+/**
+ * @brief 通过串口输出当前校准系数
+ */
+void user_cal_report(void)
+{
+    char msg[96];
+
+    snprintf(msg, sizeof(msg), "cal:%u,%lu,%ld,%ld,%ld\n",
+             (unsigned int)g_cal.flags, (unsigned long)g_cal.adc_mv_per_code_q16,
+             (long)g_cal.adc_offset_mv_q16, (long)g_cal.dac_gain_q15, (long)g_cal.dac_offset_mv);
+    user_uart_send_string(msg);
+}
+
+/**
+ * @brief 获取当前校准数据
+ */
+const calibration_data_t *user_cal_get(void)
+{
+    return &g_cal;
+}
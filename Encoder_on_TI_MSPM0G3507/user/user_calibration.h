@@ -0,0 +1,55 @@
+#ifndef USER_CALIBRATION_H
+#define USER_CALIBRATION_H
+
+#include "user_DAC.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 校准数据存储位置：主Flash最后一个1KB扇区（flash_records.cmd保留该扇区，代码不会占用）
+#define CAL_FLASH_ADDRESS           0x0001FC00U
+#define CAL_MAGIC                   0x43414C31U   // "CAL1"
+#define CAL_VERSION                 1
+
+// 环回扫描参数（DAC输出PA15需连接到ADC输入PA27）
+#define CAL_SETTLE_MS               2          // 每个扫描点DAC建立时间
+#define CAL_ADC_AVERAGE             32         // 每个扫描点ADC平均次数
+#define CAL_LINEAR_MARGIN_MV        30         // 线性拟合时排除的两端饱和区(mV)
+#define CAL_GAIN_MIN_Q15            26214      // 拟合增益下限0.8，低于此值认为环回未连接
+#define CAL_GAIN_MAX_Q15            39322      // 拟合增益上限1.2
+
+// 有效标志
+#define CAL_FLAG_ADC_VALID          0x0001     // ADC两点校准有效
+#define CAL_FLAG_DAC_VALID          0x0002     // DAC环回校准有效
+
+// 校准数据（按8字节对齐写入Flash，共64字节）
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t adc_mv_per_code_q16;   // ADC每码值毫伏数(Q16)
+    int32_t adc_offset_mv_q16;      // ADC偏移(Q16 mV)，含0.5mV舍入量
+    int32_t dac_gain_q15;           // DAC线性拟合增益（相对理想值，Q15）
+    int32_t dac_offset_mv;          // DAC线性拟合零点偏移(mV)
+    uint16_t dac_table[DAC_CORRECTION_POINTS];  // DAC分段线性校正表
+    uint16_t vdda_mv;               // ADC校准时的VDDA(mV)，0表示未测得（按标称值）
+    uint32_t crc;                   // 前面所有字段的CRC16
+} calibration_data_t;
+
+// 函数声明
+void user_cal_init(void);
+bool user_cal_run_loopback(void);
+bool user_cal_adc_point(uint8_t index, uint16_t known_mv);
+bool user_cal_save(void);
+void user_cal_clear(void);
+void user_cal_report(void);
+const calibration_data_t *user_cal_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_CALIBRATION_H */
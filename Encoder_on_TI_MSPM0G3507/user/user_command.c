@@ -0,0 +1,679 @@
+#include "user_command.h"
+#include "user_uart.h"
+#include "delay.h"
+#include "user_timestamp.h"
+#include "user_power.h"
+#include "user_drift.h"
+#include "user_ADC.h"
+#include "user_filter.h"
+#include "user_scope.h"
+#include "user_stats.h"
+#include "user_spectrum.h"
+#include "user_calibration.h"
+#include "user_adc_alarm.h"
+#include "user_DAC.h"
+#include "user_waveform.h"
+#include "user_ramp.h"
+#include "user_regulator.h"
+#include "user_replay.h"
+#include "user_Encoder.h"
+#include <string.h>
+#include <stdlib.h>
+
+// 命令表项
+typedef struct {
+    const char *name;           // 命令名
+    command_handler_t handler;  // 处理函数
+    const char *help;           // 帮助文本
+} command_entry_t;
+
+static void command_help(uint8_t argc, char *argv[]);
+static void command_jitter(uint8_t argc, char *argv[]);
+static void command_power(uint8_t argc, char *argv[]);
+static void command_drift(uint8_t argc, char *argv[]);
+static void command_dac(uint8_t argc, char *argv[]);
+static void command_wave(uint8_t argc, char *argv[]);
+static void command_slew(uint8_t argc, char *argv[]);
+static void command_enc(uint8_t argc, char *argv[]);
+static void command_loop(uint8_t argc, char *argv[]);
+static void command_replay(uint8_t argc, char *argv[]);
+static void command_tone(uint8_t argc, char *argv[]);
+static void command_adc(uint8_t argc, char *argv[]);
+static void command_filter(uint8_t argc, char *argv[]);
+static void command_scope(uint8_t argc, char *argv[]);
+static void command_stats(uint8_t argc, char *argv[]);
+static void command_spectrum(uint8_t argc, char *argv[]);
+static void command_cal(uint8_t argc, char *argv[]);
+static void command_alarm(uint8_t argc, char *argv[]);
+
+// 命令表：新增命令时在此追加
+static const command_entry_t g_commands[] = {
+    {"help",   command_help,   "list commands"},
+    {"jitter", command_jitter, "jitter [keep]: report sample-interval histograms"},
+    {"power",  command_power,  "power start [rate_hz] | power stop: synchronous V/I sampling"},
+    {"adc",    command_adc,    "adc bench: CPU cycles per batch, original float vs fixed-point conversion"},
+    {"filter", command_filter, "filter [<preset>|bench]: select the high-speed sampling filter (no argument lists presets)"},
+    {"stats",  command_stats,  "stats start [window] | stats stop: per-window mean/rms/min/max of the ADC stream (mV)"},
+    {"spectrum", command_spectrum, "spectrum [rate_hz]: capture one 256-point block, send spectrum and fundamental/THD/SNR | spectrum tone <mHz> [rate_hz]: Goertzel amplitude of one frequency"},
+    {"cal",    command_cal,    "cal loop | cal adc <0|1> <mV> | cal save | cal clear | cal report: DAC loopback (PA15->PA27) and ADC two-point calibration"},
+    {"alarm",  command_alarm,  "alarm <low_mV> <high_mV> [cut] | alarm off | alarm restore | alarm: ADC window-comparator alarm (cut = drop OUTPUT1 on high)"},
+    {"drift",  command_drift,  "drift: report VDDA estimate, die temperature and ADC scale"},
+    {"dac",    command_dac,    "dac start|stop (waveform engine takes over / returns the DAC) | dac freq <mHz> | dac rate <Hz> | dac health [reset] | dac sweep <lin|log> <start_mHz> <stop_mHz> <ms> [repeat] | dac sweep stop | dac am <mHz> <depth%> | dac ramp <from%> <to%> <ms> | dac env off"},
+    {"slew",   command_slew,   "slew [mV_per_ms]: set or report encoder setpoint slew rate (0 = step)"},
+    {"enc",    command_enc,    "enc [res <1|2|4>]: set counts per detent, report count, resolution and decoder glitches"},
+    {"loop",   command_loop,   "loop [on|off]: closed-loop output regulation from ADC feedback"},
+    {"scope",  command_scope,  "scope rise|fall <mV> [pre] [post] | scope window <low_mV> <high_mV> [pre] [post] | scope abort: triggered capture"},
+    {"replay", command_replay, "replay arm [trigger_mV] | replay start [speed%] [gain%] [once] | replay stop: capture an ADC segment and play it on the DAC"},
+    {"tone",   command_tone,   "tone <mHz>,<mV>[,<deg>] ... (up to 4) | tone off: sum of DDS oscillators"},
+    {"wave",   command_wave,   "wave <sine|square|triangle|saw|noise|user0|user1> [amp_mV] [offset_mV] | wave upload <slot> <points> | wave save <slot>"},
+};
+
+#define COMMAND_COUNT   (sizeof(g_commands) / sizeof(g_commands[0]))
+
+// 行缓冲区
+static char g_line[COMMAND_LINE_MAX];
+static uint8_t g_line_pos = 0;
+static bool g_line_overflow = false;       // 超长行，丢弃到行尾
+
+// 二进制接收（命令处理函数发起，接收期间不解析命令行）
+static uint8_t *g_binary_buffer = NULL;
+static uint16_t g_binary_length = 0;
+static uint16_t g_binary_pos = 0;
+static uint32_t g_binary_last_ms = 0;
+static command_binary_done_t g_binary_done = NULL;
+
+/**
+ * @brief 列出所有命令
+ */
+static void command_help(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+        user_uart_send_string(g_commands[i].help);
+        user_uart_send_string("\r\n");
+    }
+}
+
+/**
+ * @brief 报告采样间隔直方图，默认报告后清空（"jitter keep"保留累计）
+ */
+static void command_jitter(uint8_t argc, char *argv[])
+{
+    bool keep = (argc > 1 && strcmp(argv[1], "keep") == 0);
+    user_jitter_report_all(!keep);
+}
+
+/**
+ * @brief 启停同步功率测量（"power start [rate_hz]"、"power stop"）
+ */
+static void command_power(uint8_t argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "stop") == 0) {
+        user_power_stop();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+    if (argc < 2 || strcmp(argv[1], "start") != 0) {
+        user_uart_send_string("ERR: usage power start [rate_hz] | power stop\r\n");
+        return;
+    }
+
+    if (argc > 2) {
+        power_config_t config = {
+            .sample_rate_hz = (uint32_t)strtoul(argv[2], NULL, 10),
+            .window = POWER_DEFAULT_WINDOW,
+            .voltage_mv_per_code_q16 = POWER_DEFAULT_MV_PER_CODE_Q16,
+            .current_ma_per_code_q16 = POWER_DEFAULT_MA_PER_CODE_Q16,
+            .current_zero_code = POWER_DEFAULT_CURRENT_ZERO
+        };
+        if (!user_power_configure(&config)) {
+            user_uart_send_string("ERR: bad rate or running\r\n");
+            return;
+        }
+    }
+    user_uart_send_string(user_power_start() ? "OK\r\n" : "ERR: ADC busy\r\n");
+}
+
+/**
+ * @brief ADC换算基准测试（"adc bench"）
+ */
+static void command_adc(uint8_t argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        user_adc_benchmark_conversion();
+        return;
+    }
+    user_uart_send_string("ERR: usage adc bench\r\n");
+}
+
+/**
+ * @brief 选择高速采样滤波预置（"filter <preset>"）、基准测试（"filter bench"）或列出预置
+ */
+static void command_filter(uint8_t argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        user_filter_benchmark();
+        return;
+    }
+    if (argc > 1) {
+        for (uint8_t p = 0; p < FILTER_PRESET_MAX; p++) {
+            if (strcmp(argv[1], user_filter_get_desc((filter_preset_t)p)->name) == 0) {
+                user_filter_select((filter_preset_t)p);
+                user_uart_send_string("OK\r\n");
+                return;
+            }
+        }
+        user_uart_send_string("ERR: unknown preset\r\n");
+        return;
+    }
+
+    // 列出预置，当前选择以*标记
+    for (uint8_t p = 0; p < FILTER_PRESET_MAX; p++) {
+        user_uart_send_string((p == user_filter_get_preset()) ? "* " : "  ");
+        user_uart_send_string(user_filter_get_desc((filter_preset_t)p)->name);
+        user_uart_send_string("\r\n");
+    }
+}
+
+/**
+ * @brief 报告参考漂移补偿状态
+ */
+static void command_drift(uint8_t argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    user_drift_report();
+}
+
+/**
+ * @brief DAC波形引擎启停、频率、扫频和包络控制
+ * "dac start"后波形引擎接管DAC，编码器/斜坡的静态设定值不再输出；"dac stop"交还
+ */
+static void command_dac(uint8_t argc, char *argv[])
+{
+    bool ok;
+
+    if (argc > 1 && strcmp(argv[1], "start") == 0) {
+        DAC_startSineWave();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+    if (argc > 1 && strcmp(argv[1], "stop") == 0) {
+        DAC_stopSineWave();
+        user_ramp_refresh();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "freq") == 0) {
+        ok = DAC_setSineFrequency((uint32_t)strtoul(argv[2], NULL, 10));
+        user_uart_send_string(ok ? "OK\r\n" : "ERR: frequency above Nyquist\r\n");
+        return;
+    }
+    if (argc > 1 && strcmp(argv[1], "health") == 0) {
+        DAC_checkStatus();
+        if (argc > 2 && strcmp(argv[2], "reset") == 0) {
+            DAC_resetHealth();
+        }
+        return;
+    }
+    if (argc > 2 && strcmp(argv[1], "rate") == 0) {
+        ok = DAC_setSampleRate((uint32_t)strtoul(argv[2], NULL, 10));
+        user_uart_send_string(ok ? "OK\r\n" : "ERR: rate out of range or below output frequency\r\n");
+        return;
+    }
+    if (argc > 2 && strcmp(argv[1], "sweep") == 0 && strcmp(argv[2], "stop") == 0) {
+        DAC_stopSweep();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+    if (argc > 5 && strcmp(argv[1], "sweep") == 0) {
+        dac_sweep_mode_t mode = (strcmp(argv[2], "log") == 0) ? DAC_SWEEP_LOG : DAC_SWEEP_LINEAR;
+        bool repeat = (argc > 6 && strcmp(argv[6], "repeat") == 0);
+        ok = DAC_startSweep(mode, (uint32_t)strtoul(argv[3], NULL, 10),
+                            (uint32_t)strtoul(argv[4], NULL, 10),
+                            (uint32_t)strtoul(argv[5], NULL, 10), repeat);
+        user_uart_send_string(ok ? "OK\r\n" : "ERR: bad sweep range or duration\r\n");
+        return;
+    }
+    if (argc > 3 && strcmp(argv[1], "am") == 0) {
+        ok = DAC_setAmEnvelope((uint32_t)strtoul(argv[2], NULL, 10),
+                               (uint8_t)strtoul(argv[3], NULL, 10));
+        user_uart_send_string(ok ? "OK\r\n" : "ERR: bad modulation frequency or depth\r\n");
+        return;
+    }
+    if (argc > 4 && strcmp(argv[1], "ramp") == 0) {
+        ok = DAC_setRampEnvelope((uint8_t)strtoul(argv[2], NULL, 10),
+                                 (uint8_t)strtoul(argv[3], NULL, 10),
+                                 (uint32_t)strtoul(argv[4], NULL, 10));
+        user_uart_send_string(ok ? "OK\r\n" : "ERR: bad ramp level\r\n");
+        return;
+    }
+    if (argc > 2 && strcmp(argv[1], "env") == 0 && strcmp(argv[2], "off") == 0) {
+        DAC_clearEnvelope();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+    user_uart_send_string("ERR: usage dac start|stop|freq|rate|health|sweep|am|ramp|env\r\n");
+}
+
+/**
+ * @brief 波形选择、用户波形上传与保存
+ * "wave upload"命令行需以单个\n结束，之后发送二进制数据（格式见user_waveform.h）
+ */
+static void command_wave(uint8_t argc, char *argv[])
+{
+    dac_waveform_t wave;
+
+    if (argc > 2 && strcmp(argv[1], "upload") == 0) {
+        uint16_t points = (argc > 3) ? (uint16_t)strtoul(argv[3], NULL, 10) : WAVE_TABLE_SIZE;
+        if (!user_waveform_begin_upload((uint8_t)strtoul(argv[2], NULL, 10), points)) {
+            user_uart_send_string("ERR: bad slot or points\r\n");
+        }
+        return;
+    }
+    if (argc > 2 && strcmp(argv[1], "save") == 0) {
+        bool ok = user_waveform_save((uint8_t)strtoul(argv[2], NULL, 10));
+        user_uart_send_string(ok ? "OK\r\n" : "ERR: empty slot or flash\r\n");
+        return;
+    }
+    if (argc < 2 || !user_waveform_parse_name(argv[1], &wave)) {
+        user_uart_send_string("ERR: unknown waveform\r\n");
+        return;
+    }
+
+    uint16_t amplitude = (argc > 2) ? (uint16_t)strtoul(argv[2], NULL, 10) : DAC_DEFAULT_AMPLITUDE_MV;
+    uint16_t offset = (argc > 3) ? (uint16_t)strtoul(argv[3], NULL, 10) : DAC_DEFAULT_OFFSET_MV;
+    user_uart_send_string(DAC_selectWaveform(wave, amplitude, offset) ? "OK\r\n" : "ERR: empty slot\r\n");
+}
+
+/**
+ * @brief 设置或报告编码器设定值的压摆率（"slew [mV_per_ms]"）
+ */
+static void command_slew(uint8_t argc, char *argv[])
+{
+    if (argc > 1 && !user_ramp_set_slew((uint16_t)strtoul(argv[1], NULL, 10))) {
+        user_uart_send_string("ERR: slew rate out of range\r\n");
+        return;
+    }
+    user_ramp_report();
+}
+
+/**
+ * @brief 设置编码器分辨率（"enc res <1|2|4>"）并报告计数值、分辨率和非法转移数
+ */
+static void command_enc(uint8_t argc, char *argv[])
+{
+    if (argc > 1) {
+        if (argc < 3 || strcmp(argv[1], "res") != 0) {
+            user_uart_send_string("ERR: usage enc [res <1|2|4>]\r\n");
+            return;
+        }
+        if (!user_encoder_set_resolution((uint8_t)strtoul(argv[2], NULL, 10))) {
+            user_uart_send_string("ERR: resolution must be 1, 2 or 4\r\n");
+            return;
+        }
+    }
+    user_encoder_report();
+}
+
+/**
+ * @brief 开关或报告闭环稳压（"loop [on|off]"），DAC波形引擎运行时不能开启
+ */
+static void command_loop(uint8_t argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "on") == 0) {
+        if (DAC_isRunning()) {
+            user_uart_send_string("ERR: DAC waveform running\r\n");
+            return;
+        }
+        user_regulator_enable(true);
+    } else if (argc > 1 && strcmp(argv[1], "off") == 0) {
+        user_regulator_enable(false);
+    } else if (argc > 1) {
+        user_uart_send_string("ERR: usage loop [on|off]\r\n");
+        return;
+    }
+    user_regulator_report();
+}
+
+/**
+ * @brief 启停ADC流窗口统计（"stats start [window]"、"stats stop"）
+ * 窗口省略或为0时使用STATS_DEFAULT_WINDOW，停止时输出最后一个不完整窗口
+ */
+static void command_stats(uint8_t argc, char *argv[])
+{
+    uint32_t window = STATS_DEFAULT_WINDOW;
+
+    if (argc > 1 && strcmp(argv[1], "stop") == 0) {
+        user_stats_stop_adc();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+    if (argc < 2 || strcmp(argv[1], "start") != 0) {
+        user_uart_send_string("ERR: usage stats start [window] | stats stop\r\n");
+        return;
+    }
+    if (argc > 2 && strtoul(argv[2], NULL, 10) > 0) {
+        window = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+    user_uart_send_string(user_stats_start_adc(window) ? "OK\r\n" : "ERR: ADC busy\r\n");
+}
+
+/**
+ * @brief 捕获一帧并做频谱分析（"spectrum [rate_hz]"），结果以频谱帧和测量结果帧上传；
+ * "spectrum tone <mHz> [rate_hz]"只用Goertzel检测一个频率，结果以单频检测结果帧上传
+ */
+static void command_spectrum(uint8_t argc, char *argv[])
+{
+    uint32_t rate = ADC_MAX_SAMPLE_RATE;
+    uint32_t target_mhz = 0;
+    uint8_t rate_arg = 1;
+
+    if (argc > 1 && strcmp(argv[1], "tone") == 0) {
+        target_mhz = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 10) : 0;
+        if (target_mhz == 0) {
+            user_uart_send_string("ERR: usage spectrum tone <mHz> [rate_hz]\r\n");
+            return;
+        }
+        rate_arg = 3;
+    }
+    if (argc > rate_arg) {
+        rate = (uint32_t)strtoul(argv[rate_arg], NULL, 10);
+        if (rate == 0 || rate > ADC_MAX_CAPTURE_RATE) {
+            user_uart_send_string("ERR: usage spectrum [rate_hz] | spectrum tone <mHz> [rate_hz] (1..ADC capture rate)\r\n");
+            return;
+        }
+    }
+    if (target_mhz != 0) {
+        if ((uint64_t)target_mhz * 2U >= (uint64_t)rate * 1000U) {
+            user_uart_send_string("ERR: frequency must be below rate/2\r\n");
+            return;
+        }
+        user_uart_send_string(user_spectrum_start_tone(target_mhz, rate) ? "OK\r\n" : "ERR: ADC busy\r\n");
+        return;
+    }
+    user_uart_send_string(user_spectrum_start_capture(rate) ? "OK\r\n" : "ERR: ADC busy\r\n");
+}
+
+/**
+ * @brief 校准（"cal loop"、"cal adc <0|1> <mV>"、"cal save"、"cal clear"、"cal report"）
+ * loop为DAC→ADC环回扫描，完成后自动保存；adc两点采完即生效，需cal save写入Flash
+ */
+static void command_cal(uint8_t argc, char *argv[])
+{
+    bool ok;
+
+    if (argc > 1 && strcmp(argv[1], "loop") == 0) {
+        ok = user_cal_run_loopback();
+    } else if (argc > 3 && strcmp(argv[1], "adc") == 0) {
+        ok = user_cal_adc_point((uint8_t)strtoul(argv[2], NULL, 10),
+                                (uint16_t)strtoul(argv[3], NULL, 10));
+    } else if (argc > 1 && strcmp(argv[1], "save") == 0) {
+        ok = user_cal_save();
+    } else if (argc > 1 && strcmp(argv[1], "clear") == 0) {
+        user_cal_clear();
+        ok = true;
+    } else if (argc > 1 && strcmp(argv[1], "report") == 0) {
+        user_cal_report();
+        return;
+    } else {
+        user_uart_send_string("ERR: usage cal loop | cal adc <0|1> <mV> | cal save | cal clear | cal report\r\n");
+        return;
+    }
+    user_uart_send_string(ok ? "OK\r\n" : "ERR: calibration failed\r\n");
+}
+
+/**
+ * @brief ADC窗口比较器告警（"alarm <low_mV> <high_mV> [cut]"、"alarm off"、"alarm restore"、"alarm"）
+ * cut时超上限在中断中直接拉低OUTPUT1；restore在排除故障后恢复负载；无参数时报告状态
+ */
+static void command_alarm(uint8_t argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "off") == 0) {
+        user_adc_alarm_disable();
+    } else if (argc > 1 && strcmp(argv[1], "restore") == 0) {
+        user_adc_alarm_restore_load();
+    } else if (argc > 2) {
+        adc_alarm_config_t config = {
+            .low_mv = (uint16_t)strtoul(argv[1], NULL, 10),
+            .high_mv = (uint16_t)strtoul(argv[2], NULL, 10),
+            .cut_load_on_high = (argc > 3 && strcmp(argv[3], "cut") == 0),
+            .cut_load_on_low = false
+        };
+        if (config.high_mv <= config.low_mv) {
+            user_uart_send_string("ERR: need low_mV < high_mV\r\n");
+            return;
+        }
+        if (!user_adc_alarm_configure(&config)) {
+            user_uart_send_string("ERR: ADC0 busy with power measurement\r\n");
+            return;
+        }
+    } else if (argc > 1) {
+        user_uart_send_string("ERR: usage alarm <low_mV> <high_mV> [cut] | alarm off | alarm restore\r\n");
+        return;
+    }
+    user_adc_alarm_report();
+}
+
+/**
+ * @brief 示波器触发捕获（"scope rise|fall <mV> [pre] [post]"、"scope window <low_mV> <high_mV> [pre] [post]"、"scope abort"）
+ * 配置后立即布防，触发前后样本数默认128/384，之和不超过SCOPE_BUFFER_SIZE
+ */
+static void command_scope(uint8_t argc, char *argv[])
+{
+    scope_config_t config = {
+        .trigger = SCOPE_TRIGGER_RISING,
+        .level_high = ADC_MAX_VALUE,
+        .hysteresis = 32,
+        .pre_samples = SCOPE_BUFFER_SIZE / 4,
+        .post_samples = SCOPE_BUFFER_SIZE - SCOPE_BUFFER_SIZE / 4,
+        .auto_rearm = false
+    };
+    uint8_t next;
+
+    if (argc > 1 && strcmp(argv[1], "abort") == 0) {
+        user_scope_abort();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+    if (argc > 2 && (strcmp(argv[1], "rise") == 0 || strcmp(argv[1], "fall") == 0)) {
+        config.trigger = (argv[1][0] == 'r') ? SCOPE_TRIGGER_RISING : SCOPE_TRIGGER_FALLING;
+        config.level = user_adc_millivolts_to_raw((uint16_t)strtoul(argv[2], NULL, 10));
+        next = 3;
+    } else if (argc > 3 && strcmp(argv[1], "window") == 0) {
+        config.trigger = SCOPE_TRIGGER_WINDOW;
+        config.level = user_adc_millivolts_to_raw((uint16_t)strtoul(argv[2], NULL, 10));
+        config.level_high = user_adc_millivolts_to_raw((uint16_t)strtoul(argv[3], NULL, 10));
+        next = 4;
+    } else {
+        user_uart_send_string("ERR: usage scope rise|fall|window|abort\r\n");
+        return;
+    }
+    if (argc > next) {
+        config.pre_samples = (uint16_t)strtoul(argv[next], NULL, 10);
+    }
+    if (argc > next + 1) {
+        config.post_samples = (uint16_t)strtoul(argv[next + 1], NULL, 10);
+    }
+
+    if (!user_scope_configure(&config)) {
+        user_uart_send_string("ERR: bad levels/counts or capture in progress\r\n");
+        return;
+    }
+    user_uart_send_string(user_scope_arm() ? "OK\r\n" : "ERR: ADC busy\r\n");
+}
+
+/**
+ * @brief 捕获回放（"replay arm [trigger_mV]"、"replay start [speed%] [gain%] [once]"、"replay stop"）
+ */
+static void command_replay(uint8_t argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "arm") == 0) {
+        uint16_t level = (argc > 2) ? (uint16_t)strtoul(argv[2], NULL, 10) : ADC_REFERENCE_MILLIVOLTS / 2;
+        user_uart_send_string(user_replay_arm(level) ? "OK\r\n" : "ERR: scope busy\r\n");
+        return;
+    }
+    if (argc > 1 && strcmp(argv[1], "start") == 0) {
+        uint16_t speed = (argc > 2) ? (uint16_t)strtoul(argv[2], NULL, 10) : 100;
+        uint16_t gain = (argc > 3) ? (uint16_t)strtoul(argv[3], NULL, 10) : 100;
+        bool loop = !(argc > 4 && strcmp(argv[4], "once") == 0);
+        user_uart_send_string(user_replay_start(speed, gain, loop) ? "OK\r\n"
+                                                                   : "ERR: no capture or bad speed/gain\r\n");
+        return;
+    }
+    if (argc > 1 && strcmp(argv[1], "stop") == 0) {
+        user_replay_stop();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+    user_uart_send_string("ERR: usage replay arm|start|stop\r\n");
+}
+
+/**
+ * @brief 多音输出（"tone <mHz>,<mV>[,<deg>] ..."、"tone off"），偏移为默认偏移
+ */
+static void command_tone(uint8_t argc, char *argv[])
+{
+    dac_tone_t tones[DAC_MULTITONE_MAX];
+    uint8_t count = 0;
+
+    if (argc > 1 && strcmp(argv[1], "off") == 0) {
+        DAC_stopMultitone();
+        user_uart_send_string("OK\r\n");
+        return;
+    }
+    if (argc < 2 || argc > DAC_MULTITONE_MAX + 1) {
+        user_uart_send_string("ERR: usage tone <mHz>,<mV>[,<deg>] ... | tone off\r\n");
+        return;
+    }
+
+    for (uint8_t i = 1; i < argc; i++) {
+        char *end;
+        tones[count].frequency_mhz = (uint32_t)strtoul(argv[i], &end, 10);
+        if (*end != ',') {
+            user_uart_send_string("ERR: tone format <mHz>,<mV>[,<deg>]\r\n");
+            return;
+        }
+        tones[count].amplitude_mv = (uint16_t)strtoul(end + 1, &end, 10);
+        tones[count].phase_deg = (*end == ',') ? (uint16_t)strtoul(end + 1, NULL, 10) : 0;
+        count++;
+    }
+
+    if (!DAC_startMultitone(tones, count, DAC_DEFAULT_OFFSET_MV)) {
+        user_uart_send_string("ERR: frequency above Nyquist\r\n");
+        return;
+    }
+    user_uart_send_string(DAC_getMultitoneScale() < 100 ? "OK: amplitudes scaled to fit\r\n" : "OK\r\n");
+}
+
+/**
+ * @brief 把一行拆分为命令名和参数并执行
+ */
+static void command_execute(char *line)
+{
+    char *argv[COMMAND_MAX_ARGS + 1];
+    uint8_t argc = 0;
+    char *token = strtok(line, " ");
+
+    while (token != NULL && argc < COMMAND_MAX_ARGS + 1) {
+        argv[argc++] = token;
+        token = strtok(NULL, " ");
+    }
+    if (argc == 0) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++) {
+        if (strcmp(argv[0], g_commands[i].name) == 0) {
+            g_commands[i].handler(argc, argv);
+            return;
+        }
+    }
+    user_uart_send_string("ERR: unknown command\r\n");
+}
+
+/**
+ * @brief 进入二进制接收：接下来的length个字节原样写入buffer，完成或超时后调用done
+ * 由命令处理函数调用，命令行结束符之后的数据即为二进制内容（此类命令行只能以单个\n结束）
+ * @return true: 已开始接收, false: 参数无效或已有接收在进行
+ */
+bool user_command_receive_binary(uint8_t *buffer, uint16_t length, command_binary_done_t done)
+{
+    if (buffer == NULL || length == 0 || done == NULL || g_binary_done != NULL) {
+        return false;
+    }
+
+    g_binary_buffer = buffer;
+    g_binary_length = length;
+    g_binary_pos = 0;
+    g_binary_last_ms = get_system_time_ms();
+    g_binary_done = done;
+    return true;
+}
+
+/**
+ * @brief 结束二进制接收并回调
+ */
+static void command_binary_finish(bool ok)
+{
+    command_binary_done_t done = g_binary_done;
+
+    g_binary_done = NULL;
+    done(ok, g_binary_buffer, g_binary_pos);
+}
+
+/**
+ * @brief 二进制接收：取走串口数据，返回false表示已无接收在进行
+ */
+static bool command_binary_process(void)
+{
+    if (g_binary_done == NULL) {
+        return false;
+    }
+
+    while (user_uart_is_data_available() && g_binary_pos < g_binary_length) {
+        g_binary_buffer[g_binary_pos++] = user_uart_receive_byte();
+        g_binary_last_ms = get_system_time_ms();
+    }
+    if (g_binary_pos >= g_binary_length) {
+        command_binary_finish(true);
+    } else if (get_system_time_ms() - g_binary_last_ms > COMMAND_BINARY_TIMEOUT_MS) {
+        command_binary_finish(false);
+    }
+    return true;
+}
+
+/**
+ * @brief 串口命令处理函数，需在主循环中调用
+ * 收到回车或换行时执行一行命令，不阻塞
+ */
+void user_command_process(void)
+{
+    if (command_binary_process()) {
+        return;
+    }
+
+    while (user_uart_is_data_available()) {
+        uint8_t received_byte = user_uart_receive_byte();
+
+        if (received_byte == '\r' || received_byte == '\n') {
+            if (g_line_overflow) {
+                user_uart_send_string("ERR: line too long\r\n");
+            } else if (g_line_pos > 0) {
+                g_line[g_line_pos] = '\0';
+                command_execute(g_line);
+            }
+            g_line_pos = 0;
+            g_line_overflow = false;
+            if (g_binary_done != NULL) {
+                return;  // 命令发起了二进制接收，后续字节不再按命令行解析
+            }
+        } else if (g_line_pos < COMMAND_LINE_MAX - 1) {
+            g_line[g_line_pos++] = (char)received_byte;
+        } else {
+            g_line_overflow = true;
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef USER_COMMAND_H
+#define USER_COMMAND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 串口命令行相关定义
+#define COMMAND_LINE_MAX            64         // 单行命令最大长度
+#define COMMAND_MAX_ARGS            6          // 命令名之后的最大参数个数
+#define COMMAND_BINARY_TIMEOUT_MS   1000       // 二进制数据接收超时（字节间隔）
+
+// 命令处理函数：argv[0]为命令名，argv[1..argc-1]为参数
+typedef void (*command_handler_t)(uint8_t argc, char *argv[]);
+
+// 二进制数据接收完成回调：ok为false表示超时，buffer内容不完整
+typedef void (*command_binary_done_t)(bool ok, uint8_t *buffer, uint16_t length);
+
+// 函数声明
+void user_command_process(void);
+bool user_command_receive_binary(uint8_t *buffer, uint16_t length, command_binary_done_t done);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_COMMAND_H */
@@ -0,0 +1,139 @@
+#include "user_drift.h"
+#include "user_ADC.h"
+#include "user_power.h"
+#include "firewater_protocol.h"
+#include "delay.h"
+#include "ti_msp_dl_config.h"
+#include <stddef.h>
+
+static uint32_t g_last_submit_ms = 0;
+static uint16_t g_baseline_mv = ADC_REFERENCE_MILLIVOLTS;  // 当前ADC增益对应的VDDA
+static int32_t g_vdda_mv_q4 = 0;           // 滤波后的VDDA(Q4 mV)
+static bool g_vdda_valid = false;
+static int32_t g_temperature_mc = DRIFT_TEMP_TRIM_C * 1000;  // 芯片温度(m°C)
+static bool g_temperature_valid = false;
+static uint32_t g_scale_q16 = ADC_REF_SCALE_ONE_Q16;
+static uint32_t g_rejected = 0;            // 超出有效范围而丢弃的VDDA估计数
+
+/**
+ * @brief 根据滤波后的VDDA更新ADC换算的修正系数
+ */
+static void drift_update_scale(void)
+{
+    if (!g_vdda_valid || g_baseline_mv == 0) {
+        return;
+    }
+    // (vdda_q4 / 16) / baseline，Q16
+    g_scale_q16 = (uint32_t)(((uint32_t)g_vdda_mv_q4 << 12) / g_baseline_mv);
+    user_adc_set_reference_scale(g_scale_q16);
+}
+
+/**
+ * @brief 温度传感器转换完成：按出厂校准点换算芯片温度
+ */
+static void drift_temperature_done(int8_t handle, uint16_t raw_value, void *context)
+{
+    (void)handle;
+    (void)context;
+
+    int32_t delta = (int32_t)raw_value - (int32_t)DL_SYSCTL_getTempCalibrationConstant();
+    // 斜率为负：码值高于校准点表示温度低于30°C
+    g_temperature_mc = DRIFT_TEMP_TRIM_C * 1000 - (delta * DRIFT_TEMP_MC_PER_CODE_Q8) / 256;
+    g_temperature_valid = true;
+}
+
+/**
+ * @brief 电源监测转换完成：VDDA = 3 x 码值 x 内部参考 / 4095
+ */
+static void drift_supply_done(int8_t handle, uint16_t raw_value, void *context)
+{
+    (void)handle;
+    (void)context;
+
+    // 内部参考按温度修正（DRIFT_VREF_TEMPCO_PPM为0时不修正）
+    int32_t vref_uv = ADC_INTREF_MILLIVOLTS * 1000;
+    if (g_temperature_valid) {
+        int32_t delta_mc = g_temperature_mc - DRIFT_TEMP_TRIM_C * 1000;
+        vref_uv += (DRIFT_VREF_TEMPCO_PPM * delta_mc * (ADC_INTREF_MILLIVOLTS / 100)) / 10000;
+    }
+
+    int32_t vdda_mv = (int32_t)(((uint64_t)raw_value * 3U * (uint32_t)vref_uv +
+                                 ADC_MAX_VALUE * 500U) / (ADC_MAX_VALUE * 1000U));
+    if (vdda_mv < DRIFT_VDDA_MIN_MV || vdda_mv > DRIFT_VDDA_MAX_MV) {
+        g_rejected++;
+        return;
+    }
+
+    if (!g_vdda_valid) {
+        g_vdda_mv_q4 = vdda_mv << 4;
+        g_vdda_valid = true;
+    } else {
+        g_vdda_mv_q4 += ((vdda_mv << 4) - g_vdda_mv_q4) / (1 << DRIFT_FILTER_SHIFT);
+    }
+    drift_update_scale();
+}
+
+/**
+ * @brief 漂移补偿处理函数，需在主循环中调用
+ * 每个周期提交一次温度和电源监测的异步请求，转换在ADC中断中完成，主循环几乎不占用CPU
+ */
+void user_drift_process(void)
+{
+    uint32_t now = get_system_time_ms();
+
+    if (now - g_last_submit_ms < DRIFT_INTERVAL_MS) {
+        return;
+    }
+    // 高速采样和功率测量期间ADC0不处理异步请求，推迟到结束后
+    if (user_adc_is_sampling() || user_power_is_running()) {
+        return;
+    }
+
+    // 先温度后电源，电源结果可使用最新温度
+    if (user_adc_submit(ADC_CHANNEL_TEMPERATURE, DRIFT_AVERAGE,
+                        drift_temperature_done, NULL) == ADC_REQUEST_INVALID) {
+        return;  // 队列满，下次重试
+    }
+    user_adc_submit(ADC_CHANNEL_SUPPLY, DRIFT_AVERAGE, drift_supply_done, NULL);
+    g_last_submit_ms = now;
+}
+
+/**
+ * @brief 设置当前ADC增益对应的VDDA（校准时测得，0表示按标称3.3V）
+ */
+void user_drift_set_baseline(uint16_t vdda_mv)
+{
+    g_baseline_mv = (vdda_mv == 0) ? ADC_REFERENCE_MILLIVOLTS : vdda_mv;
+    drift_update_scale();
+}
+
+/**
+ * @brief 获取当前VDDA估计
+ * @return VDDA(mV)，尚未测得时返回0
+ */
+uint16_t user_drift_get_vdda_mv(void)
+{
+    return g_vdda_valid ? (uint16_t)((g_vdda_mv_q4 + 8) >> 4) : 0;
+}
+
+/**
+ * @brief 获取芯片温度
+ * @return true: 已测得温度
+ */
+bool user_drift_get_temperature(int32_t *millicelsius)
+{
+    if (millicelsius == NULL || !g_temperature_valid) {
+        return false;
+    }
+    *millicelsius = g_temperature_mc;
+    return true;
+}
+
+/**
+ * @brief 发送当前VDDA估计、温度和修正系数
+ */
+void user_drift_report(void)
+{
+    firewater_send_drift(user_drift_get_vdda_mv(), g_baseline_mv, g_temperature_mc / 100,
+                         g_scale_q16, g_rejected);
+}
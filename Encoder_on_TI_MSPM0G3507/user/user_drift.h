@@ -0,0 +1,38 @@
+#ifndef USER_DRIFT_H
+#define USER_DRIFT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 后台转换参数：与用户通道共用异步请求队列，交错执行
+#define DRIFT_INTERVAL_MS           1000       // 后台转换周期(ms)
+#define DRIFT_AVERAGE               8          // 每次转换的平均次数
+#define DRIFT_FILTER_SHIFT          2          // VDDA一阶低通，每次更新1/4
+
+// VDDA估计的有效范围（超出视为电源监测异常，不更新修正系数）
+#define DRIFT_VDDA_MIN_MV           2700
+#define DRIFT_VDDA_MAX_MV           3700
+
+// 温度传感器：出厂在30°C下以内部1.4V参考测得校准码值，典型斜率-1.9mV/°C
+#define DRIFT_TEMP_TRIM_C           30
+#define DRIFT_TEMP_MC_PER_CODE_Q8   46052      // 1400/4096 mV / 1.9mV/°C x 1000，每码值毫摄氏度(Q8)
+
+// 内部参考温漂补偿系数(ppm/°C)，按实测填写，0为不补偿
+#define DRIFT_VREF_TEMPCO_PPM       0
+
+// 函数声明
+void user_drift_process(void);
+void user_drift_set_baseline(uint16_t vdda_mv);
+uint16_t user_drift_get_vdda_mv(void);
+bool user_drift_get_temperature(int32_t *millicelsius);
+void user_drift_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_DRIFT_H */
@@ -0,0 +1,307 @@
+#include "user_filter.h"
+#include "ti_msp_dl_config.h"
+#include "delay.h"
+#include "user_uart.h"
+#include <stdio.h>
+#include <string.h>
+
+// 15抽头FIR低通（Hamming窗，截止0.1fs），Q15，系数和为32768（直流增益1）
+static const int16_t fir_lp15_coeffs[15] = {
+    -118, -133, 0, 696, 2205, 4257, 6075, 6804,
+    6075, 4257, 2205, 696, 0, -133, -118
+};
+
+// 31抽头FIR低通（Hamming窗，截止0.05fs），Q15，系数和为32768
+static const int16_t fir_lp31_coeffs[31] = {
+    -57, -65, -79, -88, -69, 0, 145, 385, 724, 1151, 1639,
+    2146, 2619, 3004, 3257, 3344, 3257, 3004, 2619, 2146,
+    1639, 1151, 724, 385, 145, 0, -69, -88, -79, -65, -57
+};
+
+// 2阶巴特沃斯低通（截止0.05fs），{b0,b1,b2,a1,a2}，Q14
+// b系数经过微调，保证直流增益严格为1
+static const int16_t iir_lp2_coeffs[5] = {
+    329, 658, 329, -25576, 10508
+};
+
+// 4阶巴特沃斯低通（截止0.02fs），两级双二阶（Q=0.5412 / Q=1.3066），Q14
+static const int16_t iir_lp4_coeffs[10] = {
+    58, 115, 58, -29136, 12983,
+    62, 122, 62, -31022, 14884
+};
+
+// 预置系数组表（索引与filter_preset_t一致）
+static const filter_preset_desc_t g_filter_presets[FILTER_PRESET_MAX] = {
+    {"BYPASS",  FILTER_TYPE_BYPASS, NULL,            0},
+    {"FIR_LP15", FILTER_TYPE_FIR,   fir_lp15_coeffs, 15},
+    {"FIR_LP31", FILTER_TYPE_FIR,   fir_lp31_coeffs, 31},
+    {"IIR_LP2", FILTER_TYPE_IIR,    iir_lp2_coeffs,  1},
+    {"IIR_LP4", FILTER_TYPE_IIR,    iir_lp4_coeffs,  2},
+    {"CIC_D4",  FILTER_TYPE_CIC,    NULL,            4},
+    {"CIC_D16", FILTER_TYPE_CIC,    NULL,            16},
+};
+
+// 双二阶节状态（直接I型）
+typedef struct {
+    int32_t x1, x2;             // 输入延迟
+    int32_t y1, y2;             // 输出延迟
+} biquad_state_t;
+
+// 当前滤波器状态
+static filter_preset_t g_filter_preset = FILTER_PRESET_BYPASS;
+static const filter_preset_desc_t *g_filter_desc = &g_filter_presets[FILTER_PRESET_BYPASS];
+
+// FIR延迟线：长度为2倍抽头数，每个样本写两份，点积时无需取模
+static int16_t g_fir_history[2 * FILTER_FIR_MAX_TAPS];
+static uint8_t g_fir_pos = 0;
+
+static biquad_state_t g_iir_state[FILTER_IIR_MAX_STAGES];
+
+// CIC积分器与梳状器采用无符号数，依赖模2^32回绕，避免有符号溢出
+static uint32_t g_cic_integrator[FILTER_CIC_ORDER];
+static uint32_t g_cic_comb[FILTER_CIC_ORDER];
+static uint8_t g_cic_phase = 0;
+static uint8_t g_cic_shift = 0;                 // 增益归一化移位 = 阶数 * log2(抽取比)
+
+/**
+ * @brief 原始码值转换为内部定点格式
+ */
+static inline int32_t filter_code_to_internal(uint16_t code)
+{
+    return ((int32_t)code - FILTER_ADC_MIDSCALE) << FILTER_INTERNAL_SHIFT;
+}
+
+/**
+ * @brief 内部定点格式转换回原始码值（四舍五入并限幅到0~4095）
+ */
+static inline uint16_t filter_internal_to_code(int32_t value)
+{
+    int32_t code = ((value + (1 << (FILTER_INTERNAL_SHIFT - 1))) >> FILTER_INTERNAL_SHIFT)
+                   + FILTER_ADC_MIDSCALE;
+    if (code < 0) code = 0;
+    if (code > 4095) code = 4095;
+    return (uint16_t)code;
+}
+
+/**
+ * @brief FIR单样本处理
+ */
+static int32_t filter_fir_step(int32_t x)
+{
+    uint8_t taps = g_filter_desc->length;
+    const int16_t *h = g_filter_desc->coeffs;
+
+    // 最新样本写入pos以及pos+taps，保证history[pos..pos+taps-1]连续
+    g_fir_pos = (g_fir_pos == 0) ? (taps - 1) : (g_fir_pos - 1);
+    g_fir_history[g_fir_pos] = (int16_t)x;
+    g_fir_history[g_fir_pos + taps] = (int16_t)x;
+
+    const int16_t *hist = &g_fir_history[g_fir_pos];
+    int32_t acc = 1 << 14;  // Q15舍入
+    for (uint8_t k = 0; k < taps; k++) {
+        acc += (int32_t)h[k] * hist[k];
+    }
+    return acc >> 15;
+}
+
+/**
+ * @brief 双二阶级联单样本处理
+ */
+static int32_t filter_iir_step(int32_t x)
+{
+    const int16_t *c = g_filter_desc->coeffs;
+
+    for (uint8_t s = 0; s < g_filter_desc->length; s++, c += 5) {
+        biquad_state_t *st = &g_iir_state[s];
+        int32_t acc = (int32_t)c[0] * x + (int32_t)c[1] * st->x1 + (int32_t)c[2] * st->x2
+                    - (int32_t)c[3] * st->y1 - (int32_t)c[4] * st->y2;
+        int32_t y = (acc + (1 << (FILTER_IIR_COEFF_SHIFT - 1))) >> FILTER_IIR_COEFF_SHIFT;
+
+        st->x2 = st->x1;
+        st->x1 = x;
+        st->y2 = st->y1;
+        st->y1 = y;
+        x = y;
+    }
+    return x;
+}
+
+/**
+ * @brief CIC单样本处理
+ * @param output 抽取输出（仅在返回true时有效）
+ * @return 本样本是否产生输出
+ */
+static bool filter_cic_step(int32_t x, int32_t *output)
+{
+    g_cic_integrator[0] += (uint32_t)x;
+    for (uint8_t k = 1; k < FILTER_CIC_ORDER; k++) {
+        g_cic_integrator[k] += g_cic_integrator[k - 1];
+    }
+
+    if (++g_cic_phase < g_filter_desc->length) {
+        return false;
+    }
+    g_cic_phase = 0;
+
+    uint32_t v = g_cic_integrator[FILTER_CIC_ORDER - 1];
+    for (uint8_t k = 0; k < FILTER_CIC_ORDER; k++) {
+        uint32_t delayed = g_cic_comb[k];
+        g_cic_comb[k] = v;
+        v -= delayed;
+    }
+    *output = (int32_t)v >> g_cic_shift;
+    return true;
+}
+
+/**
+ * @brief 初始化滤波模块（默认直通）
+ */
+void user_filter_init(void)
+{
+    user_filter_select(FILTER_PRESET_BYPASS);
+}
+
+/**
+ * @brief 切换预置系数组，同时清空滤波器状态
+ * @param preset 预置编号
+ * @return true: 切换成功, false: 编号无效
+ */
+bool user_filter_select(filter_preset_t preset)
+{
+    if (preset >= FILTER_PRESET_MAX) {
+        return false;
+    }
+
+    g_filter_preset = preset;
+    g_filter_desc = &g_filter_presets[preset];
+
+    // CIC增益为R^N，抽取比为2的幂时可用移位归一化
+    g_cic_shift = 0;
+    if (g_filter_desc->type == FILTER_TYPE_CIC) {
+        for (uint8_t r = g_filter_desc->length; r > 1; r >>= 1) {
+            g_cic_shift += FILTER_CIC_ORDER;
+        }
+    }
+
+    user_filter_reset();
+    return true;
+}
+
+/**
+ * @brief 获取当前预置编号
+ */
+filter_preset_t user_filter_get_preset(void)
+{
+    return g_filter_preset;
+}
+
+/**
+ * @brief 获取预置系数组描述
+ * @return 描述指针，编号无效时返回NULL
+ */
+const filter_preset_desc_t *user_filter_get_desc(filter_preset_t preset)
+{
+    if (preset >= FILTER_PRESET_MAX) {
+        return NULL;
+    }
+    return &g_filter_presets[preset];
+}
+
+/**
+ * @brief 清空滤波器状态（延迟线、积分器等）
+ */
+void user_filter_reset(void)
+{
+    memset(g_fir_history, 0, sizeof(g_fir_history));
+    memset(g_iir_state, 0, sizeof(g_iir_state));
+    memset(g_cic_integrator, 0, sizeof(g_cic_integrator));
+    memset(g_cic_comb, 0, sizeof(g_cic_comb));
+    g_fir_pos = 0;
+    g_cic_phase = 0;
+}
+
+/**
+ * @brief 按块处理ADC原始码值
+ * @param input 输入码值数组
+ * @param output 输出码值数组（可与input相同，原地处理）
+ * @param count 输入样本数
+ * @return 输出样本数（CIC抽取时少于输入）
+ */
+uint16_t user_filter_process_block(const uint16_t *input, uint16_t *output, uint16_t count)
+{
+    uint16_t out_count = 0;
+    int32_t y;
+
+    if (input == NULL || output == NULL) {
+        return 0;
+    }
+
+    // 按类型分派到各自的内循环，循环内不再判断类型
+    switch (g_filter_desc->type) {
+        case FILTER_TYPE_FIR:
+            for (uint16_t i = 0; i < count; i++) {
+                y = filter_fir_step(filter_code_to_internal(input[i]));
+                output[out_count++] = filter_internal_to_code(y);
+            }
+            break;
+
+        case FILTER_TYPE_IIR:
+            for (uint16_t i = 0; i < count; i++) {
+                y = filter_iir_step(filter_code_to_internal(input[i]));
+                output[out_count++] = filter_internal_to_code(y);
+            }
+            break;
+
+        case FILTER_TYPE_CIC:
+            for (uint16_t i = 0; i < count; i++) {
+                if (filter_cic_step(filter_code_to_internal(input[i]), &y)) {
+                    output[out_count++] = filter_internal_to_code(y);
+                }
+            }
+            break;
+
+        case FILTER_TYPE_BYPASS:
+        default:
+            if (output != input) {
+                memcpy(output, input, count * sizeof(uint16_t));
+            }
+            out_count = count;
+            break;
+    }
+
+    return out_count;
+}
+
+/**
+ * @brief 测量各预置滤波器的每样本CPU周期数，结果通过串口输出
+ * @note 测量结束后恢复原先选择的预置
+ */
+void user_filter_benchmark(void)
+{
+    static uint16_t bench_in[64];
+    static uint16_t bench_out[64];
+    filter_preset_t saved = g_filter_preset;
+    char msg[64];
+
+    // 三角波测试数据
+    for (uint16_t i = 0; i < 64; i++) {
+        bench_in[i] = (uint16_t)((i < 32) ? (i * 128) : ((64 - i) * 128));
+    }
+
+    for (uint8_t p = 0; p < FILTER_PRESET_MAX; p++) {
+        user_filter_select((filter_preset_t)p);
+
+        uint32_t start = SysTick->VAL;
+        user_filter_process_block(bench_in, bench_out, 64);
+        uint32_t cycles = get_elapsed_cycles(start, SysTick->VAL);
+
+        // 保留一位小数：cycles*10/64
+        uint32_t per_sample_x10 = (cycles * 10) / 64;
+        snprintf(msg, sizeof(msg), "Filter %s: %u.%u cycles/sample\r\n",
+                 g_filter_presets[p].name,
+                 (unsigned int)(per_sample_x10 / 10), (unsigned int)(per_sample_x10 % 10));
+        user_uart_send_string(msg);
+    }
+
+    user_filter_select(saved);
+}
@@ -0,0 +1,62 @@
+#ifndef USER_FILTER_H
+#define USER_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 滤波器相关定义
+#define FILTER_FIR_MAX_TAPS         32         // FIR最大抽头数
+#define FILTER_IIR_MAX_STAGES       2          // 双二阶节最大级数
+#define FILTER_CIC_ORDER            3          // CIC阶数（积分器/梳状器级数）
+#define FILTER_INTERNAL_SHIFT       3          // 内部定点格式：(原始码值-2048)<<3，范围±16384
+#define FILTER_ADC_MIDSCALE         2048       // 12位ADC中点码值
+#define FILTER_IIR_COEFF_SHIFT      14         // 双二阶系数为Q14格式
+
+// 滤波器类型枚举
+typedef enum {
+    FILTER_TYPE_BYPASS = 0,     // 直通
+    FILTER_TYPE_FIR,            // Q15 FIR
+    FILTER_TYPE_IIR,            // 双二阶级联IIR（直接I型，Q14系数）
+    FILTER_TYPE_CIC             // CIC抽取滤波器
+} filter_type_t;
+
+// 预置系数组枚举（运行时可切换）
+typedef enum {
+    FILTER_PRESET_BYPASS = 0,   // 不滤波
+    FILTER_PRESET_FIR_LP15,     // 15抽头FIR低通，截止0.1fs
+    FILTER_PRESET_FIR_LP31,     // 31抽头FIR低通，截止0.05fs
+    FILTER_PRESET_IIR_LP2,      // 2阶巴特沃斯低通，截止0.05fs
+    FILTER_PRESET_IIR_LP4,      // 4阶巴特沃斯低通（2级级联），截止0.02fs
+    FILTER_PRESET_CIC_DEC4,     // 3阶CIC，4倍抽取
+    FILTER_PRESET_CIC_DEC16,    // 3阶CIC，16倍抽取
+    FILTER_PRESET_MAX
+} filter_preset_t;
+
+// 预置系数组描述
+typedef struct {
+    const char *name;           // 名称（用于串口输出）
+    filter_type_t type;         // 滤波器类型
+    const int16_t *coeffs;      // FIR: Q15抽头；IIR: 每级{b0,b1,b2,a1,a2}(Q14)
+    uint8_t length;             // FIR: 抽头数；IIR: 级数；CIC: 抽取比(2的幂)
+} filter_preset_desc_t;
+
+// 函数声明
+void user_filter_init(void);
+bool user_filter_select(filter_preset_t preset);
+filter_preset_t user_filter_get_preset(void);
+const filter_preset_desc_t *user_filter_get_desc(filter_preset_t preset);
+void user_filter_reset(void);
+uint16_t user_filter_process_block(const uint16_t *input, uint16_t *output, uint16_t count);
+
+// 测试和调试函数
+void user_filter_benchmark(void);  // 各预置滤波器每样本周期数
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_FILTER_H */
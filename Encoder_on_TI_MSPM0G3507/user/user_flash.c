@@ -0,0 +1,57 @@
+#include "user_flash.h"
+#include "ti_msp_dl_config.h"
+#include <string.h>
+
+/**
+ * @brief 擦除一个扇区并写入数据（按64位写入，硬件生成ECC），写后校验
+ * @param address 扇区起始地址（需1KB对齐）
+ * @param data 数据，长度需为8字节的整数倍且不超过一个扇区
+ * @param length 字节数
+ * @return true: 写入并校验成功
+ */
+bool user_flash_write_sector(uint32_t address, const void *data, uint32_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t words[2];
+
+    if ((address % FLASH_SECTOR_SIZE) != 0 || (length % sizeof(uint64_t)) != 0 ||
+        length > FLASH_SECTOR_SIZE) {
+        return false;
+    }
+
+    DL_FlashCTL_executeClearStatus(FLASHCTL);
+    DL_FlashCTL_unprotectSector(FLASHCTL, address, DL_FLASHCTL_REGION_SELECT_MAIN);
+    if (DL_FlashCTL_eraseMemoryFromRAM(FLASHCTL, address, DL_FLASHCTL_COMMAND_SIZE_SECTOR) !=
+        DL_FLASHCTL_COMMAND_STATUS_PASSED) {
+        return false;
+    }
+
+    for (uint32_t offset = 0; offset < length; offset += sizeof(uint64_t)) {
+        memcpy(words, &bytes[offset], sizeof(words));  // 源数据不要求对齐
+        DL_FlashCTL_executeClearStatus(FLASHCTL);
+        DL_FlashCTL_unprotectSector(FLASHCTL, address + offset, DL_FLASHCTL_REGION_SELECT_MAIN);
+        if (DL_FlashCTL_programMemoryFromRAM64WithECCGenerated(FLASHCTL, address + offset,
+                words) != DL_FLASHCTL_COMMAND_STATUS_PASSED) {
+            return false;
+        }
+    }
+
+    return memcmp((const void *)address, data, length) == 0;
+}
+
+/**
+ * @brief CRC16-CCITT（Flash记录和上传数据校验，只在加载/保存时计算）
+ */
+uint16_t user_flash_crc16(const void *data, uint32_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint16_t crc = 0xFFFF;
+
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)bytes[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
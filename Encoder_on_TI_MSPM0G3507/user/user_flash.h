@@ -0,0 +1,22 @@
+#ifndef USER_FLASH_H
+#define USER_FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 主Flash扇区大小（擦除单位）
+#define FLASH_SECTOR_SIZE           1024U
+
+// 函数声明
+bool user_flash_write_sector(uint32_t address, const void *data, uint32_t length);
+uint16_t user_flash_crc16(const void *data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_FLASH_H */
@@ -82,64 +82,12 @@ void GROUP1_IRQHandler(void)
             }
             break;
             
-        // 检查是否是编码器的GPIO中断 (GPIOA)
+#if !ENCODER_USE_QEI
+        // 编码器的GPIO中断 (GPIOA)：两相双边沿查表解码，QEI模式下由TIMG8硬件计数
         case ENCODER_INT_IIDX:
-            {
-                uint32_t interrupts = DL_GPIO_getEnabledInterruptStatus(GPIOA, 
-                    ENCODER_PIN_A | ENCODER_PIN_B);
-                
-                if (interrupts != 0) {
-                    // 只处理PIN_A中断 (PA17) - 避免重复计数
-                    if (interrupts & ENCODER_PIN_A) {
-                        // 延时消抖 - 100us提高稳定性
-                        delay_us(100);
-                        
-                        // 读取引脚状态确保稳定
-                        uint8_t pin_a = DL_GPIO_readPins(ENCODER_PIN_A_PORT, ENCODER_PIN_A) ? 1 : 0;
-                        uint8_t pin_b = DL_GPIO_readPins(ENCODER_PIN_B_PORT, ENCODER_PIN_B) ? 1 : 0;
-                        
-                        // 只有在A引脚确实为低电平时才处理（确认下降沿）
-                        if (pin_a == 0) {
-                            // 根据PIN_B状态判断方向
-                            if (pin_b == 0) {
-                                // PIN_B为低电平，逆时针旋转，计数减1
-                                g_encoder_state.count--;
-                            } else {
-                                // PIN_B为高电平，顺时针旋转，计数加1
-                                g_encoder_state.count++;
-                            }
-                            
-                            // 限制计数范围
-                            if (g_encoder_state.count < ENCODER_COUNT_MIN) {
-                                g_encoder_state.count = ENCODER_COUNT_MIN;
-                            }
-                            if (g_encoder_state.count > ENCODER_COUNT_MAX) {
-                                g_encoder_state.count = ENCODER_COUNT_MAX;
-                            }
-                            
-                            // 设置变化标志
-                            if (g_encoder_state.count != g_encoder_state.last_count) {
-                                g_encoder_state.count_changed = true;
-                                g_encoder_state.last_count = g_encoder_state.count;
-                                
-                                // 更新电压和DAC值
-                                g_encoder_state.target_voltage = user_encoder_count_to_voltage(g_encoder_state.count);
-                                g_encoder_state.dac_value = user_encoder_voltage_to_dac(g_encoder_state.target_voltage);
-                            }
-                        }
-                        
-                        // 清除中断标志
-                        DL_GPIO_clearInterruptStatus(ENCODER_PIN_A_PORT, ENCODER_PIN_A);
-                    }
-                    
-                    // PIN_B中断处理 - 只清除中断标志，不处理逻辑
-                    if (interrupts & ENCODER_PIN_B) {
-                        // 简单的清除中断标志，避免重复计数
-                        DL_GPIO_clearInterruptStatus(ENCODER_PIN_B_PORT, ENCODER_PIN_B);
-                    }
-                }
-            }
+            user_encoder_gpio_irq();
             break;
+#endif
         
         default:
             break;
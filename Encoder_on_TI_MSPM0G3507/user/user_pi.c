@@ -0,0 +1,64 @@
+#include "user_pi.h"
+#include <stddef.h>
+
+/**
+ * @brief 初始化PI控制器并清零积分
+ */
+void user_pi_init(pi_controller_t *pi, int32_t kp_q16, int32_t ki_q16,
+                  int32_t out_min, int32_t out_max)
+{
+    if (pi == NULL) {
+        return;
+    }
+    pi->kp_q16 = kp_q16;
+    pi->ki_q16 = ki_q16;
+    pi->out_min = out_min;
+    pi->out_max = out_max;
+    user_pi_reset(pi);
+}
+
+/**
+ * @brief 清零积分和输出
+ */
+void user_pi_reset(pi_controller_t *pi)
+{
+    if (pi == NULL) {
+        return;
+    }
+    pi->integral_q16 = 0;
+    pi->output = 0;
+    pi->saturated = false;
+}
+
+/**
+ * @brief 执行一次PI计算（按固定周期调用）
+ * 抗积分饱和：积分项本身限制在输出范围内；输出已限幅且误差仍朝同一方向时不再累加积分
+ * @param error 设定值减测量值
+ * @return 限幅后的控制量
+ */
+int32_t user_pi_step(pi_controller_t *pi, int32_t error)
+{
+    int64_t min_q16 = (int64_t)pi->out_min << 16;
+    int64_t max_q16 = (int64_t)pi->out_max << 16;
+    int64_t proportional = (int64_t)pi->kp_q16 * error;
+    int64_t integral = pi->integral_q16 + (int64_t)pi->ki_q16 * error;
+
+    if (integral > max_q16) integral = max_q16;
+    if (integral < min_q16) integral = min_q16;
+
+    int64_t output = proportional + integral;
+    bool high = output > max_q16;
+    bool low = output < min_q16;
+
+    // 条件积分：饱和方向与误差方向一致时保持原积分
+    if (!((high && error > 0) || (low && error < 0))) {
+        pi->integral_q16 = integral;
+    }
+
+    if (high) output = max_q16;
+    if (low) output = min_q16;
+
+    pi->saturated = high || low;
+    pi->output = (int32_t)((output + 0x8000) >> 16);
+    return pi->output;
+}
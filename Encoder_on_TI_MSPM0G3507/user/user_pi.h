@@ -0,0 +1,33 @@
+#ifndef USER_PI_H
+#define USER_PI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 定点PI控制器：不依赖外设，可在主机上配合仿真对象单独编译测试
+// 增益为Q16，输入为误差（任意整数单位），输出为限幅后的控制量
+typedef struct {
+    int32_t kp_q16;             // 比例增益(Q16)
+    int32_t ki_q16;             // 积分增益，每次调用累加(Q16)
+    int32_t out_min;            // 输出下限
+    int32_t out_max;            // 输出上限
+    int64_t integral_q16;       // 积分项(Q16)
+    int32_t output;             // 最近一次输出
+    bool saturated;             // 最近一次输出被限幅
+} pi_controller_t;
+
+// 函数声明
+void user_pi_init(pi_controller_t *pi, int32_t kp_q16, int32_t ki_q16,
+                  int32_t out_min, int32_t out_max);
+void user_pi_reset(pi_controller_t *pi);
+int32_t user_pi_step(pi_controller_t *pi, int32_t error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_PI_H */
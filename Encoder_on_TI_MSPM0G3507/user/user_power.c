@@ -0,0 +1,265 @@
+#include "user_power.h"
+#include "user_ADC.h"
+#include "firewater_protocol.h"
+#include "ti_msp_dl_config.h"
+#include <stddef.h>
+
+// ADC1时钟与ADC0（SysConfig）一致：SYSOSC/8 = 4MHz
+static const DL_ADC12_ClockConfig g_adc1_clock_config = {
+    .clockSel    = DL_ADC12_CLOCK_SYSOSC,
+    .divideRatio = DL_ADC12_CLOCK_DIVIDE_8,
+    .freqRange   = DL_ADC12_CLOCK_FREQ_RANGE_24_TO_32,
+};
+
+// 触发定时器时钟：BUSCLK 32MHz / 32 = 1MHz
+static const DL_TimerG_ClockConfig g_trigger_clock_config = {
+    .clockSel    = DL_TIMER_CLOCK_BUSCLK,
+    .divideRatio = DL_TIMER_CLOCK_DIVIDE_1,
+    .prescale    = 31U
+};
+
+// 窗口累加值（中断中累加，窗口结束时整体交给主循环）
+typedef struct {
+    int64_t sum_voltage;        // 电压和(mV)
+    int64_t sum_current;        // 电流和(mA)
+    int64_t sum_power;          // 瞬时功率和(uW)
+    int32_t last_power;         // 最后一个样本的瞬时功率(uW)
+    uint32_t count;             // 样本数
+} power_window_t;
+
+static power_config_t g_power_config = {
+    .sample_rate_hz = POWER_DEFAULT_RATE_HZ,
+    .window = POWER_DEFAULT_WINDOW,
+    .voltage_mv_per_code_q16 = POWER_DEFAULT_MV_PER_CODE_Q16,
+    .current_ma_per_code_q16 = POWER_DEFAULT_MA_PER_CODE_Q16,
+    .current_zero_code = POWER_DEFAULT_CURRENT_ZERO
+};
+
+static volatile bool g_power_running = false;
+static power_window_t g_window;                    // 正在累加的窗口
+static power_window_t g_window_done;               // 已完成待处理的窗口
+static volatile bool g_window_ready = false;       // g_window_done有效
+static volatile uint32_t g_window_overrun = 0;     // 主循环未及时取走而丢弃的窗口数
+static volatile uint32_t g_pair_timeout = 0;       // ADC0结果未按时到达的次数
+static int64_t g_energy_uw_samples = 0;            // 累计能量（uW x 采样周期）
+static power_record_t g_last_record;
+static bool g_record_valid = false;
+
+/**
+ * @brief 把ADC配置为由事件触发的单通道重复转换
+ */
+static void power_config_adc(ADC12_Regs *adc, uint32_t channel)
+{
+    DL_ADC12_disableConversions(adc);
+    DL_ADC12_initSingleSample(adc, DL_ADC12_REPEAT_MODE_ENABLED, DL_ADC12_SAMPLING_SOURCE_AUTO,
+        DL_ADC12_TRIG_SRC_EVENT, DL_ADC12_SAMP_CONV_RES_12_BIT, DL_ADC12_SAMP_CONV_DATA_FORMAT_UNSIGNED);
+    DL_ADC12_configConversionMem(adc, DL_ADC12_MEM_IDX_0, channel,
+        DL_ADC12_REFERENCE_VOLTAGE_VDDA, DL_ADC12_SAMPLE_TIMER_SOURCE_SCOMP0,
+        DL_ADC12_AVERAGING_MODE_DISABLED, DL_ADC12_BURN_OUT_SOURCE_DISABLED,
+        DL_ADC12_TRIGGER_MODE_TRIGGER_NEXT, DL_ADC12_WINDOWS_COMP_MODE_DISABLED);
+    DL_ADC12_setSampleTime0(adc, POWER_SAMPLE_TIME);
+    DL_ADC12_setSubscriberChanID(adc, POWER_EVENT_CHANNEL);
+}
+
+/**
+ * @brief 设置采样率、窗口和换算系数（仅停止时允许修改）
+ * @return true: 设置成功, false: 参数无效或正在采样
+ */
+bool user_power_configure(const power_config_t *config)
+{
+    if (config == NULL || g_power_running) {
+        return false;
+    }
+    if (config->sample_rate_hz == 0 || config->sample_rate_hz > POWER_MAX_RATE_HZ ||
+        config->window == 0) {
+        return false;
+    }
+
+    g_power_config = *config;
+    return true;
+}
+
+/**
+ * @brief 启动同步采样：ADC0测电压、ADC1测电流，同一个定时器事件触发
+ * 采样期间ADC0由本模块独占，停止时恢复SysConfig配置
+ * @return true: 启动成功, false: ADC0正被高速采样或异步请求占用，或已在运行
+ */
+bool user_power_start(void)
+{
+    if (g_power_running || user_adc_is_sampling() || user_adc_async_busy()) {
+        return false;
+    }
+
+    g_window.sum_voltage = 0;
+    g_window.sum_current = 0;
+    g_window.sum_power = 0;
+    g_window.count = 0;
+    g_window_ready = false;
+    g_window_overrun = 0;
+    g_pair_timeout = 0;
+    g_energy_uw_samples = 0;
+    g_record_valid = false;
+
+    // ADC0：关闭单次读取用的中断，改为事件触发
+    DL_ADC12_disableInterrupt(ADC12_0_INST, DL_ADC12_INTERRUPT_MEM0_RESULT_LOADED);
+    power_config_adc(ADC0, POWER_VOLTAGE_CHANNEL);
+
+    // ADC1：SysConfig未使用，在此完整初始化；其结果中断负责读取两路结果
+    DL_ADC12_reset(ADC1);
+    DL_ADC12_enablePower(ADC1);
+    delay_cycles(16);  // 外设上电等待
+    DL_ADC12_setClockConfig(ADC1, (DL_ADC12_ClockConfig *)&g_adc1_clock_config);
+    power_config_adc(ADC1, POWER_CURRENT_CHANNEL);
+    DL_ADC12_clearInterruptStatus(ADC1, DL_ADC12_INTERRUPT_MEM0_RESULT_LOADED);
+    DL_ADC12_enableInterrupt(ADC1, DL_ADC12_INTERRUPT_MEM0_RESULT_LOADED);
+    NVIC_ClearPendingIRQ(ADC1_INT_IRQn);
+    NVIC_EnableIRQ(ADC1_INT_IRQn);
+
+    DL_ADC12_enableConversions(ADC0);
+    DL_ADC12_enableConversions(ADC1);
+
+    // 触发定时器：1MHz计数，每个周期零点发布一次事件
+    DL_TimerG_TimerConfig timer_config = {
+        .period     = 1000000U / g_power_config.sample_rate_hz - 1U,
+        .timerMode  = DL_TIMER_TIMER_MODE_PERIODIC,
+        .startTimer = DL_TIMER_STOP,
+    };
+    DL_TimerG_reset(POWER_TRIGGER_TIMER);
+    DL_TimerG_enablePower(POWER_TRIGGER_TIMER);
+    delay_cycles(16);  // 外设上电等待
+    DL_TimerG_setClockConfig(POWER_TRIGGER_TIMER, (DL_TimerG_ClockConfig *)&g_trigger_clock_config);
+    DL_TimerG_initTimerMode(POWER_TRIGGER_TIMER, &timer_config);
+    DL_TimerG_enableEvent(POWER_TRIGGER_TIMER, DL_TIMER_EVENT_ROUTE_1, DL_TIMER_EVENT_ZERO_EVENT);
+    DL_TimerG_setPublisherChanID(POWER_TRIGGER_TIMER, DL_TIMER_PUBLISHER_INDEX_0, POWER_EVENT_CHANNEL);
+    DL_TimerG_enableClock(POWER_TRIGGER_TIMER);
+
+    g_power_running = true;
+    DL_TimerG_startCounter(POWER_TRIGGER_TIMER);
+    return true;
+}
+
+/**
+ * @brief 停止同步采样，ADC1下电，ADC0恢复为SysConfig的单次软件触发配置
+ * 注意：恢复会清除ADC0上的窗口比较器配置，需要时重新调用user_adc_alarm_configure
+ */
+void user_power_stop(void)
+{
+    if (!g_power_running) {
+        return;
+    }
+    g_power_running = false;
+
+    DL_TimerG_stopCounter(POWER_TRIGGER_TIMER);
+    DL_TimerG_disablePower(POWER_TRIGGER_TIMER);
+
+    NVIC_DisableIRQ(ADC1_INT_IRQn);
+    DL_ADC12_disableConversions(ADC1);
+    DL_ADC12_disablePower(ADC1);
+
+    DL_ADC12_reset(ADC12_0_INST);
+    DL_ADC12_enablePower(ADC12_0_INST);
+    delay_cycles(16);  // 外设上电等待
+    SYSCFG_DL_ADC12_0_init();
+    user_adc_init();
+}
+
+/**
+ * @brief 是否正在同步采样
+ */
+bool user_power_is_running(void)
+{
+    return g_power_running;
+}
+
+/**
+ * @brief ADC1中断：一个同步采样点的两路结果都已就绪
+ * 两个ADC配置相同且由同一事件启动，ADC0的结果最多晚几个时钟写入，短暂等待其原始标志
+ */
+void ADC1_IRQHandler(void)
+{
+    if (DL_ADC12_getPendingInterrupt(ADC1) != DL_ADC12_IIDX_MEM0_RESULT_LOADED) {
+        return;
+    }
+
+    uint8_t wait = POWER_PAIR_WAIT_LOOPS;
+    while (!DL_ADC12_getRawInterruptStatus(ADC0, DL_ADC12_INTERRUPT_MEM0_RESULT_LOADED) && wait > 0) {
+        wait--;
+    }
+    if (wait == 0) {
+        g_pair_timeout++;  // 未配对，沿用ADC0上一次结果
+    }
+    DL_ADC12_clearInterruptStatus(ADC0, DL_ADC12_INTERRUPT_MEM0_RESULT_LOADED);
+
+    uint32_t raw_v = DL_ADC12_getMemResult(ADC0, DL_ADC12_MEM_IDX_0);
+    int32_t raw_i = (int32_t)DL_ADC12_getMemResult(ADC1, DL_ADC12_MEM_IDX_0) -
+                    g_power_config.current_zero_code;
+
+    // 定点换算：mV、mA，瞬时功率为uW
+    int32_t voltage_mv = (int32_t)((raw_v * g_power_config.voltage_mv_per_code_q16) >> 16);
+    int32_t current_ma = (raw_i * g_power_config.current_ma_per_code_q16) >> 16;
+    int32_t power_uw = voltage_mv * current_ma;
+
+    g_window.sum_voltage += voltage_mv;
+    g_window.sum_current += current_ma;
+    g_window.sum_power += power_uw;
+    g_window.last_power = power_uw;
+
+    if (++g_window.count >= g_power_config.window) {
+        if (g_window_ready) {
+            g_window_overrun++;
+        } else {
+            g_window_done = g_window;
+            g_window_ready = true;
+        }
+        g_window.sum_voltage = 0;
+        g_window.sum_current = 0;
+        g_window.sum_power = 0;
+        g_window.count = 0;
+    }
+}
+
+/**
+ * @brief 功率处理函数，需在主循环中调用
+ * 窗口结束后计算平均值、有功功率和累计能量（除法不在中断中执行）并发送
+ */
+void user_power_process(void)
+{
+    if (!g_window_ready) {
+        return;
+    }
+
+    power_window_t window = g_window_done;
+    g_window_ready = false;
+
+    int64_t count = window.count;
+    g_energy_uw_samples += window.sum_power;
+
+    g_last_record.samples = window.count;
+    g_last_record.dropped_windows = g_window_overrun;
+    g_last_record.pair_timeouts = g_pair_timeout;
+    g_last_record.voltage_mv = (int32_t)(window.sum_voltage / count);
+    g_last_record.current_ma = (int32_t)(window.sum_current / count);
+    g_last_record.instant_power_mw = window.last_power / 1000;
+    g_last_record.real_power_mw = (int32_t)(window.sum_power / (count * 1000));
+    // uW x 采样周期 -> mJ：除以采样率得到uJ，再除以1000
+    g_last_record.energy_mj = g_energy_uw_samples /
+                              ((int64_t)g_power_config.sample_rate_hz * 1000);
+    g_record_valid = true;
+
+    firewater_send_power_record(g_last_record.voltage_mv, g_last_record.current_ma,
+                                g_last_record.instant_power_mw, g_last_record.real_power_mw,
+                                g_last_record.energy_mj);
+}
+
+/**
+ * @brief 获取最近一个窗口的测量结果
+ * @return true: 结果有效
+ */
+bool user_power_get_record(power_record_t *record)
+{
+    if (record == NULL || !g_record_valid) {
+        return false;
+    }
+    *record = g_last_record;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef USER_POWER_H
+#define USER_POWER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 同步采样硬件分配：TIMG0零点事件经分发通道同时触发ADC0和ADC1
+#define POWER_TRIGGER_TIMER         TIMG0
+#define POWER_EVENT_CHANNEL         12         // 12~15为一对二分发通道，可同时驱动两个订阅者
+#define POWER_VOLTAGE_CHANNEL       DL_ADC12_INPUT_CHAN_0   // ADC0通道0，PA27
+#define POWER_CURRENT_CHANNEL       DL_ADC12_INPUT_CHAN_1   // ADC1通道1，PA16
+#define POWER_SAMPLE_TIME           16         // 采样保持时间（ADC时钟周期，4MHz下4us）
+#define POWER_PAIR_WAIT_LOOPS       32         // ADC1中断中等待ADC0结果的最大轮询次数
+
+// 采样参数
+#define POWER_DEFAULT_RATE_HZ       10000      // 默认同步采样率
+#define POWER_MAX_RATE_HZ           50000      // 最大同步采样率
+#define POWER_DEFAULT_WINDOW        1000       // 默认统计窗口（样本数）
+
+// 默认换算：电压直接接ADC；电流传感器100mV/A，零电流输出为中点
+#define POWER_DEFAULT_MV_PER_CODE_Q16   52814U     // 3300 * 65536 / 4095
+#define POWER_DEFAULT_MA_PER_CODE_Q16   528140U    // (3300/4095) mV / 100mV/A * 1000，Q16
+#define POWER_DEFAULT_CURRENT_ZERO      2048       // 零电流时的电流通道码值
+
+// 换算配置（全部为定点系数，中断中只做整数乘法和移位）
+typedef struct {
+    uint32_t sample_rate_hz;        // 同步采样率
+    uint32_t window;                // 统计窗口（样本数）
+    uint32_t voltage_mv_per_code_q16;   // 电压通道每码值毫伏数（含分压比），Q16
+    int32_t current_ma_per_code_q16;    // 电流通道每码值毫安数，Q16（可为负以反转方向）
+    uint16_t current_zero_code;     // 零电流码值
+} power_config_t;
+
+// 窗口测量结果
+typedef struct {
+    int32_t voltage_mv;             // 窗口平均电压
+    int32_t current_ma;             // 窗口平均电流
+    int32_t instant_power_mw;       // 窗口最后一个样本的瞬时功率
+    int32_t real_power_mw;          // 有功功率：瞬时功率的窗口平均
+    int64_t energy_mj;              // 启动以来累计能量
+    uint32_t samples;               // 窗口样本数
+    uint32_t dropped_windows;       // 启动以来因主循环未及时处理而丢弃的窗口数
+    uint32_t pair_timeouts;         // 启动以来两路结果未配对的次数
+} power_record_t;
+
+// 函数声明
+bool user_power_configure(const power_config_t *config);
+bool user_power_start(void);
+void user_power_stop(void);
+bool user_power_is_running(void);
+void user_power_process(void);
+bool user_power_get_record(power_record_t *record);
+
+// ADC1中断服务函数（每个同步采样点一次）
+void ADC1_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_POWER_H */
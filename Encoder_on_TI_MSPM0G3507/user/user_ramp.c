@@ -0,0 +1,269 @@
+#include "user_ramp.h"
+#include "user_DAC.h"
+#include "firewater_protocol.h"
+#include "delay.h"
+#include "ti_msp_dl_config.h"
+
+// 定时器时钟：BUSCLK 32MHz / 32 = 1MHz
+static const DL_TimerG_ClockConfig g_ramp_clock_config = {
+    .clockSel    = DL_TIMER_CLOCK_BUSCLK,
+    .divideRatio = DL_TIMER_CLOCK_DIVIDE_1,
+    .prescale    = 31U
+};
+
+static const DL_TimerG_TimerConfig g_ramp_timer_config = {
+    .period     = 1000000U / RAMP_TICK_HZ - 1U,
+    .timerMode  = DL_TIMER_TIMER_MODE_PERIODIC,
+    .startTimer = DL_TIMER_STOP,
+};
+
+// 斜坡状态：码值均为校正前的理想码值，输出时才经过校正表
+static volatile int32_t g_current_q16 = 0;      // 当前输出码值(Q16)，复位后DAC输出为0
+static volatile uint16_t g_target_code = 0;     // 目标码值
+static uint16_t g_start_code = 0;               // 本段斜坡起点（计算进度用）
+static int32_t g_step_q16 = 0;                  // 每个节拍的码值步进(Q16)，0为不限速
+static uint16_t g_slew_mv_per_ms = 0;
+static volatile bool g_active = false;          // 定时器运行中
+static volatile bool g_finished = false;        // 到达目标，待发送最后一帧遥测
+static volatile int16_t g_trim_codes = 0;       // 闭环微调量（叠加在斜坡输出上）
+static uint32_t g_last_report_ms = 0;
+static bool g_engine_was_running = false;     // 上次处理时DAC波形引擎在运行
+
+/**
+ * @brief 码值换算为毫伏（x 3300 / 4095，四舍五入）
+ */
+static uint16_t ramp_code_to_mv(uint16_t code)
+{
+    return (uint16_t)(((uint32_t)code * 3300U + DAC_MAX_VALUE / 2) / DAC_MAX_VALUE);
+}
+
+/**
+ * @brief 按当前码值加闭环微调量写DAC
+ * 波形引擎运行时DAC归引擎所有，只更新斜坡状态不写DAC，引擎停止后由user_ramp_process补写
+ */
+static void ramp_output(int32_t current_q16)
+{
+    if (DAC_isRunning()) {
+        return;
+    }
+
+    int32_t code = ((current_q16 + 0x8000) >> 16) + g_trim_codes;
+
+    if (code < 0) code = 0;
+    if (code > DAC_MAX_VALUE) code = DAC_MAX_VALUE;
+    DL_DAC12_output12(DAC_INST, DAC_correctCode((uint16_t)code));
+}
+
+/**
+ * @brief 初始化斜坡定时器（SysConfig未使用TIMG6，在此运行时配置）
+ * 定时器只在斜坡进行中运行，到达目标后由中断自行停止
+ */
+void user_ramp_init(void)
+{
+    user_ramp_set_slew(RAMP_DEFAULT_SLEW_MV_PER_MS);
+
+    DL_TimerG_reset(RAMP_TIMER);
+    DL_TimerG_enablePower(RAMP_TIMER);
+    delay_cycles(16);  // 外设上电等待
+
+    DL_TimerG_setClockConfig(RAMP_TIMER, (DL_TimerG_ClockConfig *)&g_ramp_clock_config);
+    DL_TimerG_initTimerMode(RAMP_TIMER, (DL_TimerG_TimerConfig *)&g_ramp_timer_config);
+    DL_TimerG_enableInterrupt(RAMP_TIMER, DL_TIMERG_INTERRUPT_ZERO_EVENT);
+    DL_TimerG_enableClock(RAMP_TIMER);
+
+    NVIC_SetPriority(RAMP_TIMER_IRQN, RAMP_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(RAMP_TIMER_IRQN);
+    NVIC_EnableIRQ(RAMP_TIMER_IRQN);
+}
+
+/**
+ * @brief 设置目标电压，从当前输出位置开始（斜坡进行中也可直接改目标，不会跳变）
+ * @param millivolts 目标电压(mV)，超过3300按3300处理
+ */
+void user_ramp_set_target_mv(uint16_t millivolts)
+{
+    if (millivolts > 3300) {
+        millivolts = 3300;
+    }
+    uint16_t code = (uint16_t)(((uint32_t)millivolts * DAC_MAX_VALUE) / 3300U);
+
+    // 与中断中的到达判断互斥，避免刚停下的定时器漏掉新目标
+    NVIC_DisableIRQ(RAMP_TIMER_IRQN);
+    g_target_code = code;
+    g_start_code = (uint16_t)((g_current_q16 + 0x8000) >> 16);
+
+    if (g_step_q16 == 0) {
+        // 不限速：直接输出
+        g_current_q16 = (int32_t)code << 16;
+        ramp_output(g_current_q16);
+        g_finished = true;
+    } else if (!g_active) {
+        g_active = true;
+        g_finished = false;
+        DL_TimerG_startCounter(RAMP_TIMER);
+    }
+    NVIC_EnableIRQ(RAMP_TIMER_IRQN);
+}
+
+/**
+ * @brief 获取目标电压(mV)
+ */
+uint16_t user_ramp_get_target_mv(void)
+{
+    return ramp_code_to_mv(g_target_code);
+}
+
+/**
+ * @brief 设置闭环微调量（码值），斜坡静止时立即写DAC，进行中由下一个节拍带出
+ */
+void user_ramp_set_trim(int16_t codes)
+{
+    NVIC_DisableIRQ(RAMP_TIMER_IRQN);
+    g_trim_codes = codes;
+    if (!g_active) {
+        ramp_output(g_current_q16);
+    }
+    NVIC_EnableIRQ(RAMP_TIMER_IRQN);
+}
+
+/**
+ * @brief 按斜坡当前位置和微调量重新写DAC（波形引擎停止后恢复静态输出）
+ */
+void user_ramp_refresh(void)
+{
+    NVIC_DisableIRQ(RAMP_TIMER_IRQN);
+    ramp_output(g_current_q16);
+    NVIC_EnableIRQ(RAMP_TIMER_IRQN);
+}
+
+/**
+ * @brief 设置压摆率
+ * @param mv_per_ms 压摆率(mV/ms)，0为不限速
+ * @return true: 设置成功, false: 超出范围
+ */
+bool user_ramp_set_slew(uint16_t mv_per_ms)
+{
+    if (mv_per_ms > RAMP_MAX_SLEW_MV_PER_MS) {
+        return false;
+    }
+
+    // 每节拍码值步进 = mV/ms x 4095/3300 / (节拍/ms)，Q16
+    g_step_q16 = (int32_t)(((uint64_t)mv_per_ms * DAC_MAX_VALUE * 65536U * 1000U) /
+                           (3300U * (uint64_t)RAMP_TICK_HZ));
+    if (mv_per_ms > 0 && g_step_q16 == 0) {
+        g_step_q16 = 1;
+    }
+    g_slew_mv_per_ms = mv_per_ms;
+    return true;
+}
+
+/**
+ * @brief 获取当前压摆率(mV/ms)
+ */
+uint16_t user_ramp_get_slew(void)
+{
+    return g_slew_mv_per_ms;
+}
+
+/**
+ * @brief 斜坡是否进行中
+ */
+bool user_ramp_is_active(void)
+{
+    return g_active;
+}
+
+/**
+ * @brief 获取当前输出电压(mV，校正前)
+ */
+uint16_t user_ramp_get_output_mv(void)
+{
+    return ramp_code_to_mv((uint16_t)((g_current_q16 + 0x8000) >> 16));
+}
+
+/**
+ * @brief 获取本段斜坡进度 (0 ~ 100)
+ */
+uint8_t user_ramp_get_progress(void)
+{
+    int32_t current = (g_current_q16 + 0x8000) >> 16;
+    int32_t total = (int32_t)g_target_code - (int32_t)g_start_code;
+    int32_t done = current - (int32_t)g_start_code;
+
+    if (total == 0) {
+        return 100;
+    }
+    if (total < 0) {
+        total = -total;
+        done = -done;
+    }
+    if (done <= 0) {
+        return 0;
+    }
+    return (done >= total) ? 100 : (uint8_t)((done * 100) / total);
+}
+
+/**
+ * @brief 斜坡遥测，需在主循环中调用
+ * 进行中每RAMP_REPORT_INTERVAL_MS发送一帧，到达目标时再发送一帧；
+ * 波形引擎停止后重新输出当前设定值
+ */
+void user_ramp_process(void)
+{
+    uint32_t now = get_system_time_ms();
+    bool finished = g_finished;
+    bool engine_running = DAC_isRunning();
+
+    if (g_engine_was_running && !engine_running) {
+        user_ramp_refresh();
+    }
+    g_engine_was_running = engine_running;
+
+    if (!finished && !(g_active && now - g_last_report_ms >= RAMP_REPORT_INTERVAL_MS)) {
+        return;
+    }
+    if (finished) {
+        g_finished = false;
+    }
+
+    g_last_report_ms = now;
+    user_ramp_report();
+}
+
+/**
+ * @brief 发送当前输出、目标、进度和压摆率
+ */
+void user_ramp_report(void)
+{
+    firewater_send_ramp(user_ramp_get_output_mv(), user_ramp_get_target_mv(),
+                        user_ramp_get_progress(), g_slew_mv_per_ms);
+}
+
+/**
+ * @brief 斜坡定时器中断：向目标走一步并写DAC，到达后停止定时器
+ */
+void TIMG6_IRQHandler(void)
+{
+    if (DL_TimerG_getPendingInterrupt(RAMP_TIMER) != DL_TIMER_IIDX_ZERO) {
+        return;
+    }
+
+    int32_t target = (int32_t)g_target_code << 16;
+    int32_t current = g_current_q16;
+
+    if (current < target) {
+        current += g_step_q16;
+        if (current > target) current = target;
+    } else if (current > target) {
+        current -= g_step_q16;
+        if (current < target) current = target;
+    }
+    g_current_q16 = current;
+    ramp_output(current);
+
+    if (current == target) {
+        DL_TimerG_stopCounter(RAMP_TIMER);
+        g_active = false;
+        g_finished = true;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef USER_RAMP_H
+#define USER_RAMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 设定值斜坡：定时器中断按固定节拍把DAC从当前码值推向目标码值
+#define RAMP_TIMER                  TIMG6
+#define RAMP_TIMER_IRQN             TIMG6_INT_IRQn
+#define RAMP_TICK_HZ                10000      // 斜坡更新节拍（100us一步）
+#define RAMP_IRQ_PRIORITY           1          // 与编码器相同，低于DAC补充中断
+
+// 压摆率(mV/ms)：默认0.1V一格约10ms走完，0表示不限速（直接跳变）
+#define RAMP_DEFAULT_SLEW_MV_PER_MS 10
+#define RAMP_MAX_SLEW_MV_PER_MS     3300
+#define RAMP_REPORT_INTERVAL_MS     50         // 斜坡进行中的遥测间隔
+
+// 函数声明
+void user_ramp_init(void);
+void user_ramp_set_target_mv(uint16_t millivolts);
+uint16_t user_ramp_get_target_mv(void);
+void user_ramp_set_trim(int16_t codes);
+void user_ramp_refresh(void);
+bool user_ramp_set_slew(uint16_t mv_per_ms);
+uint16_t user_ramp_get_slew(void);
+bool user_ramp_is_active(void);
+uint16_t user_ramp_get_output_mv(void);
+uint8_t user_ramp_get_progress(void);
+void user_ramp_process(void);
+void user_ramp_report(void);
+
+// 斜坡定时器中断服务函数
+void TIMG6_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_RAMP_H */
@@ -0,0 +1,186 @@
+#include "user_regulator.h"
+#include "user_pi.h"
+#include "user_ramp.h"
+#include "user_ADC.h"
+#include "user_power.h"
+#include "user_DAC.h"
+#include "firewater_protocol.h"
+#include "delay.h"
+#include <stddef.h>
+
+static bool g_enabled = false;
+static pi_controller_t g_pi;
+static uint32_t g_last_submit_ms = 0;
+static uint32_t g_last_report_ms = 0;
+static bool g_request_pending = false;          // 本周期的转换尚未完成
+static uint16_t g_measured_mv = 0;
+static uint32_t g_saturations = 0;              // 输出限幅的周期数
+
+// 阶跃响应统计
+static regulator_metrics_t g_metrics;
+static bool g_step_valid = false;               // 已开始统计（开启后第一次测量时开始）
+static uint16_t g_step_start_mv = 0;            // 阶跃开始时的测量值
+static uint32_t g_step_start_ms = 0;
+static uint32_t g_band_start_ms = 0;            // 本次进入稳定带的时刻
+static uint8_t g_band_count = 0;                // 连续在稳定带内的次数
+
+/**
+ * @brief 目标变化时重新开始阶跃响应统计
+ */
+static void regulator_start_step(uint16_t target_mv, uint32_t now)
+{
+    g_metrics.target_mv = target_mv;
+    g_metrics.overshoot_mv = 0;
+    g_metrics.settle_ms = 0;
+    g_metrics.settled = false;
+    g_step_valid = true;
+    g_step_start_mv = g_measured_mv;
+    g_step_start_ms = now;
+    g_band_count = 0;
+}
+
+/**
+ * @brief 用新测量值更新超调量和稳定时间
+ */
+static void regulator_update_metrics(int32_t measured_mv, uint32_t now)
+{
+    int32_t target = g_metrics.target_mv;
+    int32_t beyond = (target >= g_step_start_mv) ? measured_mv - target : target - measured_mv;
+    int32_t error = measured_mv - target;
+
+    if (beyond > g_metrics.overshoot_mv) {
+        g_metrics.overshoot_mv = (int16_t)beyond;
+    }
+
+    if (error > REG_SETTLE_BAND_MV || error < -REG_SETTLE_BAND_MV) {
+        g_band_count = 0;
+        g_metrics.settled = false;
+        g_metrics.settle_ms = 0;
+        return;
+    }
+    if (g_band_count == 0) {
+        g_band_start_ms = now;
+    }
+    if (g_band_count < REG_SETTLE_SAMPLES) {
+        g_band_count++;
+        if (g_band_count == REG_SETTLE_SAMPLES) {
+            g_metrics.settled = true;
+            g_metrics.settle_ms = g_band_start_ms - g_step_start_ms;
+        }
+    }
+}
+
+/**
+ * @brief 转换完成：执行一次PI计算并更新DAC微调量
+ */
+static void regulator_measure_done(int8_t handle, uint16_t raw_value, void *context)
+{
+    (void)handle;
+    (void)context;
+
+    g_request_pending = false;
+    if (!g_enabled || DAC_isRunning()) {
+        return;
+    }
+
+    uint32_t now = get_system_time_ms();
+    uint16_t target_mv = user_ramp_get_target_mv();
+
+    g_measured_mv = user_adc_raw_to_millivolts(raw_value);
+    if (!g_step_valid || target_mv != g_metrics.target_mv) {
+        regulator_start_step(target_mv, now);
+    }
+
+    // 设定值跟随斜坡当前位置，斜坡进行中不会累积积分
+    int32_t error = (int32_t)user_ramp_get_output_mv() - (int32_t)g_measured_mv;
+    user_ramp_set_trim((int16_t)user_pi_step(&g_pi, error));
+    if (g_pi.saturated) {
+        g_saturations++;
+    }
+    regulator_update_metrics(g_measured_mv, now);
+}
+
+/**
+ * @brief 开启或关闭闭环，关闭时撤销微调、恢复开环输出
+ */
+void user_regulator_enable(bool enable)
+{
+    if (enable == g_enabled) {
+        return;
+    }
+
+    user_pi_init(&g_pi, REG_KP_Q16, REG_KI_Q16, -REG_TRIM_MAX_CODES, REG_TRIM_MAX_CODES);
+    g_saturations = 0;
+    g_step_valid = false;
+    g_enabled = enable;
+    if (!enable) {
+        user_ramp_set_trim(0);
+    }
+}
+
+/**
+ * @brief 闭环是否开启
+ */
+bool user_regulator_is_enabled(void)
+{
+    return g_enabled;
+}
+
+/**
+ * @brief 闭环处理函数，需在主循环中调用
+ * 每REG_PERIOD_MS提交一次异步转换，PI计算在完成回调中执行
+ * ADC被高速采样或功率测量占用时暂停，保持当前微调量；
+ * DAC波形引擎运行时输出不再是设定值，闭环自动关闭
+ */
+void user_regulator_process(void)
+{
+    if (!g_enabled) {
+        return;
+    }
+    if (DAC_isRunning()) {
+        user_regulator_enable(false);
+        return;
+    }
+
+    uint32_t now = get_system_time_ms();
+
+    if (now - g_last_report_ms >= REG_REPORT_INTERVAL_MS) {
+        g_last_report_ms = now;
+        user_regulator_report();
+    }
+
+    if (g_request_pending || now - g_last_submit_ms < REG_PERIOD_MS) {
+        return;
+    }
+    if (user_adc_is_sampling() || user_power_is_running()) {
+        return;
+    }
+    if (user_adc_submit(ADC_CHANNEL_0, REG_AVERAGE, regulator_measure_done, NULL) == ADC_REQUEST_INVALID) {
+        return;  // 队列满，下次重试
+    }
+    g_request_pending = true;
+    g_last_submit_ms = now;
+}
+
+/**
+ * @brief 获取当前阶跃的响应指标
+ * @return true: 闭环已开启且已有测量
+ */
+bool user_regulator_get_metrics(regulator_metrics_t *metrics)
+{
+    if (metrics == NULL || !g_enabled || !g_step_valid) {
+        return false;
+    }
+    *metrics = g_metrics;
+    return true;
+}
+
+/**
+ * @brief 发送目标、测量值、微调量和阶跃响应指标
+ */
+void user_regulator_report(void)
+{
+    firewater_send_regulator(g_metrics.target_mv, g_measured_mv, g_pi.output,
+                             g_metrics.overshoot_mv, g_metrics.settled ? g_metrics.settle_ms : 0,
+                             g_saturations);
+}
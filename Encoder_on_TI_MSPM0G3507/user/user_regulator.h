@@ -0,0 +1,43 @@
+#ifndef USER_REGULATOR_H
+#define USER_REGULATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 闭环稳压：ADC0（PA27）测量输出端电压，PI控制器微调DAC码值
+// 设定值取斜坡模块的当前输出，编码器调压时仍按压摆率过渡
+#define REG_PERIOD_MS               10         // 控制周期（每周期提交一次异步转换）
+#define REG_AVERAGE                 4          // 每次测量的平均次数
+#define REG_KP_Q16                  16384      // 比例增益：0.25码值/mV
+#define REG_KI_Q16                  16384      // 积分增益：每周期0.25码值/mV
+#define REG_TRIM_MAX_CODES          248        // 微调范围±248码值（约±200mV）
+
+// 阶跃响应指标：误差连续REG_SETTLE_SAMPLES次在±REG_SETTLE_BAND_MV内视为稳定
+#define REG_SETTLE_BAND_MV          10
+#define REG_SETTLE_SAMPLES          5
+#define REG_REPORT_INTERVAL_MS      100        // 闭环运行时的遥测间隔
+
+// 阶跃响应指标（目标变化时重新开始统计）
+typedef struct {
+    uint16_t target_mv;         // 本次阶跃的目标电压
+    int16_t overshoot_mv;       // 越过目标的最大幅度（与阶跃方向一致为正）
+    uint32_t settle_ms;         // 稳定时间，尚未稳定时为0
+    bool settled;               // 已进入稳定带
+} regulator_metrics_t;
+
+// 函数声明
+void user_regulator_enable(bool enable);
+bool user_regulator_is_enabled(void);
+void user_regulator_process(void);
+bool user_regulator_get_metrics(regulator_metrics_t *metrics);
+void user_regulator_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_REGULATOR_H */
@@ -0,0 +1,91 @@
+#include "user_replay.h"
+#include "user_scope.h"
+#include "user_ADC.h"
+#include "user_DAC.h"
+#include "user_ramp.h"
+
+static uint16_t g_replay_codes[SCOPE_BUFFER_SIZE];  // 回放用DAC码值（已校正）
+static bool g_started_output = false;               // 回放时启动了DAC输出，停止时一并停止
+
+/**
+ * @brief 布防示波器捕获（上升沿触发，触发前后样本数为默认值）
+ * 捕获完成后照常上传，数据保留在示波器缓冲区中供回放
+ * @param trigger_mv 触发电平(mV)
+ * @return true: 布防成功, false: 正在捕获或ADC被占用
+ */
+bool user_replay_arm(uint16_t trigger_mv)
+{
+    scope_config_t config = {
+        .trigger = SCOPE_TRIGGER_RISING,
+        .level = user_adc_millivolts_to_raw(trigger_mv),
+        .level_high = ADC_MAX_VALUE,
+        .hysteresis = 32,
+        .pre_samples = SCOPE_BUFFER_SIZE / 4,
+        .post_samples = SCOPE_BUFFER_SIZE - SCOPE_BUFFER_SIZE / 4,
+        .auto_rearm = false
+    };
+
+    if (!user_scope_configure(&config)) {
+        return false;
+    }
+    return user_scope_arm();
+}
+
+/**
+ * @brief 回放最近一次完整捕获
+ * 换算：原始码值 -> mV（含校准和漂移补偿）-> 以捕获均值为中心乘以增益 -> DAC码值 -> 校正
+ * @param speed_percent 回放速度，100为原速
+ * @param gain_percent 交流分量增益，100为原幅度（直流分量不变）
+ * @param loop true: 循环, false: 单次
+ * @return true: 开始回放, false: 无有效捕获或参数无效
+ */
+bool user_replay_start(uint16_t speed_percent, uint16_t gain_percent, bool loop)
+{
+    if (speed_percent == 0 || speed_percent > REPLAY_MAX_SPEED_PERCENT ||
+        gain_percent > REPLAY_MAX_GAIN_PERCENT) {
+        return false;
+    }
+
+    uint16_t count = user_scope_copy_capture(g_replay_codes, SCOPE_BUFFER_SIZE);
+    if (count < 2) {
+        return false;
+    }
+
+    // 原地换算为mV并求均值
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        g_replay_codes[i] = user_adc_raw_to_millivolts(g_replay_codes[i]);
+        sum += g_replay_codes[i];
+    }
+    int32_t mean = (int32_t)(sum / count);
+
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t mv = mean + (((int32_t)g_replay_codes[i] - mean) * gain_percent) / 100;
+        int32_t code = (mv * DAC_MAX_VALUE + 1650) / 3300;
+        if (code < 0) code = 0;
+        if (code > DAC_MAX_VALUE) code = DAC_MAX_VALUE;
+        g_replay_codes[i] = DAC_correctCode((uint16_t)code);
+    }
+
+    if (!DAC_startReplay(g_replay_codes, count, user_scope_get_sample_rate(), speed_percent, loop)) {
+        return false;
+    }
+    if (!DAC_isRunning()) {
+        g_started_output = true;
+        DAC_startSineWave();
+    }
+    return true;
+}
+
+/**
+ * @brief 停止回放，恢复原波形；回放时启动的DAC输出一并停止，并恢复斜坡的当前设定值
+ */
+void user_replay_stop(void)
+{
+    DAC_stopReplay();
+    if (g_started_output) {
+        g_started_output = false;
+        DAC_stopSineWave();
+        user_ramp_refresh();
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef USER_REPLAY_H
+#define USER_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 捕获回放：示波器触发捕获一段ADC信号，换算为DAC码值后由DAC按原速或变速回放
+#define REPLAY_MAX_GAIN_PERCENT     400        // 交流分量最大增益
+#define REPLAY_MAX_SPEED_PERCENT    1000       // 最大回放速度（10倍速）
+
+// 函数声明
+bool user_replay_arm(uint16_t trigger_mv);
+bool user_replay_start(uint16_t speed_percent, uint16_t gain_percent, bool loop);
+void user_replay_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_REPLAY_H */
@@ -0,0 +1,279 @@
+#include "user_scope.h"
+#include "user_ADC.h"
+#include "user_timestamp.h"
+#include "firewater_protocol.h"
+
+#define SCOPE_INDEX_MASK            (SCOPE_BUFFER_SIZE - 1)  // 缓冲区大小必须为2的幂
+
+// 捕获状态
+static uint16_t g_scope_ring[SCOPE_BUFFER_SIZE];   // 环形缓冲区（原始码值）
+static uint16_t g_scope_write = 0;                 // 下一个写入位置
+static uint16_t g_scope_filled = 0;                // 触发前历史已填充数量
+static uint16_t g_scope_post_remaining = 0;        // 剩余触发后样本数
+static uint16_t g_scope_trigger_pos = 0;           // 触发样本在缓冲区中的位置
+static uint32_t g_scope_sample_id = 0;             // 本次布防以来的采样ID
+static uint32_t g_scope_trigger_id = 0;            // 触发样本的采样ID
+static bool g_scope_trigger_ready = false;         // 迟滞复位标志：信号已回到复位区
+static bool g_scope_capture_valid = false;         // 缓冲区中是否有完整捕获
+static uint32_t g_scope_trigger_ticks = 0;         // 触发样本的采样时刻
+static uint32_t g_scope_last_ticks = 0;            // 最后一个样本的采样时刻
+static uint32_t g_scope_rate_hz = 0;               // 最近一次完整捕获的实测采样率
+static scope_state_t g_scope_state = SCOPE_STATE_IDLE;
+
+static scope_config_t g_scope_config = {
+    .trigger = SCOPE_TRIGGER_RISING,
+    .level = 2048,
+    .level_high = 3072,
+    .hysteresis = 32,
+    .pre_samples = 128,
+    .post_samples = 384,
+    .auto_rearm = false
+};
+
+/**
+ * @brief 更新迟滞状态并判断是否满足触发条件
+ * @param raw 当前样本
+ * @return true: 满足触发条件
+ */
+static bool scope_check_trigger(uint16_t raw)
+{
+    int32_t value = raw;
+    int32_t level = g_scope_config.level;
+    int32_t hyst = g_scope_config.hysteresis;
+
+    switch (g_scope_config.trigger) {
+        case SCOPE_TRIGGER_RISING:
+            if (value <= level - hyst) {
+                g_scope_trigger_ready = true;
+            }
+            return g_scope_trigger_ready && (value >= level);
+
+        case SCOPE_TRIGGER_FALLING:
+            if (value >= level + hyst) {
+                g_scope_trigger_ready = true;
+            }
+            return g_scope_trigger_ready && (value <= level);
+
+        case SCOPE_TRIGGER_WINDOW:
+        {
+            int32_t level_high = g_scope_config.level_high;
+            if (value >= level + hyst && value <= level_high - hyst) {
+                g_scope_trigger_ready = true;
+            }
+            return g_scope_trigger_ready && (value < level || value > level_high);
+        }
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 高速采样样本接收函数（由user_adc_high_speed_process调用）
+ */
+static void scope_sample_sink(uint16_t raw)
+{
+    if (g_scope_state == SCOPE_STATE_DONE || g_scope_state == SCOPE_STATE_IDLE) {
+        return;  // 缓冲区已冻结
+    }
+
+    // 记录触发样本和最后一个样本的时刻，捕获完成后由此求实测采样率
+    g_scope_last_ticks = user_adc_last_sample_ticks();
+
+    uint16_t pos = g_scope_write;
+    g_scope_ring[pos] = raw;
+    g_scope_write = (pos + 1) & SCOPE_INDEX_MASK;
+
+    bool fire = scope_check_trigger(raw);
+
+    switch (g_scope_state) {
+        case SCOPE_STATE_PRETRIGGER:
+            // 触发前历史填满之前不允许触发，保证捕获中有完整的触发前数据
+            if (++g_scope_filled >= g_scope_config.pre_samples) {
+                g_scope_state = SCOPE_STATE_ARMED;
+            }
+            break;
+
+        case SCOPE_STATE_ARMED:
+            if (fire) {
+                // 触发样本计为第一个触发后样本
+                g_scope_trigger_pos = pos;
+                g_scope_trigger_id = g_scope_sample_id;
+                g_scope_trigger_ticks = g_scope_last_ticks;
+                g_scope_post_remaining = g_scope_config.post_samples - 1;
+                g_scope_state = (g_scope_post_remaining == 0) ? SCOPE_STATE_DONE
+                                                              : SCOPE_STATE_TRIGGERED;
+            }
+            break;
+
+        case SCOPE_STATE_TRIGGERED:
+            if (--g_scope_post_remaining == 0) {
+                g_scope_state = SCOPE_STATE_DONE;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    g_scope_sample_id++;
+}
+
+/**
+ * @brief 一次性上传冻结的捕获数据
+ */
+static void scope_upload(void)
+{
+    static uint16_t chunk[SCOPE_UPLOAD_CHUNK];
+    uint16_t total = g_scope_config.pre_samples + g_scope_config.post_samples;
+    uint16_t index = (g_scope_trigger_pos - g_scope_config.pre_samples) & SCOPE_INDEX_MASK;
+    uint32_t sample_id = g_scope_trigger_id - g_scope_config.pre_samples;
+
+    firewater_send_scope_header(g_scope_config.pre_samples, g_scope_config.post_samples,
+                                g_scope_trigger_id);
+
+    while (total > 0) {
+        uint16_t n = (total > SCOPE_UPLOAD_CHUNK) ? SCOPE_UPLOAD_CHUNK : total;
+        for (uint16_t i = 0; i < n; i++) {
+            chunk[i] = g_scope_ring[index];
+            index = (index + 1) & SCOPE_INDEX_MASK;
+        }
+        firewater_send_adc_batch_raw(chunk, (uint8_t)n, sample_id);
+        sample_id += n;
+        total -= n;
+    }
+}
+
+/**
+ * @brief 设置触发与捕获参数（仅空闲时允许修改）
+ * @param config 捕获配置
+ * @return true: 设置成功, false: 参数无效或正在捕获
+ */
+bool user_scope_configure(const scope_config_t *config)
+{
+    if (config == NULL || g_scope_state != SCOPE_STATE_IDLE) {
+        return false;
+    }
+    if (config->post_samples == 0 ||
+        (uint32_t)config->pre_samples + config->post_samples > SCOPE_BUFFER_SIZE) {
+        return false;
+    }
+    if (config->trigger == SCOPE_TRIGGER_WINDOW && config->level_high <= config->level) {
+        return false;
+    }
+
+    g_scope_config = *config;
+    g_scope_capture_valid = false;  // 旧捕获与新参数不再对应
+    return true;
+}
+
+/**
+ * @brief 布防：开始高速采样并填充触发前历史
+ * 沿用user_adc_start_high_speed_sampling / user_adc_stop_high_speed_sampling的生命周期
+ * @return true: 布防成功, false: ADC正被其他高速采样占用
+ */
+bool user_scope_arm(void)
+{
+    if (g_scope_state != SCOPE_STATE_IDLE || user_adc_is_sampling()) {
+        return false;
+    }
+
+    g_scope_write = 0;
+    g_scope_filled = 0;
+    g_scope_sample_id = 0;
+    g_scope_trigger_ready = false;
+    g_scope_capture_valid = false;
+    g_scope_state = (g_scope_config.pre_samples == 0) ? SCOPE_STATE_ARMED
+                                                      : SCOPE_STATE_PRETRIGGER;
+
+    // 捕获期间不向串口持续发送，不受串口速率上限限制，按本地捕获的最高速率采样
+    user_adc_set_sample_sink(scope_sample_sink);
+    user_adc_start_high_speed_sampling(ADC_MAX_CAPTURE_RATE);
+    return true;
+}
+
+/**
+ * @brief 取消当前捕获
+ */
+void user_scope_abort(void)
+{
+    if (g_scope_state == SCOPE_STATE_IDLE) {
+        return;
+    }
+
+    user_adc_stop_high_speed_sampling();
+    user_adc_set_sample_sink(NULL);
+    g_scope_state = SCOPE_STATE_IDLE;
+}
+
+/**
+ * @brief 示波器处理函数，需在主循环中调用
+ * 捕获完成后停止采样、整体上传，并按配置自动重新布防
+ */
+void user_scope_process(void)
+{
+    if (g_scope_state != SCOPE_STATE_DONE) {
+        return;
+    }
+
+    user_adc_stop_high_speed_sampling();
+    user_adc_set_sample_sink(NULL);
+
+    // 实测采样率 = 样本间隔数 / 触发样本到最后一个样本的时间差（主循环阻塞错过的采样时刻也计入）
+    // 只在冻结的触发后窗口内测量：等待触发的时间不限，整个布防期间的32位计数差会回绕（约1073秒）
+    uint32_t span_ticks = g_scope_last_ticks - g_scope_trigger_ticks;
+    uint32_t intervals = g_scope_config.post_samples - 1U;
+    g_scope_rate_hz = (span_ticks > 0) ?
+        (uint32_t)(((uint64_t)intervals * TIMESTAMP_TICKS_PER_US * 1000000U + span_ticks / 2U) / span_ticks) :
+        user_adc_get_sample_rate();
+    g_scope_capture_valid = true;
+
+    scope_upload();
+
+    g_scope_state = SCOPE_STATE_IDLE;
+    if (g_scope_config.auto_rearm) {
+        user_scope_arm();
+    }
+}
+
+/**
+ * @brief 获取捕获状态
+ */
+scope_state_t user_scope_get_state(void)
+{
+    return g_scope_state;
+}
+
+/**
+ * @brief 按时间顺序复制最近一次完整捕获（从最早的触发前样本开始）
+ * @param dest 目标缓冲区
+ * @param max_count 目标缓冲区容量
+ * @return 实际复制的样本数，无有效捕获时返回0
+ */
+uint16_t user_scope_copy_capture(uint16_t *dest, uint16_t max_count)
+{
+    if (dest == NULL || !g_scope_capture_valid) {
+        return 0;
+    }
+
+    uint16_t total = g_scope_config.pre_samples + g_scope_config.post_samples;
+    uint16_t index = (g_scope_trigger_pos - g_scope_config.pre_samples) & SCOPE_INDEX_MASK;
+    if (total > max_count) {
+        total = max_count;
+    }
+
+    for (uint16_t i = 0; i < total; i++) {
+        dest[i] = g_scope_ring[index];
+        index = (index + 1) & SCOPE_INDEX_MASK;
+    }
+    return total;
+}
+
+/**
+ * @brief 获取最近一次完整捕获的实测采样率(Hz)，由首末样本的时间戳求出
+ * @return 采样率，无有效捕获时返回0
+ */
+uint32_t user_scope_get_sample_rate(void)
+{
+    return g_scope_capture_valid ? g_scope_rate_hz : 0;
+}
@@ -0,0 +1,55 @@
+#ifndef USER_SCOPE_H
+#define USER_SCOPE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 示波器捕获相关定义
+#define SCOPE_BUFFER_SIZE           512        // 环形捕获缓冲区大小（样本数）
+#define SCOPE_UPLOAD_CHUNK          64         // 上传时每批发送的样本数
+
+// 触发类型枚举
+typedef enum {
+    SCOPE_TRIGGER_RISING = 0,   // 上升沿：从(level-hysteresis)以下穿越到level及以上
+    SCOPE_TRIGGER_FALLING,      // 下降沿：从(level+hysteresis)以上穿越到level及以下
+    SCOPE_TRIGGER_WINDOW        // 窗口：离开[level, level_high]区间
+} scope_trigger_t;
+
+// 捕获状态枚举
+typedef enum {
+    SCOPE_STATE_IDLE = 0,       // 空闲
+    SCOPE_STATE_PRETRIGGER,     // 正在填充触发前历史
+    SCOPE_STATE_ARMED,          // 等待触发
+    SCOPE_STATE_TRIGGERED,      // 已触发，采集触发后样本
+    SCOPE_STATE_DONE            // 捕获完成，缓冲区冻结待上传
+} scope_state_t;
+
+// 捕获配置结构体（电平均为ADC原始码值）
+typedef struct {
+    scope_trigger_t trigger;    // 触发类型
+    uint16_t level;             // 触发电平；窗口模式下为下限
+    uint16_t level_high;        // 窗口模式上限
+    uint16_t hysteresis;        // 迟滞量，防止噪声反复触发
+    uint16_t pre_samples;       // 触发前样本数
+    uint16_t post_samples;      // 触发后样本数
+    bool auto_rearm;            // 上传完成后是否自动重新布防
+} scope_config_t;
+
+// 函数声明
+bool user_scope_configure(const scope_config_t *config);
+bool user_scope_arm(void);
+void user_scope_abort(void);
+void user_scope_process(void);
+scope_state_t user_scope_get_state(void);
+uint16_t user_scope_copy_capture(uint16_t *dest, uint16_t max_count);
+uint32_t user_scope_get_sample_rate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_SCOPE_H */
@@ -0,0 +1,492 @@
+#include "user_spectrum.h"
+#include "user_ADC.h"
+#include "firewater_protocol.h"
+#include "user_timestamp.h"
+#include <stddef.h>
+
+#define SPECTRUM_QUARTER            (SPECTRUM_FFT_SIZE / 4)
+#define SPECTRUM_ADC_MIDSCALE       2048       // 12位ADC中点
+#define SPECTRUM_INPUT_SHIFT        4          // 12位码值左移4位放大到Q15满量程
+#define SPECTRUM_LOBE_HALF          2          // Hann窗主瓣半宽（频点数）
+#define SPECTRUM_CAPTURE_RETRIES    3          // 采样出现断档时重新捕获的次数
+
+// 四分之一周期正弦表：32767*sin(2*pi*i/256)，i=0~64，同时用作FFT旋转因子
+static const int16_t g_quarter_sine_q15[SPECTRUM_QUARTER + 1] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739,
+    9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811,
+    25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521,
+    32609, 32678, 32728, 32757, 32767
+};
+
+// Hann窗前半部分（含中点）：32767*0.5*(1-cos(2*pi*n/256))，n=0~128，后半部分对称
+static const int16_t g_hann_q15[SPECTRUM_FFT_SIZE / 2 + 1] = {
+    0, 5, 20, 44, 79, 123, 177, 241, 315, 398, 491, 593,
+    705, 827, 958, 1098, 1247, 1406, 1573, 1749, 1935, 2128, 2331, 2542,
+    2761, 2989, 3224, 3468, 3719, 3978, 4244, 4518, 4799, 5086, 5381, 5682,
+    5990, 6304, 6624, 6950, 7281, 7618, 7961, 8308, 8660, 9017, 9379, 9744,
+    10114, 10487, 10864, 11244, 11628, 12014, 12403, 12794, 13187, 13583, 13980, 14378,
+    14778, 15178, 15580, 15981, 16383, 16786, 17187, 17589, 17989, 18389, 18787, 19184,
+    19580, 19973, 20364, 20753, 21139, 21523, 21903, 22280, 22653, 23023, 23388, 23750,
+    24107, 24459, 24806, 25149, 25486, 25817, 26143, 26463, 26777, 27085, 27386, 27681,
+    27968, 28249, 28523, 28789, 29048, 29299, 29543, 29778, 30006, 30225, 30436, 30639,
+    30832, 31018, 31194, 31361, 31520, 31669, 31809, 31940, 32062, 32174, 32276, 32369,
+    32452, 32526, 32590, 32644, 32688, 32723, 32747, 32762, 32767
+};
+
+// FFT工作区与分析结果
+static int16_t g_fft_re[SPECTRUM_FFT_SIZE];
+static int16_t g_fft_im[SPECTRUM_FFT_SIZE];
+static uint32_t g_spectrum_power[SPECTRUM_BINS];   // 各频点功率 |X|^2
+static uint16_t g_spectrum_mag[SPECTRUM_BINS];     // 各频点幅度 |X|
+
+// ADC捕获状态
+static uint16_t g_capture_buffer[SPECTRUM_FFT_SIZE];
+static volatile uint16_t g_capture_count = 0;
+static uint32_t g_capture_rate_hz = 0;        // 请求的采样率
+static uint32_t g_tone_target_mhz = 0;        // 0: FFT频谱分析；非0: 对该频率做Goertzel检测
+static uint32_t g_capture_first_ticks = 0;    // 第一个样本的采样时刻
+static uint32_t g_capture_last_ticks = 0;     // 最后一个样本的采样时刻
+static uint32_t g_capture_late_start = 0;     // 捕获开始时的落后计数
+static uint8_t g_capture_retries = 0;
+static bool g_capture_active = false;
+
+/**
+ * @brief 查表得到 32767*sin(2*pi*index/256)
+ */
+static int32_t spectrum_sine_at(uint32_t index)
+{
+    index &= (SPECTRUM_FFT_SIZE - 1);
+    if (index <= SPECTRUM_QUARTER) {
+        return g_quarter_sine_q15[index];
+    } else if (index <= 2 * SPECTRUM_QUARTER) {
+        return g_quarter_sine_q15[2 * SPECTRUM_QUARTER - index];
+    } else if (index <= 3 * SPECTRUM_QUARTER) {
+        return -g_quarter_sine_q15[index - 2 * SPECTRUM_QUARTER];
+    } else {
+        return -g_quarter_sine_q15[SPECTRUM_FFT_SIZE - index];
+    }
+}
+
+/**
+ * @brief 任意相位的正弦值（线性插值）
+ * @param phase 32位相位，2^32对应一个周期
+ * @return Q15正弦值
+ */
+static int32_t spectrum_sine_phase(uint32_t phase)
+{
+    uint32_t index = phase >> 24;
+    int32_t frac = (int32_t)((phase >> 8) & 0xFFFF);
+    int32_t a = spectrum_sine_at(index);
+    int32_t b = spectrum_sine_at(index + 1);
+    return a + (((b - a) * frac) >> 16);
+}
+
+/**
+ * @brief 64位整数平方根（逐位法，只用移位和加减）
+ */
+static uint32_t spectrum_isqrt(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+/**
+ * @brief 定点log2，结果为Q8（整数部分取最高位，小数部分逐位平方求得）
+ */
+static int32_t spectrum_log2_q8(uint64_t value)
+{
+    int32_t msb = 63;
+    uint32_t mantissa;
+    int32_t result;
+
+    if (value == 0) {
+        value = 1;
+    }
+    while ((value >> msb) == 0) {
+        msb--;
+    }
+
+    // 尾数归一化到[1,2)，Q30
+    mantissa = (msb >= 30) ? (uint32_t)(value >> (msb - 30))
+                           : (uint32_t)(value << (30 - msb));
+    result = msb << 8;
+    for (int32_t bit = 128; bit != 0; bit >>= 1) {
+        mantissa = (uint32_t)(((uint64_t)mantissa * mantissa) >> 30);
+        if (mantissa >= (2U << 30)) {
+            mantissa >>= 1;
+            result += bit;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 功率比换算为dB，单位0.1dB
+ * 10*log10(a/b) = (log2(a)-log2(b)) * 3.0103，以0.1dB为单位再乘10，log2为Q8再除以256
+ */
+static int16_t spectrum_power_ratio_db_x10(uint64_t numerator, uint64_t denominator)
+{
+    int32_t diff_q8 = spectrum_log2_q8(numerator) - spectrum_log2_q8(denominator);
+    int32_t db_x10 = (diff_q8 * 30103) / 256000;
+
+    if (db_x10 > INT16_MAX) db_x10 = INT16_MAX;
+    if (db_x10 < INT16_MIN) db_x10 = INT16_MIN;
+    return (int16_t)db_x10;
+}
+
+/**
+ * @brief 8位位反转
+ */
+static uint16_t spectrum_bit_reverse(uint16_t index)
+{
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < SPECTRUM_FFT_LOG2; i++) {
+        reversed = (uint16_t)((reversed << 1) | (index & 1));
+        index >>= 1;
+    }
+    return reversed;
+}
+
+/**
+ * @brief 加窗并按位反转顺序装入FFT工作区
+ */
+static void spectrum_load_windowed(const uint16_t *raw)
+{
+    for (uint16_t n = 0; n < SPECTRUM_FFT_SIZE; n++) {
+        int32_t x = ((int32_t)raw[n] - SPECTRUM_ADC_MIDSCALE) << SPECTRUM_INPUT_SHIFT;
+        int32_t w = g_hann_q15[(n <= SPECTRUM_FFT_SIZE / 2) ? n : (SPECTRUM_FFT_SIZE - n)];
+        uint16_t dest = spectrum_bit_reverse(n);
+
+        g_fft_re[dest] = (int16_t)((x * w) >> 15);
+        g_fft_im[dest] = 0;
+    }
+}
+
+/**
+ * @brief 原位基2时间抽取FFT，Q15
+ * 每级蝶形运算后右移1位防止溢出，输出 X[k] = DFT(x)[k] / N
+ * 乘法和右移均四舍五入：截断的-0.5LSB偏差逐级累积，会抬高噪底、压低SNR读数
+ */
+static void spectrum_fft(void)
+{
+    for (uint16_t len = 2; len <= SPECTRUM_FFT_SIZE; len <<= 1) {
+        uint16_t half = len >> 1;
+        uint16_t step = SPECTRUM_FFT_SIZE / len;
+
+        for (uint16_t j = 0; j < half; j++) {
+            // W = cos(2*pi*k/N) - j*sin(2*pi*k/N)
+            uint16_t k = j * step;
+            int32_t wr = spectrum_sine_at(k + SPECTRUM_QUARTER);
+            int32_t wi = -spectrum_sine_at(k);
+
+            for (uint16_t i = j; i < SPECTRUM_FFT_SIZE; i += len) {
+                uint16_t p = i + half;
+                int32_t tr = (wr * g_fft_re[p] - wi * g_fft_im[p] + 0x4000) >> 15;
+                int32_t ti = (wr * g_fft_im[p] + wi * g_fft_re[p] + 0x4000) >> 15;
+                int32_t ur = g_fft_re[i];
+                int32_t ui = g_fft_im[i];
+
+                g_fft_re[i] = (int16_t)((ur + tr + 1) >> 1);
+                g_fft_im[i] = (int16_t)((ui + ti + 1) >> 1);
+                g_fft_re[p] = (int16_t)((ur - tr + 1) >> 1);
+                g_fft_im[p] = (int16_t)((ui - ti + 1) >> 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 主瓣内各频点的功率和（center±SPECTRUM_LOBE_HALF）
+ */
+static uint64_t spectrum_band_power(uint16_t center)
+{
+    uint64_t sum = 0;
+    for (uint16_t k = center - SPECTRUM_LOBE_HALF; k <= center + SPECTRUM_LOBE_HALF; k++) {
+        sum += g_spectrum_power[k];
+    }
+    return sum;
+}
+
+/**
+ * @brief 对一块ADC原始码值做加窗FFT并测量基波频率、幅度、THD和SNR
+ * @param raw SPECTRUM_FFT_SIZE个原始码值
+ * @param sample_rate_mhz 采样率(mHz)，应为实测值，标称值误差会直接带入基波频率
+ * @param result 测量结果输出
+ * @return true: 分析成功, false: 参数无效或无有效基波
+ */
+bool user_spectrum_analyze(const uint16_t *raw, uint32_t sample_rate_mhz, spectrum_result_t *result)
+{
+    uint16_t peak = 0;
+    uint32_t peak_power = 0;
+    uint64_t total_power = 0;
+    uint64_t fundamental_power;
+    uint64_t harmonic_power = 0;
+    uint64_t noise_power;
+    int32_t delta_q16;
+    uint32_t bin_q16;
+
+    if (raw == NULL || result == NULL || sample_rate_mhz == 0) {
+        return false;
+    }
+
+    spectrum_load_windowed(raw);
+    spectrum_fft();
+
+    for (uint16_t k = 0; k < SPECTRUM_BINS; k++) {
+        int32_t re = g_fft_re[k];
+        int32_t im = g_fft_im[k];
+        uint32_t power = (uint32_t)(re * re) + (uint32_t)(im * im);
+
+        g_spectrum_power[k] = power;
+        g_spectrum_mag[k] = (uint16_t)spectrum_isqrt(power);
+        if (k >= SPECTRUM_DC_BINS) {
+            total_power += power;
+            // 基波主瓣须完整落在直流区之外和奈奎斯特频率之内
+            if (k >= SPECTRUM_DC_BINS + SPECTRUM_LOBE_HALF &&
+                k < SPECTRUM_BINS - SPECTRUM_LOBE_HALF && power > peak_power) {
+                peak_power = power;
+                peak = k;
+            }
+        }
+    }
+    if (peak == 0) {
+        return false;
+    }
+
+    // Hann窗幅度比插值：delta = (2a-1)/(a+1)，a为较大邻点与峰值幅度之比
+    {
+        int32_t m0 = g_spectrum_mag[peak];
+        int32_t left = g_spectrum_mag[peak - 1];
+        int32_t right = g_spectrum_mag[peak + 1];
+        int32_t side = (right >= left) ? right : left;
+
+        delta_q16 = ((2 * side - m0) * 65536) / (side + m0);
+        if (delta_q16 < 0) delta_q16 = 0;
+        if (delta_q16 > 32768) delta_q16 = 32768;
+        if (right < left) delta_q16 = -delta_q16;
+    }
+    bin_q16 = ((uint32_t)peak << 16) + delta_q16;
+
+    // 基波与2~5次谐波各取整个主瓣的功率
+    fundamental_power = spectrum_band_power(peak);
+    for (uint32_t h = 2; h <= SPECTRUM_MAX_HARMONIC; h++) {
+        uint32_t center = (h * bin_q16 + 0x8000) >> 16;
+        if (center + SPECTRUM_LOBE_HALF >= SPECTRUM_BINS) {
+            break;
+        }
+        harmonic_power += spectrum_band_power((uint16_t)center);
+    }
+    noise_power = total_power - fundamental_power - harmonic_power;
+
+    result->fundamental_bin = peak;
+    result->frequency_mhz = (uint32_t)(((uint64_t)bin_q16 * sample_rate_mhz) >>
+                                       (16 + SPECTRUM_FFT_LOG2));
+
+    // 正频率半边谱功率 = (16A)^2 * 3/32（Hann窗能量0.375，FFT输出已除以N）
+    {
+        uint32_t amplitude_scaled = spectrum_isqrt(fundamental_power * 32U / 3U);
+        uint32_t amplitude_code = amplitude_scaled >> SPECTRUM_INPUT_SHIFT;
+        if (amplitude_code > 0xFFFFU) amplitude_code = 0xFFFFU;
+        result->amplitude_mv = user_adc_span_to_millivolts((uint16_t)amplitude_code);
+    }
+
+    result->thd_db_x10 = spectrum_power_ratio_db_x10(harmonic_power, fundamental_power);
+    result->snr_db_x10 = spectrum_power_ratio_db_x10(fundamental_power, noise_power);
+    return true;
+}
+
+/**
+ * @brief 获取最近一次分析的各频点幅度（SPECTRUM_BINS个）
+ */
+const uint16_t *user_spectrum_get_magnitudes(void)
+{
+    return g_spectrum_mag;
+}
+
+/**
+ * @brief 初始化Goertzel单频检测器
+ * @param g 检测器
+ * @param target_mhz 目标频率(mHz)
+ * @param sample_rate_mhz 采样率(mHz)，应为实测值
+ */
+void user_spectrum_goertzel_init(goertzel_t *g, uint32_t target_mhz, uint32_t sample_rate_mhz)
+{
+    uint32_t phase;
+
+    if (g == NULL || sample_rate_mhz == 0) {
+        return;
+    }
+
+    // 每样本相位增量，2^32对应一个周期
+    phase = (uint32_t)(((uint64_t)target_mhz << 32) / sample_rate_mhz);
+    g->sin_q15 = spectrum_sine_phase(phase);
+    g->cos_q15 = spectrum_sine_phase(phase + 0x40000000U);
+    g->coeff_q14 = g->cos_q15;  // 2cos(w)的Q14与cos(w)的Q15数值相同
+}
+
+/**
+ * @brief 对一块ADC原始码值运行Goertzel检测
+ * @param g 检测器
+ * @param raw 原始码值
+ * @param count 样本数
+ * @return 目标频率分量的峰值幅度(ADC码值)
+ */
+uint16_t user_spectrum_goertzel_run(const goertzel_t *g, const uint16_t *raw, uint16_t count)
+{
+    int32_t s1 = 0;
+    int32_t s2 = 0;
+    int64_t re;
+    int64_t im;
+    uint32_t magnitude;
+
+    if (g == NULL || raw == NULL || count == 0) {
+        return 0;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t s0 = ((int32_t)raw[i] - SPECTRUM_ADC_MIDSCALE) +
+                     (int32_t)(((int64_t)g->coeff_q14 * s1) >> 14) - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    // 由最后两个状态求复数输出：X = s1 - s2*e^(-jw)
+    re = s1 - (((int64_t)s2 * g->cos_q15) >> 15);
+    im = ((int64_t)s2 * g->sin_q15) >> 15;
+    magnitude = spectrum_isqrt((uint64_t)(re * re + im * im));
+
+    magnitude = (2U * magnitude) / count;
+    return (magnitude > 0xFFFFU) ? 0xFFFFU : (uint16_t)magnitude;
+}
+
+/**
+ * @brief 高速采样样本接收函数，采满一帧后停止写入
+ */
+static void spectrum_sample_sink(uint16_t raw_value)
+{
+    if (g_capture_count < SPECTRUM_FFT_SIZE) {
+        g_capture_last_ticks = user_adc_last_sample_ticks();
+        if (g_capture_count == 0) {
+            g_capture_first_ticks = g_capture_last_ticks;
+        }
+        g_capture_buffer[g_capture_count++] = raw_value;
+    }
+}
+
+/**
+ * @brief 从头开始采集一帧
+ */
+static void spectrum_arm(void)
+{
+    g_capture_count = 0;
+    user_adc_set_sample_sink(spectrum_sample_sink);
+    user_adc_start_high_speed_sampling(g_capture_rate_hz);
+    g_capture_late_start = user_adc_get_late_samples();
+}
+
+/**
+ * @brief 启动一帧捕获
+ * @param target_mhz 0: FFT频谱分析；非0: Goertzel检测的目标频率(mHz)
+ */
+static bool spectrum_start(uint32_t target_mhz, uint32_t sample_rate_hz)
+{
+    if (g_capture_active || user_adc_is_sampling() || sample_rate_hz == 0) {
+        return false;
+    }
+
+    g_capture_rate_hz = sample_rate_hz;
+    g_tone_target_mhz = target_mhz;
+    g_capture_retries = 0;
+    g_capture_active = true;
+    spectrum_arm();
+    return true;
+}
+
+/**
+ * @brief 启动一帧频谱捕获，采满后由user_spectrum_process分析并上传
+ * @param sample_rate_hz 采样率
+ * @return true: 启动成功, false: ADC正被其他高速采样占用
+ */
+bool user_spectrum_start_capture(uint32_t sample_rate_hz)
+{
+    return spectrum_start(0, sample_rate_hz);
+}
+
+/**
+ * @brief 启动一帧捕获，采满后用Goertzel检测单个频率的幅度并上传
+ * 只算一个频点，比整帧FFT省得多；矩形窗，目标频率不在频点上时有扇贝损失
+ * @param target_mhz 目标频率(mHz)，须低于采样率的一半
+ * @param sample_rate_hz 采样率
+ * @return true: 启动成功, false: 参数无效或ADC正被其他高速采样占用
+ */
+bool user_spectrum_start_tone(uint32_t target_mhz, uint32_t sample_rate_hz)
+{
+    if (target_mhz == 0 || (uint64_t)target_mhz * 2U >= (uint64_t)sample_rate_hz * 1000U) {
+        return false;
+    }
+    return spectrum_start(target_mhz, sample_rate_hz);
+}
+
+/**
+ * @brief 频谱处理函数，需在主循环中调用
+ * 一帧采满后停止采样，按首末样本时间戳求实测采样率，发送频谱帧和测量结果帧（或单频检测结果帧）
+ * 采样中途落后被重新对齐时样本间隔不均匀，丢弃该帧重新捕获
+ */
+void user_spectrum_process(void)
+{
+    spectrum_result_t result;
+    goertzel_t goertzel;
+    uint32_t span_ticks;
+    uint32_t rate_mhz;
+
+    if (!g_capture_active || g_capture_count < SPECTRUM_FFT_SIZE) {
+        return;
+    }
+
+    user_adc_stop_high_speed_sampling();
+    user_adc_set_sample_sink(NULL);
+
+    if (user_adc_get_late_samples() != g_capture_late_start &&
+        g_capture_retries < SPECTRUM_CAPTURE_RETRIES) {
+        g_capture_retries++;
+        spectrum_arm();
+        return;
+    }
+    g_capture_active = false;
+
+    span_ticks = g_capture_last_ticks - g_capture_first_ticks;
+    rate_mhz = (span_ticks > 0) ?
+        (uint32_t)(((uint64_t)(SPECTRUM_FFT_SIZE - 1) * TIMESTAMP_TICKS_PER_US * 1000000000ULL +
+                    span_ticks / 2U) / span_ticks) :
+        g_capture_rate_hz * 1000U;
+
+    if (g_tone_target_mhz != 0) {
+        user_spectrum_goertzel_init(&goertzel, g_tone_target_mhz, rate_mhz);
+        uint16_t amplitude = user_spectrum_goertzel_run(&goertzel, g_capture_buffer, SPECTRUM_FFT_SIZE);
+        firewater_send_spectrum_tone(g_tone_target_mhz, user_adc_span_to_millivolts(amplitude),
+                                     (rate_mhz + 500U) / 1000U);
+        return;
+    }
+
+    if (user_spectrum_analyze(g_capture_buffer, rate_mhz, &result)) {
+        firewater_send_spectrum(g_spectrum_mag, SPECTRUM_BINS, (rate_mhz + 500U) / 1000U);
+        firewater_send_spectrum_metrics(result.frequency_mhz, result.amplitude_mv,
+                                        result.thd_db_x10, result.snr_db_x10);
+    }
+}
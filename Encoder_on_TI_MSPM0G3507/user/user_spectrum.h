@@ -0,0 +1,51 @@
+#ifndef USER_SPECTRUM_H
+#define USER_SPECTRUM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 频谱分析相关定义
+#define SPECTRUM_FFT_LOG2           8
+#define SPECTRUM_FFT_SIZE           (1 << SPECTRUM_FFT_LOG2)   // 256点FFT
+#define SPECTRUM_BINS               (SPECTRUM_FFT_SIZE / 2)    // 有效频点数
+#define SPECTRUM_DC_BINS            3          // Hann窗下直流泄漏占用的频点数（0~2）
+#define SPECTRUM_MAX_HARMONIC       5          // THD计算的最高谐波次数
+
+// 频谱分析结果（定点表示）
+typedef struct {
+    uint32_t frequency_mhz;     // 基波频率(mHz)
+    uint16_t amplitude_mv;      // 基波幅度（峰值，mV）
+    uint16_t fundamental_bin;   // 基波所在频点
+    int16_t thd_db_x10;         // 总谐波失真(0.1dB)，负值
+    int16_t snr_db_x10;         // 信噪比(0.1dB)
+} spectrum_result_t;
+
+// Goertzel单频检测器
+typedef struct {
+    int32_t coeff_q14;          // 2cos(w)，Q14
+    int32_t cos_q15;            // cos(w)，Q15
+    int32_t sin_q15;            // sin(w)，Q15
+} goertzel_t;
+
+// FFT频谱分析
+bool user_spectrum_analyze(const uint16_t *raw, uint32_t sample_rate_mhz, spectrum_result_t *result);
+const uint16_t *user_spectrum_get_magnitudes(void);
+
+// Goertzel单频检测
+void user_spectrum_goertzel_init(goertzel_t *g, uint32_t target_mhz, uint32_t sample_rate_mhz);
+uint16_t user_spectrum_goertzel_run(const goertzel_t *g, const uint16_t *raw, uint16_t count);
+
+// ADC高速采样捕获一块数据后自动分析并发送频谱帧（或单频检测结果帧）
+bool user_spectrum_start_capture(uint32_t sample_rate_hz);
+bool user_spectrum_start_tone(uint32_t target_mhz, uint32_t sample_rate_hz);
+void user_spectrum_process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_SPECTRUM_H */
@@ -0,0 +1,203 @@
+#include "user_stats.h"
+#include "user_ADC.h"
+#include "firewater_protocol.h"
+#include <stddef.h>
+
+// ADC高速采样流的累加器
+static stats_accumulator_t g_adc_stats;
+static bool g_adc_stats_active = false;
+
+/**
+ * @brief 64位整数平方根（逐位法，只用移位和加减）
+ * @note 仅在窗口结束时调用一次，不在每样本路径上
+ */
+static uint32_t stats_isqrt64(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+/**
+ * @brief 初始化累加器
+ * @param acc 累加器
+ * @param name 通道名称
+ * @param window 窗口长度（样本数），0时使用默认值
+ */
+void user_stats_init(stats_accumulator_t *acc, const char *name, uint32_t window)
+{
+    if (acc == NULL) {
+        return;
+    }
+
+    acc->name = name;
+    acc->window = (window == 0) ? STATS_DEFAULT_WINDOW : window;
+    user_stats_reset(acc);
+}
+
+/**
+ * @brief 清空当前窗口
+ */
+void user_stats_reset(stats_accumulator_t *acc)
+{
+    if (acc == NULL) {
+        return;
+    }
+
+    acc->count = 0;
+    acc->sum = 0;
+    acc->sum_sq = 0;
+    acc->min = INT32_MAX;
+    acc->max = INT32_MIN;
+}
+
+/**
+ * @brief 累加一个样本
+ * @param acc 累加器
+ * @param sample 样本值
+ * @param record 窗口结束时输出统计结果
+ * @return true: 本样本结束了一个窗口，record有效
+ */
+bool user_stats_add_sample(stats_accumulator_t *acc, int32_t sample, stats_record_t *record)
+{
+    uint32_t magnitude = (sample < 0) ? (uint32_t)(-(int64_t)sample) : (uint32_t)sample;
+
+    acc->sum += sample;
+    // 12位ADC码值等小幅值样本走32位乘法，避免M0+上的64位乘法库调用
+    if (magnitude <= 0xFFFFU) {
+        acc->sum_sq += magnitude * magnitude;
+    } else {
+        acc->sum_sq += (uint64_t)magnitude * magnitude;
+    }
+    if (sample < acc->min) acc->min = sample;
+    if (sample > acc->max) acc->max = sample;
+
+    if (++acc->count < acc->window) {
+        return false;
+    }
+    return user_stats_finish_window(acc, record);
+}
+
+/**
+ * @brief 提前结束当前窗口（如停止采样时输出不足一个窗口的数据）
+ * @return true: 窗口内有样本，record有效
+ */
+bool user_stats_finish_window(stats_accumulator_t *acc, stats_record_t *record)
+{
+    if (acc == NULL || record == NULL || acc->count == 0) {
+        return false;
+    }
+
+    record->count = acc->count;
+    record->mean = (int32_t)(acc->sum / (int64_t)acc->count);
+    record->rms = (int32_t)stats_isqrt64(acc->sum_sq / acc->count);
+
+    // 方差按整数均值m展开：Σ(x-m)^2 = sum_sq - m(sum + d)，d = sum - m·n为均值截断的余数(|d|<n)，
+    // 再减去d^2/n换算到真实均值；避免rms^2 - mean^2中两个大数相减放大截断误差
+    int64_t m = record->mean;
+    int64_t d = acc->sum - m * (int64_t)acc->count;
+    int64_t dev_sq = (int64_t)acc->sum_sq - m * (acc->sum + d) - (d * d) / (int64_t)acc->count;
+    record->std_dev = (int32_t)stats_isqrt64((dev_sq > 0) ? (uint64_t)dev_sq / acc->count : 0U);
+    record->min = acc->min;
+    record->max = acc->max;
+    record->peak_to_peak = acc->max - acc->min;
+
+    user_stats_reset(acc);
+    return true;
+}
+
+/**
+ * @brief 以紧凑文本帧发送统计结果
+ */
+void user_stats_send_record(const char *name, const stats_record_t *record)
+{
+    if (record == NULL) {
+        return;
+    }
+    firewater_send_stats(name, record->mean, record->rms, record->min,
+                         record->max, record->peak_to_peak);
+}
+
+/**
+ * @brief ADC窗口统计结果换算为毫伏后发送
+ * mean/min/max是电压点，按增益+校准偏移换算；标准差是幅度量，只按增益缩放。
+ * 帧中的rms是含直流分量的电压均方根：码值x换算为v = g·x + o后，
+ * rms(v) = sqrt((g·mean + o)^2 + g^2·var)，不能直接对码值rms做换算
+ */
+static void stats_send_adc_record(const stats_record_t *record)
+{
+    stats_record_t mv;
+
+    mv.count = record->count;
+    mv.mean = user_adc_raw_to_millivolts((uint16_t)record->mean);
+    mv.std_dev = user_adc_span_to_millivolts((uint16_t)record->std_dev);
+    mv.rms = (int32_t)stats_isqrt64((uint64_t)((int64_t)mv.mean * mv.mean) +
+                                    (uint64_t)((int64_t)mv.std_dev * mv.std_dev));
+    mv.min = user_adc_raw_to_millivolts((uint16_t)record->min);
+    mv.max = user_adc_raw_to_millivolts((uint16_t)record->max);
+    mv.peak_to_peak = mv.max - mv.min;
+    user_stats_send_record(g_adc_stats.name, &mv);
+}
+
+/**
+ * @brief ADC高速采样样本接收函数
+ */
+static void stats_adc_sample_sink(uint16_t raw_value)
+{
+    stats_record_t record;
+
+    if (user_stats_add_sample(&g_adc_stats, raw_value, &record)) {
+        stats_send_adc_record(&record);
+    }
+}
+
+/**
+ * @brief 启动ADC流统计：只上报每个窗口的统计帧，不再发送原始样本
+ * @param window 窗口长度（样本数）
+ * @return true: 启动成功, false: ADC正被其他高速采样占用
+ */
+bool user_stats_start_adc(uint32_t window)
+{
+    if (user_adc_is_sampling()) {
+        return false;
+    }
+
+    user_stats_init(&g_adc_stats, "adc", window);
+    g_adc_stats_active = true;
+    user_adc_set_sample_sink(stats_adc_sample_sink);
+    user_adc_start_high_speed_sampling(ADC_MAX_SAMPLE_RATE);
+    return true;
+}
+
+/**
+ * @brief 停止ADC流统计，输出最后一个不完整窗口
+ */
+void user_stats_stop_adc(void)
+{
+    stats_record_t record;
+
+    if (!g_adc_stats_active) {
+        return;
+    }
+    g_adc_stats_active = false;
+
+    user_adc_stop_high_speed_sampling();
+    user_adc_set_sample_sink(NULL);
+
+    if (user_stats_finish_window(&g_adc_stats, &record)) {
+        stats_send_adc_record(&record);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef USER_STATS_H
+#define USER_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 统计窗口相关定义
+#define STATS_DEFAULT_WINDOW        1000       // 默认窗口长度（样本数）
+
+// 窗口统计结果（单位与输入样本一致）
+typedef struct {
+    int32_t mean;               // 平均值
+    int32_t rms;                // 均方根（含直流分量）
+    int32_t std_dev;            // 标准差（交流分量的均方根）
+    int32_t min;                // 最小值
+    int32_t max;                // 最大值
+    int32_t peak_to_peak;       // 峰峰值
+    uint32_t count;             // 窗口内样本数
+} stats_record_t;
+
+// 增量统计累加器：每个样本O(1)，仅用整数运算
+typedef struct {
+    const char *name;           // 通道名称（用于遥测帧前缀）
+    uint32_t window;            // 窗口长度（样本数）
+    uint32_t count;             // 当前窗口已累计样本数
+    int64_t sum;                // 样本和
+    uint64_t sum_sq;            // 样本平方和
+    int32_t min;                // 当前窗口最小值
+    int32_t max;                // 当前窗口最大值
+} stats_accumulator_t;
+
+// 通用累加器接口（ADC码值、INA226读数、电流通道均可使用）
+void user_stats_init(stats_accumulator_t *acc, const char *name, uint32_t window);
+void user_stats_reset(stats_accumulator_t *acc);
+bool user_stats_add_sample(stats_accumulator_t *acc, int32_t sample, stats_record_t *record);
+bool user_stats_finish_window(stats_accumulator_t *acc, stats_record_t *record);
+void user_stats_send_record(const char *name, const stats_record_t *record);
+
+// ADC高速采样流统计（每个窗口输出一条统计帧，单位mV）
+bool user_stats_start_adc(uint32_t window);
+void user_stats_stop_adc(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_STATS_H */
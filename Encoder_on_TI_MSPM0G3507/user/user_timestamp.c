@@ -0,0 +1,183 @@
+#include "user_timestamp.h"
+#include "firewater_protocol.h"
+#include "ti_msp_dl_config.h"
+#include <stddef.h>
+
+// 定时器时钟：BUSCLK 32MHz / 8 = 4MHz
+static const DL_TimerG_ClockConfig g_timestamp_clock_config = {
+    .clockSel    = DL_TIMER_CLOCK_BUSCLK,
+    .divideRatio = DL_TIMER_CLOCK_DIVIDE_8,
+    .prescale    = 0U
+};
+
+// 周期模式满量程向下计数，读数取反即为向上计数的时间戳
+static const DL_TimerG_TimerConfig g_timestamp_timer_config = {
+    .period     = 0xFFFFFFFFU,
+    .timerMode  = DL_TIMER_TIMER_MODE_PERIODIC,
+    .startTimer = DL_TIMER_START,
+};
+
+// 已登记的直方图（供串口命令统一报告）
+static jitter_histogram_t *g_histograms[JITTER_MAX_HISTOGRAMS];
+static uint8_t g_histogram_count = 0;
+
+/**
+ * @brief 初始化时间戳定时器（SysConfig未使用TIMG12，在此运行时配置）
+ */
+void user_timestamp_init(void)
+{
+    DL_TimerG_reset(TIMESTAMP_TIMER_INST);
+    DL_TimerG_enablePower(TIMESTAMP_TIMER_INST);
+    delay_cycles(16);  // 外设上电等待
+
+    DL_TimerG_setClockConfig(TIMESTAMP_TIMER_INST, (DL_TimerG_ClockConfig *)&g_timestamp_clock_config);
+    DL_TimerG_initTimerMode(TIMESTAMP_TIMER_INST, (DL_TimerG_TimerConfig *)&g_timestamp_timer_config);
+    DL_TimerG_enableClock(TIMESTAMP_TIMER_INST);
+}
+
+/**
+ * @brief 读取自由运行计数（4MHz，32位回绕）
+ */
+uint32_t user_timestamp_ticks(void)
+{
+    return ~DL_TimerG_getTimerCount(TIMESTAMP_TIMER_INST);
+}
+
+/**
+ * @brief 读取微秒时间戳（30位回绕）
+ */
+uint32_t user_timestamp_us(void)
+{
+    return user_timestamp_ticks() / TIMESTAMP_TICKS_PER_US;
+}
+
+/**
+ * @brief 计算两个计数值之间的微秒数（正确处理回绕）
+ */
+uint32_t user_timestamp_elapsed_us(uint32_t start_ticks, uint32_t end_ticks)
+{
+    return (end_ticks - start_ticks) / TIMESTAMP_TICKS_PER_US;
+}
+
+/**
+ * @brief 初始化采样间隔直方图
+ * @param hist 直方图
+ * @param name 名称
+ * @param nominal_us 标称采样间隔(us)
+ * @param bin_width_us 每格宽度(us)，直方图覆盖 nominal ± JITTER_BINS/2 格
+ */
+void user_jitter_init(jitter_histogram_t *hist, const char *name,
+                      uint32_t nominal_us, uint32_t bin_width_us)
+{
+    if (hist == NULL) {
+        return;
+    }
+
+    hist->name = name;
+    hist->nominal_us = nominal_us;
+    hist->bin_width_us = (bin_width_us == 0) ? 1 : bin_width_us;
+    user_jitter_reset(hist);
+}
+
+/**
+ * @brief 清空统计，下一次记录重新作为起点
+ */
+void user_jitter_reset(jitter_histogram_t *hist)
+{
+    if (hist == NULL) {
+        return;
+    }
+
+    hist->has_last = false;
+    hist->count = 0;
+    hist->min_us = UINT32_MAX;
+    hist->max_us = 0;
+    hist->underflow = 0;
+    hist->overflow = 0;
+    for (uint8_t i = 0; i < JITTER_BINS; i++) {
+        hist->bins[i] = 0;
+    }
+}
+
+/**
+ * @brief 记录一个采样时刻，统计与上一次之间的间隔
+ * @param hist 直方图
+ * @param now_ticks 当前计数值（user_timestamp_ticks）
+ */
+void user_jitter_record(jitter_histogram_t *hist, uint32_t now_ticks)
+{
+    if (!hist->has_last) {
+        hist->last_ticks = now_ticks;
+        hist->has_last = true;
+        return;
+    }
+
+    uint32_t interval = user_timestamp_elapsed_us(hist->last_ticks, now_ticks);
+    uint32_t low = hist->nominal_us - (JITTER_BINS / 2) * hist->bin_width_us;
+    hist->last_ticks = now_ticks;
+    hist->count++;
+
+    if (interval < hist->min_us) hist->min_us = interval;
+    if (interval > hist->max_us) hist->max_us = interval;
+
+    // 标称值小于半个直方图宽度时下界按0处理
+    if (hist->nominal_us < (JITTER_BINS / 2) * hist->bin_width_us) {
+        low = 0;
+    }
+    if (interval < low) {
+        hist->underflow++;
+        return;
+    }
+
+    uint32_t bin = (interval - low) / hist->bin_width_us;
+    if (bin >= JITTER_BINS) {
+        hist->overflow++;
+    } else {
+        hist->bins[bin]++;
+    }
+}
+
+/**
+ * @brief 发送直方图报告帧
+ */
+void user_jitter_report(const jitter_histogram_t *hist)
+{
+    if (hist == NULL) {
+        return;
+    }
+    firewater_send_jitter(hist->name, hist->nominal_us, hist->bin_width_us, hist->count,
+                          (hist->count != 0) ? hist->min_us : 0, hist->max_us,
+                          hist->underflow, hist->bins, JITTER_BINS, hist->overflow);
+}
+
+/**
+ * @brief 登记直方图，供user_jitter_report_all统一报告
+ * @return true: 登记成功（重复登记视为成功）
+ */
+bool user_jitter_register(jitter_histogram_t *hist)
+{
+    for (uint8_t i = 0; i < g_histogram_count; i++) {
+        if (g_histograms[i] == hist) {
+            return true;
+        }
+    }
+    if (hist == NULL || g_histogram_count >= JITTER_MAX_HISTOGRAMS) {
+        return false;
+    }
+    g_histograms[g_histogram_count++] = hist;
+    return true;
+}
+
+/**
+ * @brief 报告所有已登记的直方图（串口命令"jitter"调用）
+ * @param reset 报告后是否清空，便于对比调度修改前后的抖动
+ */
+void user_jitter_report_all(bool reset)
+{
+    for (uint8_t i = 0; i < g_histogram_count; i++) {
+        user_jitter_report(g_histograms[i]);
+        if (reset) {
+            user_jitter_reset(g_histograms[i]);
+        }
+    }
+}
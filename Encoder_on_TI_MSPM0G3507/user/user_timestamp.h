@@ -0,0 +1,54 @@
+#ifndef USER_TIMESTAMP_H
+#define USER_TIMESTAMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 时间戳定时器：TIMG12（32位，无预分频）使用BUSCLK/8 = 4MHz自由运行
+#define TIMESTAMP_TIMER_INST        TIMG12
+#define TIMESTAMP_TICKS_PER_US      4          // 每微秒计数值（0.25us分辨率）
+#define TIMESTAMP_US_MASK           0x3FFFFFFFU  // 微秒时间戳为30位，约1073秒回绕
+
+// 采样间隔直方图相关定义
+#define JITTER_BINS                 16         // 直方图格数（以标称间隔为中心）
+#define JITTER_MAX_HISTOGRAMS       4          // 可同时登记的直方图数量
+
+// 采样间隔直方图
+typedef struct {
+    const char *name;           // 名称（用于报告帧前缀）
+    uint32_t nominal_us;        // 标称采样间隔
+    uint32_t bin_width_us;      // 每格宽度
+    uint32_t last_ticks;        // 上一次记录的定时器计数
+    bool has_last;              // last_ticks是否有效
+    uint32_t count;             // 已记录的间隔数
+    uint32_t min_us;            // 最小间隔
+    uint32_t max_us;            // 最大间隔
+    uint32_t underflow;         // 小于直方图下界的间隔数
+    uint32_t overflow;          // 大于直方图上界的间隔数
+    uint32_t bins[JITTER_BINS]; // 间隔分布
+} jitter_histogram_t;
+
+// 时间戳函数
+void user_timestamp_init(void);
+uint32_t user_timestamp_ticks(void);
+uint32_t user_timestamp_us(void);
+uint32_t user_timestamp_elapsed_us(uint32_t start_ticks, uint32_t end_ticks);
+
+// 采样间隔直方图函数
+void user_jitter_init(jitter_histogram_t *hist, const char *name,
+                      uint32_t nominal_us, uint32_t bin_width_us);
+void user_jitter_reset(jitter_histogram_t *hist);
+void user_jitter_record(jitter_histogram_t *hist, uint32_t now_ticks);
+void user_jitter_report(const jitter_histogram_t *hist);
+bool user_jitter_register(jitter_histogram_t *hist);
+void user_jitter_report_all(bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_TIMESTAMP_H */
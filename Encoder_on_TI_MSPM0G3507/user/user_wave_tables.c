@@ -0,0 +1,161 @@
+// 由tools/gen_wave_tables.py生成，请勿手工修改
+// 内置波形表（Q15，一个周期256点，正弦只存四分之一周期），const存放于Flash
+
+#include "user_wave_tables.h"
+
+// 正弦（四分之一周期）
+const int16_t g_wave_quarter_sine_q15[WAVE_QUARTER_SIZE + 1] = {
+         0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+      6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+     12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+     18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+     23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+     27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+     30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+     32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+     32767,
+};
+
+// 方波
+const int16_t g_wave_square_q15[WAVE_TABLE_SIZE] = {
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+};
+
+// 三角波
+const int16_t g_wave_triangle_q15[WAVE_TABLE_SIZE] = {
+         0,    512,   1024,   1536,   2048,   2560,   3072,   3584,
+      4096,   4608,   5120,   5632,   6144,   6656,   7168,   7680,
+      8192,   8704,   9216,   9728,  10240,  10752,  11264,  11776,
+     12288,  12800,  13312,  13824,  14336,  14848,  15360,  15872,
+     16384,  16896,  17408,  17920,  18432,  18944,  19456,  19968,
+     20480,  20992,  21504,  22016,  22528,  23040,  23552,  24064,
+     24576,  25088,  25600,  26112,  26624,  27136,  27648,  28160,
+     28672,  29184,  29696,  30208,  30720,  31232,  31744,  32256,
+     32767,  32256,  31744,  31232,  30720,  30208,  29696,  29184,
+     28672,  28160,  27648,  27136,  26624,  26112,  25600,  25088,
+     24576,  24064,  23552,  23040,  22528,  22016,  21504,  20992,
+     20480,  19968,  19456,  18944,  18432,  17920,  17408,  16896,
+     16384,  15872,  15360,  14848,  14336,  13824,  13312,  12800,
+     12288,  11776,  11264,  10752,  10240,   9728,   9216,   8704,
+      8192,   7680,   7168,   6656,   6144,   5632,   5120,   4608,
+      4096,   3584,   3072,   2560,   2048,   1536,   1024,    512,
+         0,   -512,  -1024,  -1536,  -2048,  -2560,  -3072,  -3584,
+     -4096,  -4608,  -5120,  -5632,  -6144,  -6656,  -7168,  -7680,
+     -8192,  -8704,  -9216,  -9728, -10240, -10752, -11264, -11776,
+    -12288, -12800, -13312, -13824, -14336, -14848, -15360, -15872,
+    -16384, -16896, -17408, -17920, -18432, -18944, -19456, -19968,
+    -20480, -20992, -21504, -22016, -22528, -23040, -23552, -24064,
+    -24576, -25088, -25600, -26112, -26624, -27136, -27648, -28160,
+    -28672, -29184, -29696, -30208, -30720, -31232, -31744, -32256,
+    -32768, -32256, -31744, -31232, -30720, -30208, -29696, -29184,
+    -28672, -28160, -27648, -27136, -26624, -26112, -25600, -25088,
+    -24576, -24064, -23552, -23040, -22528, -22016, -21504, -20992,
+    -20480, -19968, -19456, -18944, -18432, -17920, -17408, -16896,
+    -16384, -15872, -15360, -14848, -14336, -13824, -13312, -12800,
+    -12288, -11776, -11264, -10752, -10240,  -9728,  -9216,  -8704,
+     -8192,  -7680,  -7168,  -6656,  -6144,  -5632,  -5120,  -4608,
+     -4096,  -3584,  -3072,  -2560,  -2048,  -1536,  -1024,   -512,
+};
+
+// 锯齿波
+const int16_t g_wave_sawtooth_q15[WAVE_TABLE_SIZE] = {
+    -32768, -32512, -32256, -32000, -31744, -31488, -31232, -30976,
+    -30720, -30464, -30208, -29952, -29696, -29440, -29184, -28928,
+    -28672, -28416, -28160, -27904, -27648, -27392, -27136, -26880,
+    -26624, -26368, -26112, -25856, -25600, -25344, -25088, -24832,
+    -24576, -24320, -24064, -23808, -23552, -23296, -23040, -22784,
+    -22528, -22272, -22016, -21760, -21504, -21248, -20992, -20736,
+    -20480, -20224, -19968, -19712, -19456, -19200, -18944, -18688,
+    -18432, -18176, -17920, -17664, -17408, -17152, -16896, -16640,
+    -16384, -16128, -15872, -15616, -15360, -15104, -14848, -14592,
+    -14336, -14080, -13824, -13568, -13312, -13056, -12800, -12544,
+    -12288, -12032, -11776, -11520, -11264, -11008, -10752, -10496,
+    -10240,  -9984,  -9728,  -9472,  -9216,  -8960,  -8704,  -8448,
+     -8192,  -7936,  -7680,  -7424,  -7168,  -6912,  -6656,  -6400,
+     -6144,  -5888,  -5632,  -5376,  -5120,  -4864,  -4608,  -4352,
+     -4096,  -3840,  -3584,  -3328,  -3072,  -2816,  -2560,  -2304,
+     -2048,  -1792,  -1536,  -1280,  -1024,   -768,   -512,   -256,
+         0,    256,    512,    768,   1024,   1280,   1536,   1792,
+      2048,   2304,   2560,   2816,   3072,   3328,   3584,   3840,
+      4096,   4352,   4608,   4864,   5120,   5376,   5632,   5888,
+      6144,   6400,   6656,   6912,   7168,   7424,   7680,   7936,
+      8192,   8448,   8704,   8960,   9216,   9472,   9728,   9984,
+     10240,  10496,  10752,  11008,  11264,  11520,  11776,  12032,
+     12288,  12544,  12800,  13056,  13312,  13568,  13824,  14080,
+     14336,  14592,  14848,  15104,  15360,  15616,  15872,  16128,
+     16384,  16640,  16896,  17152,  17408,  17664,  17920,  18176,
+     18432,  18688,  18944,  19200,  19456,  19712,  19968,  20224,
+     20480,  20736,  20992,  21248,  21504,  21760,  22016,  22272,
+     22528,  22784,  23040,  23296,  23552,  23808,  24064,  24320,
+     24576,  24832,  25088,  25344,  25600,  25856,  26112,  26368,
+     26624,  26880,  27136,  27392,  27648,  27904,  28160,  28416,
+     28672,  28928,  29184,  29440,  29696,  29952,  30208,  30464,
+     30720,  30976,  31232,  31488,  31744,  32000,  32256,  32512,
+};
+
+// 伪随机噪声
+const int16_t g_wave_noise_q15[WAVE_TABLE_SIZE] = {
+     20781, -23974,  -2172,  17573, -10136,  -4343,  -6619, -30373,
+      1430, -20288,  -4846,  -8685, -32579, -13222,  27671,   4775,
+      1495,   2877, -25520,  24961,  -9615,  -9675,  12226, -17370,
+    -13479,    379,  14579, -26459,  22603, -10193,  14460,   9551,
+    -21690,   2991, -21622,   5739, -10732,  14497,    742, -15597,
+     12387, -19230,   5519, -19350, -21705,  24452,  16088,  30813,
+    -18041, -26958,  31340,    759, -20898,  29174, -20422,  12618,
+     21431, -20346, -24136, -20401, -10595,  28904,   3862,  19103,
+    -31270,  22172, -31114,   5966,  29125,  22293, -27281,  11463,
+     23662, -21464, -25113,  29010, -10007,   1485,  22272, -31177,
+     18962,  24774,  27518,  27093,  30437,  11023,  30817,  26837,
+     15255,  22142, -31454, -16615,   3413,  32160,   1021,  -3909,
+     16485,  29470,  32221,  11621,  31885,  -2855,  17532,   1535,
+    -14459,  23741, -29526,  -7187,  30003,  24677,  27964,  25221,
+     21390, -22673, -28476,  24860, -32736,  17264, -31292,  24735,
+    -13036, -21190, -24725,  -7744,    778,   7724,   7622, -27329,
+     17919,   2980,  17660, -21191, -13224,   3325,   5046,  11916,
+    -24406,  -7270,  17906, -20949,  27771,  10959,   1835,  22927,
+     -1868, -18212,  15382,  22592, -18971,  15311,    212,  -7500,
+     30634, -20014, -11221,   2955,  15039, -20991,   3018,   3199,
+    -13101, -27596, -18776, -15987,  20567, -10515,  30125, -11333,
+    -25437,  -4646, -23798,  22047, -11975,  -3886,  -8096, -11861,
+      1751,  30510, -24494, -21267,  29639,   2628,   9466,  32307,
+    -30343,   6843,  -4194,  -1200, -11222,   2043,  12864,  -7833,
+      5006, -32565,   -758,  -6596,  22235,  -1110, -12382,  23259,
+     -2358,  -1766, -26408,  -5710, -17598, -30487, -16128,   3070,
+     28467, -28902, -30076, -18069,  10294,   6469,  -9575, -14374,
+     -6902,  -5514, -17096, -16181, -24599,  -9608,   -863, -15078,
+     14890, -22756, -20965,  20174,  -7587,   8585, -22820, -15832,
+    -16407,     64,  -7629, -30991, -31679,   2969,  12268, -16065,
+    -17804, -26055,  -6185,  23141,  16041,  16071,  15721, -15487,
+     16987,   1540,  -6951,  15449, -24207,  15260,  10972,  10863,
+};
@@ -0,0 +1,23 @@
+#ifndef USER_WAVE_TABLES_H
+#define USER_WAVE_TABLES_H
+
+// 由tools/gen_wave_tables.py生成，请勿手工修改
+
+#include "user_DAC.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const int16_t g_wave_quarter_sine_q15[WAVE_QUARTER_SIZE + 1];   // 正弦（四分之一周期）
+extern const int16_t g_wave_square_q15[WAVE_TABLE_SIZE];   // 方波
+extern const int16_t g_wave_triangle_q15[WAVE_TABLE_SIZE];   // 三角波
+extern const int16_t g_wave_sawtooth_q15[WAVE_TABLE_SIZE];   // 锯齿波
+extern const int16_t g_wave_noise_q15[WAVE_TABLE_SIZE];   // 伪随机噪声
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_WAVE_TABLES_H */
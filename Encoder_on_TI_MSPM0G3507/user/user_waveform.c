@@ -0,0 +1,119 @@
+#include "user_waveform.h"
+#include "user_command.h"
+#include "user_flash.h"
+#include "user_uart.h"
+#include <stddef.h>
+#include <string.h>
+
+// 用户波形槽位（RAM，启动时从Flash加载）
+static wave_record_t g_slots[DAC_USER_WAVE_SLOTS];
+
+// 上传接收缓冲区：最多256点 + CRC
+static uint8_t g_upload_buffer[WAVE_UPLOAD_MAX_POINTS * 2 + 2];
+static uint8_t g_upload_slot = 0;
+static uint16_t g_upload_points = 0;
+
+// 波形名称（与dac_waveform_t顺序一致）
+static const char *const g_wave_names[DAC_WAVE_COUNT] = {
+    "sine", "square", "triangle", "saw", "noise", "user0", "user1"
+};
+
+/**
+ * @brief 启动时从Flash加载用户波形，有效的槽位登记到DAC
+ */
+void user_waveform_init(void)
+{
+    for (uint8_t slot = 0; slot < DAC_USER_WAVE_SLOTS; slot++) {
+        const wave_record_t *stored =
+            (const wave_record_t *)(WAVE_FLASH_ADDRESS + slot * FLASH_SECTOR_SIZE);
+
+        if (stored->magic == WAVE_MAGIC &&
+            stored->crc == user_flash_crc16(stored->samples, sizeof(stored->samples))) {
+            memcpy(&g_slots[slot], stored, sizeof(wave_record_t));
+            DAC_setUserWaveform(slot, g_slots[slot].samples);
+        }
+    }
+}
+
+/**
+ * @brief 上传数据接收完成：校验CRC，插值到WAVE_TABLE_SIZE点后登记到DAC
+ */
+static void waveform_upload_done(bool ok, uint8_t *buffer, uint16_t length)
+{
+    uint16_t data_length = g_upload_points * 2;
+    wave_record_t *record = &g_slots[g_upload_slot];
+
+    if (!ok) {
+        user_uart_send_string("ERR: upload timeout\r\n");
+        return;
+    }
+    uint16_t crc = (uint16_t)(buffer[data_length] | (buffer[data_length + 1] << 8));
+    if (length != data_length + 2 || crc != user_flash_crc16(buffer, data_length)) {
+        user_uart_send_string("ERR: upload crc\r\n");
+        return;
+    }
+
+    // 播放的是DAC模块渲染出的码值表，改写槽位数据不影响输出；写完后重新登记时才重新渲染
+    // 周期性线性插值：输出点i对应输入位置 i * points / 256（Q8）
+    for (uint16_t i = 0; i < WAVE_TABLE_SIZE; i++) {
+        uint32_t position = ((uint32_t)i * g_upload_points << 8) / WAVE_TABLE_SIZE;
+        uint16_t index = (uint16_t)(position >> 8);
+        uint16_t next = (uint16_t)((index + 1 < g_upload_points) ? index + 1 : 0);
+        int32_t frac = (int32_t)(position & 0xFF);
+        int32_t a = (int16_t)(buffer[index * 2] | (buffer[index * 2 + 1] << 8));
+        int32_t b = (int16_t)(buffer[next * 2] | (buffer[next * 2 + 1] << 8));
+        record->samples[i] = (int16_t)(a + (((b - a) * frac) >> 8));
+    }
+    record->magic = WAVE_MAGIC;
+    record->points = g_upload_points;
+    record->crc = user_flash_crc16(record->samples, sizeof(record->samples));
+
+    DAC_setUserWaveform(g_upload_slot, record->samples);
+    user_uart_send_string("OK\r\n");
+}
+
+/**
+ * @brief 开始接收一个用户波形（由"wave upload"命令调用）
+ * @param slot 槽位号
+ * @param points 一个周期的点数（2~256）
+ * @return true: 已进入二进制接收
+ */
+bool user_waveform_begin_upload(uint8_t slot, uint16_t points)
+{
+    if (slot >= DAC_USER_WAVE_SLOTS || points < WAVE_UPLOAD_MIN_POINTS ||
+        points > WAVE_UPLOAD_MAX_POINTS) {
+        return false;
+    }
+
+    g_upload_slot = slot;
+    g_upload_points = points;
+    return user_command_receive_binary(g_upload_buffer, points * 2 + 2, waveform_upload_done);
+}
+
+/**
+ * @brief 把槽位中的用户波形写入Flash，重启后自动加载
+ * @return true: 写入成功, false: 槽位为空或写入失败
+ */
+bool user_waveform_save(uint8_t slot)
+{
+    if (slot >= DAC_USER_WAVE_SLOTS || g_slots[slot].magic != WAVE_MAGIC) {
+        return false;
+    }
+    return user_flash_write_sector(WAVE_FLASH_ADDRESS + slot * FLASH_SECTOR_SIZE,
+                                   &g_slots[slot], sizeof(wave_record_t));
+}
+
+/**
+ * @brief 波形名称换算为波形类型（串口命令使用）
+ * @return true: 名称有效
+ */
+bool user_waveform_parse_name(const char *name, dac_waveform_t *wave)
+{
+    for (uint8_t i = 0; i < DAC_WAVE_COUNT; i++) {
+        if (strcmp(name, g_wave_names[i]) == 0) {
+            *wave = (dac_waveform_t)i;
+            return true;
+        }
+    }
+    return false;
+}
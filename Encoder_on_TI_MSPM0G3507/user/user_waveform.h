@@ -0,0 +1,40 @@
+#ifndef USER_WAVEFORM_H
+#define USER_WAVEFORM_H
+
+#include "user_DAC.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 用户波形Flash存储：每个槽位一个1KB扇区，位于校准数据扇区之前
+#define WAVE_FLASH_ADDRESS          0x0001F400U
+#define WAVE_MAGIC                  0x57415631U   // "WAV1"
+
+// 上传格式：命令"wave upload <slot> <count>\n"之后紧跟二进制数据
+// count个int16小端Q15采样点（一个周期，2~256点，不足256点时线性插值到256点），
+// 最后为采样数据的CRC16-CCITT（小端）
+#define WAVE_UPLOAD_MIN_POINTS      2
+#define WAVE_UPLOAD_MAX_POINTS      WAVE_TABLE_SIZE
+
+// 用户波形Flash记录（520字节，8字节对齐）
+typedef struct {
+    uint32_t magic;
+    uint16_t points;            // 上传时的原始点数（仅供查询）
+    uint16_t crc;               // samples的CRC16
+    int16_t samples[WAVE_TABLE_SIZE];
+} wave_record_t;
+
+// 函数声明
+void user_waveform_init(void);
+bool user_waveform_begin_upload(uint8_t slot, uint16_t points);
+bool user_waveform_save(uint8_t slot);
+bool user_waveform_parse_name(const char *name, dac_waveform_t *wave);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_WAVEFORM_H */
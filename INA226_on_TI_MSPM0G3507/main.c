@@ -4,6 +4,7 @@
 #include "user/user_uart.h"
 #include "user/user_INA226.h"
 #include "user/firewater_protocol.h"
+#include "user/user_stats.h"
 #include <stdio.h>
 
 // 全局时间计数器（毫秒）
@@ -13,6 +14,10 @@ volatile uint32_t system_time_ms = 0;
 static INA226_Device ina226_device;
 static bool ina226_initialized = false;
 
+// 总线电压窗口统计（每50ms一个读数，20个读数约1秒输出一帧）
+#define INA226_STATS_WINDOW     20
+static stats_accumulator_t bus_voltage_stats;
+
 // 数据采集状态
 static uint32_t last_voltage_read_time = 0;
 static uint32_t last_current_read_time = 0;
@@ -27,6 +32,7 @@ void ina226_system_init(void) {
         // Arduino库默认：calVal=2048, currentDivider_mA=40.0, pwrMultiplier_mW=0.625
         
         ina226_initialized = true;
+        user_stats_init(&bus_voltage_stats, "bus_mV", INA226_STATS_WINDOW);
         //user_uart_send_string("INA226 初始化成功! (连续模式, 无平均, 10Hz采样)\r\n");
         
         // 发送初始化完成状态（使用文本格式）
@@ -56,6 +62,12 @@ void ina226_data_process(void) {
             char debug_str[64];
             sprintf(debug_str, "V:%.3f\n", voltage);
             user_uart_send_string(debug_str);
+            
+            // 累加到窗口统计（单位mV），窗口结束时输出一条统计帧
+            stats_record_t record;
+            if (user_stats_add_sample(&bus_voltage_stats, (int32_t)(voltage * 1000.0f), &record)) {
+                user_stats_send_record(bus_voltage_stats.name, &record);
+            }
         } else {
             // 发送错误信息
             char error_str[64];
@@ -77,3 +77,16 @@ void firewater_send_ina226_with_timestamp(float voltage, float current, float po
     float values[4] = {voltage, current, power, (float)timestamp};
     firewater_send_multi_channel(values, 4, "ina226");
 }
+
+/**
+ * @brief 发送窗口统计帧
+ * 格式: "stats:name,mean,rms,min,max,pp\n"，每个窗口一行
+ */
+void firewater_send_stats(const char *name, int32_t mean, int32_t rms,
+                          int32_t min, int32_t max, int32_t peak_to_peak) {
+    char buffer[80];
+    snprintf(buffer, sizeof(buffer), "stats:%s,%ld,%ld,%ld,%ld,%ld\n",
+             (name != NULL) ? name : "", (long)mean, (long)rms,
+             (long)min, (long)max, (long)peak_to_peak);
+    user_uart_send_string(buffer);
+}
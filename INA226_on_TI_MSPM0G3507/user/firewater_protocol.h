@@ -50,4 +50,16 @@ void firewater_send_ina226_data(float voltage, float current, float power);
  */
 void firewater_send_ina226_with_timestamp(float voltage, float current, float power, uint32_t timestamp);
 
+/**
+ * @brief 发送窗口统计帧
+ * @param name 通道名称
+ * @param mean 平均值
+ * @param rms 均方根
+ * @param min 最小值
+ * @param max 最大值
+ * @param peak_to_peak 峰峰值
+ */
+void firewater_send_stats(const char *name, int32_t mean, int32_t rms,
+                          int32_t min, int32_t max, int32_t peak_to_peak);
+
 #endif /* FIREWATER_PROTOCOL_H_ */
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "user_stats.h"
+#include "firewater_protocol.h"
+#include <stddef.h>
+
+/**
+ * @brief 64位整数平方根（逐位法，只用移位和加减）
+ * @note 仅在窗口结束时调用一次，不在每样本路径上
+ */
+static uint32_t stats_isqrt64(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+/**
+ * @brief 初始化累加器
+ * @param acc 累加器
+ * @param name 通道名称
+ * @param window 窗口长度（样本数），0时使用默认值
+ */
+void user_stats_init(stats_accumulator_t *acc, const char *name, uint32_t window)
+{
+    if (acc == NULL) {
+        return;
+    }
+
+    acc->name = name;
+    acc->window = (window == 0) ? STATS_DEFAULT_WINDOW : window;
+    user_stats_reset(acc);
+}
+
+/**
+ * @brief 清空当前窗口
+ */
+void user_stats_reset(stats_accumulator_t *acc)
+{
+    if (acc == NULL) {
+        return;
+    }
+
+    acc->count = 0;
+    acc->sum = 0;
+    acc->sum_sq = 0;
+    acc->min = INT32_MAX;
+    acc->max = INT32_MIN;
+}
+
+/**
+ * @brief 累加一个样本
+ * @param acc 累加器
+ * @param sample 样本值
+ * @param record 窗口结束时输出统计结果
+ * @return true: 本样本结束了一个窗口，record有效
+ */
+bool user_stats_add_sample(stats_accumulator_t *acc, int32_t sample, stats_record_t *record)
+{
+    uint32_t magnitude = (sample < 0) ? (uint32_t)(-(int64_t)sample) : (uint32_t)sample;
+
+    acc->sum += sample;
+    // 小幅值样本走32位乘法，避免M0+上的64位乘法库调用
+    if (magnitude <= 0xFFFFU) {
+        acc->sum_sq += magnitude * magnitude;
+    } else {
+        acc->sum_sq += (uint64_t)magnitude * magnitude;
+    }
+    if (sample < acc->min) acc->min = sample;
+    if (sample > acc->max) acc->max = sample;
+
+    if (++acc->count < acc->window) {
+        return false;
+    }
+    return user_stats_finish_window(acc, record);
+}
+
+/**
+ * @brief 提前结束当前窗口（如停止采样时输出不足一个窗口的数据）
+ * @return true: 窗口内有样本，record有效
+ */
+bool user_stats_finish_window(stats_accumulator_t *acc, stats_record_t *record)
+{
+    if (acc == NULL || record == NULL || acc->count == 0) {
+        return false;
+    }
+
+    record->count = acc->count;
+    record->mean = (int32_t)(acc->sum / (int64_t)acc->count);
+    record->rms = (int32_t)stats_isqrt64(acc->sum_sq / acc->count);
+    record->min = acc->min;
+    record->max = acc->max;
+    record->peak_to_peak = acc->max - acc->min;
+
+    user_stats_reset(acc);
+    return true;
+}
+
+/**
+ * @brief 以紧凑文本帧发送统计结果
+ */
+void user_stats_send_record(const char *name, const stats_record_t *record)
+{
+    if (record == NULL) {
+        return;
+    }
+    firewater_send_stats(name, record->mean, record->rms, record->min,
+                         record->max, record->peak_to_peak);
+}